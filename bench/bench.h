@@ -0,0 +1,32 @@
+#ifndef CHESS_BENCH_H
+#define CHESS_BENCH_H
+
+#include <string>
+#include <vector>
+
+#include "position.h"
+
+namespace Chess::Bench {
+
+// Each suite registers its Google Benchmark cases under "<suite>/", so
+// --benchmark_filter=<suite> runs a single one
+auto registerBitboardBenchmarks() -> void;
+auto registerSliderBenchmarks() -> void;
+auto registerMoveGenBenchmarks() -> void;
+auto registerPawnBenchmarks() -> void;
+auto registerFenBenchmarks() -> void;
+auto registerSmpBenchmarks() -> void;
+// Random weights unless a network file is given; false if it cannot be loaded
+auto registerNnueBenchmarks(const std::string& network_path) -> bool;
+
+inline auto loadPositions(const std::vector<std::string>& fens) -> std::vector<Position>
+{
+    std::vector<Position> positions;
+    positions.reserve(fens.size());
+    for (const auto& fen : fens) { positions.emplace_back(fen); }
+    return positions;
+}
+
+} // namespace Chess::Bench
+
+#endif // CHESS_BENCH_H
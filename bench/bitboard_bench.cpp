@@ -0,0 +1,68 @@
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench.h"
+#include "bitboard.h"
+
+namespace Chess::Bench {
+
+namespace {
+
+constexpr std::size_t SAMPLE_COUNT = 4096;
+
+// Non-empty boards of every density from one bit to full, as scans in move generation see
+auto makeSamples() -> std::vector<Bitboard>
+{
+    constexpr std::uint64_t SEED = 0x9E3779B97F4A7C15ULL;
+
+    // NOLINTNEXTLINE(cert-msc51-cpp,cert-msc32-c) - Reproducible benchmark input
+    std::mt19937_64 rng(SEED);
+    std::vector<Bitboard> samples(SAMPLE_COUNT);
+    for (std::size_t i = 0; i < SAMPLE_COUNT; ++i) {
+        Bitboard bitb = rng();
+        for (std::size_t sparser = i % 4; sparser > 0; --sparser) { bitb &= rng(); }
+        samples[i] = bitb != 0 ? bitb : 1;
+    }
+    return samples;
+}
+
+template <typename Scan>
+auto registerScan(const char* name, const std::vector<Bitboard>& samples, Scan scan) -> void
+{
+    benchmark::RegisterBenchmark(name, [samples, scan](benchmark::State& state) {
+        std::size_t i = 0;
+        for (auto _ : state) { benchmark::DoNotOptimize(scan(samples[i++ % SAMPLE_COUNT])); }
+        state.SetItemsProcessed(state.iterations());
+    });
+}
+
+} // namespace
+
+auto registerBitboardBenchmarks() -> void
+{
+    const std::vector<Bitboard> SAMPLES = makeSamples();
+
+    registerScan("bitboards/lsb", SAMPLES, [](Bitboard bitb) { return Bitboards::lsb(bitb); });
+    registerScan("bitboards/msb", SAMPLES, [](Bitboard bitb) { return Bitboards::msb(bitb); });
+    registerScan("bitboards/popCount", SAMPLES,
+                 [](Bitboard bitb) { return Bitboards::popCount(bitb); });
+
+    // Empties each board, so items are the bits popped rather than the boards
+    benchmark::RegisterBenchmark("bitboards/popLsb", [SAMPLES](benchmark::State& state) {
+        std::size_t i = 0;
+        std::int64_t bits = 0;
+        for (auto _ : state) {
+            Bitboard bitb = SAMPLES[i++ % SAMPLE_COUNT];
+            while (bitb != 0) {
+                benchmark::DoNotOptimize(Bitboards::popLsb(bitb));
+                ++bits;
+            }
+        }
+        state.SetItemsProcessed(bits);
+    });
+}
+
+} // namespace Chess::Bench
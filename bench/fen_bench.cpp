@@ -0,0 +1,175 @@
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench.h"
+#include "constants.h"
+#include "movegen.h"
+#include "packed.h"
+#include "position.h"
+
+namespace Chess::Bench {
+
+namespace {
+
+const std::vector<std::string> FENS = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+    "8/8/4k3/8/2p5/8/B2P4/4K3 b - - 12 57",
+};
+
+// Every position one legal move from the samples, so the bulk pass sees varied FENs
+auto childFens() -> std::vector<std::string>
+{
+    std::vector<std::string> fens;
+    for (const auto& fen : FENS) {
+        Position pos(fen);
+        for (const Move MOVE : MoveGen::generateLegal(pos)) {
+            pos.makeMove(MOVE);
+            fens.push_back(pos.toFen());
+            pos.unmakeMove();
+        }
+    }
+    return fens;
+}
+
+auto registerParsing() -> void
+{
+    // Not a comparison of parsers: the constructor loads through `fromFen` as well, and its
+    // stream parser only runs for FENs `fromFen` rejects. The gap to fen/fromFen is the cost of
+    // building a fresh Position each time.
+    benchmark::RegisterBenchmark("fen/construct", [](benchmark::State& state) {
+        std::size_t i = 0;
+        for (auto _ : state) { benchmark::DoNotOptimize(Position(FENS[i++ % FENS.size()]).hash()); }
+        state.SetItemsProcessed(state.iterations());
+    });
+
+    benchmark::RegisterBenchmark("fen/fromFen", [](benchmark::State& state) {
+        Position pos;
+        std::size_t i = 0;
+        for (auto _ : state) {
+            const std::string_view FEN = FENS[i++ % FENS.size()];
+            benchmark::DoNotOptimize(pos.fromFen(FEN) == FenError::NONE ? pos.hash() : 0);
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+
+    // The full recompute that `makeMove` keeps the hash equal to incrementally
+    benchmark::RegisterBenchmark("fen/computeHash", [](benchmark::State& state) {
+        const std::vector<Position> POSITIONS = loadPositions(FENS);
+        std::size_t i = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(POSITIONS[i++ % POSITIONS.size()].computeHash());
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+}
+
+auto registerWriting() -> void
+{
+    benchmark::RegisterBenchmark("fen/toFen/string", [](benchmark::State& state) {
+        const std::vector<Position> POSITIONS = loadPositions(FENS);
+        std::size_t i = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(POSITIONS[i++ % POSITIONS.size()].toFen().size());
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+
+    benchmark::RegisterBenchmark("fen/toFen/reused", [](benchmark::State& state) {
+        const std::vector<Position> POSITIONS = loadPositions(FENS);
+        std::string out;
+        std::size_t i = 0;
+        for (auto _ : state) {
+            POSITIONS[i++ % POSITIONS.size()].toFen(out);
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+
+    benchmark::RegisterBenchmark("fen/toFen/buffer", [](benchmark::State& state) {
+        const std::vector<Position> POSITIONS = loadPositions(FENS);
+        std::array<char, Constants::Game::MAX_FEN_LENGTH> buffer{};
+        std::size_t i = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(
+                POSITIONS[i++ % POSITIONS.size()].toFen(buffer.data(), buffer.size()));
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+
+    // Bulk round trip: parse and re-serialise each FEN in place, as a dataset converter would
+    benchmark::RegisterBenchmark("fen/roundTrip", [](benchmark::State& state) {
+        const std::vector<std::string> CHILD_FENS = childFens();
+        Position pos;
+        std::string out;
+        for (const auto& fen : CHILD_FENS) {
+            const bool PARSED = pos.fromFen(fen) == FenError::NONE;
+            if (PARSED) { pos.toFen(out); }
+            if (!PARSED || out != fen) {
+                state.SkipWithError("a FEN does not survive the round trip");
+                return;
+            }
+        }
+
+        std::size_t i = 0;
+        for (auto _ : state) {
+            const std::string_view FEN = CHILD_FENS[i++ % CHILD_FENS.size()];
+            if (pos.fromFen(FEN) == FenError::NONE) { pos.toFen(out); }
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+}
+
+// The 32-byte training record against the text it replaces
+auto registerPacking() -> void
+{
+    benchmark::RegisterBenchmark("fen/pack", [](benchmark::State& state) {
+        const std::vector<Position> POSITIONS = loadPositions(FENS);
+        PackedPosition record{};
+        std::size_t i = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(POSITIONS[i++ % POSITIONS.size()].pack(record));
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+
+    benchmark::RegisterBenchmark("fen/fromPacked", [](benchmark::State& state) {
+        std::vector<PackedPosition> records(FENS.size());
+        for (std::size_t index = 0; index < FENS.size(); ++index) {
+            if (!Position(FENS[index]).pack(records[index])) {
+                state.SkipWithError("a sample does not fit the packed record");
+                return;
+            }
+        }
+
+        Position pos;
+        std::size_t i = 0;
+        for (auto _ : state) {
+            const PackedPosition& record = records[i++ % records.size()];
+            benchmark::DoNotOptimize(pos.fromPacked(record) == FenError::NONE ? pos.hash() : 0);
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+}
+
+} // namespace
+
+auto registerFenBenchmarks() -> void
+{
+    registerParsing();
+    registerWriting();
+    registerPacking();
+}
+
+} // namespace Chess::Bench
@@ -0,0 +1,62 @@
+#include <iostream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "bench.h"
+#include "bitboard.h"
+#include "zobrist.h"
+
+using namespace Chess;
+
+namespace {
+
+auto printUsage() -> void
+{
+    std::cerr << "usage: duchess-bench [--network FILE] [--smp] [--benchmark_...]\n"
+              << "  --network FILE  evaluate a trained network instead of random weights\n"
+              << "  --smp           add the Lazy SMP scaling runs, slow and machine-sized\n"
+              << "  Google Benchmark flags apply as usual, e.g. --benchmark_filter=movegen, or\n"
+              << "  --benchmark_out=run.json --benchmark_out_format=json for results to diff.\n";
+}
+
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+    Bitboards::init();
+    Zobrist::init();
+
+    // Takes the --benchmark_* flags out of argv, leaving ours
+    benchmark::Initialize(&argc, argv);
+
+    std::string network_path;
+    bool smp = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string ARG = argv[i];
+        if (ARG == "--network" && i + 1 < argc) { network_path = argv[++i]; }
+        else if (ARG == "--smp") { smp = true; }
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    Bench::registerBitboardBenchmarks();
+    Bench::registerSliderBenchmarks();
+    Bench::registerMoveGenBenchmarks();
+    Bench::registerPawnBenchmarks();
+    Bench::registerFenBenchmarks();
+    if (!Bench::registerNnueBenchmarks(network_path)) {
+        std::cerr << "Cannot load network " << network_path << "\n";
+        return 1;
+    }
+    if (smp) { Bench::registerSmpBenchmarks(); }
+
+    // Recorded in the JSON context, so runs from different machines can be told apart
+    benchmark::AddCustomContext("bitboard_kernels", Bitboards::kernels());
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
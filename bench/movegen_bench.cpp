@@ -0,0 +1,81 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench.h"
+#include "move.h"
+#include "movegen.h"
+#include "position.h"
+
+namespace Chess::Bench {
+
+namespace {
+
+const std::vector<std::string> FENS = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+
+template <MoveGen::GenType TYPE> auto countPseudoLegal(const Position& pos) -> std::size_t
+{
+    MoveList list;
+    MoveGen::generate<TYPE>(pos, list);
+    return list.size();
+}
+
+auto countLegal(const Position& pos) -> std::size_t { return MoveGen::generateLegal(pos).size(); }
+
+// Items are the moves generated, so items_per_second reads as moves per second
+template <typename Generator> auto registerGenerator(const char* name, Generator generator) -> void
+{
+    benchmark::RegisterBenchmark(name, [generator](benchmark::State& state) {
+        const std::vector<Position> POSITIONS = loadPositions(FENS);
+        std::size_t i = 0;
+        std::int64_t moves = 0;
+        for (auto _ : state) {
+            std::size_t count = generator(POSITIONS[i++ % POSITIONS.size()]);
+            benchmark::DoNotOptimize(count);
+            moves += static_cast<std::int64_t>(count);
+        }
+        state.SetItemsProcessed(moves);
+    });
+}
+
+} // namespace
+
+auto registerMoveGenBenchmarks() -> void
+{
+    registerGenerator("movegen/pseudoLegal/all", countPseudoLegal<MoveGen::GenType::NON_EVASIONS>);
+    registerGenerator("movegen/pseudoLegal/captures", countPseudoLegal<MoveGen::GenType::CAPTURES>);
+    registerGenerator("movegen/pseudoLegal/quiets", countPseudoLegal<MoveGen::GenType::QUIETS>);
+    registerGenerator("movegen/legal", countLegal);
+
+    // Every legal move of every position, made and unmade in turn as a search would
+    benchmark::RegisterBenchmark("movegen/makeUnmake", [](benchmark::State& state) {
+        std::vector<Position> positions = loadPositions(FENS);
+        std::vector<std::pair<std::size_t, Move>> moves;
+        for (std::size_t index = 0; index < positions.size(); ++index) {
+            for (const Move MOVE : MoveGen::generateLegal(positions[index])) {
+                moves.emplace_back(index, MOVE);
+            }
+        }
+
+        std::size_t i = 0;
+        for (auto _ : state) {
+            const auto& [index, move] = moves[i++ % moves.size()];
+            Position& pos = positions[index];
+            pos.makeMove(move);
+            benchmark::DoNotOptimize(pos.hash());
+            pos.unmakeMove();
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+}
+
+} // namespace Chess::Bench
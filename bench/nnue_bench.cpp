@@ -0,0 +1,105 @@
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench.h"
+#include "eval.h"
+#include "move.h"
+#include "movegen.h"
+#include "nnue.h"
+#include "position.h"
+
+namespace Chess::Bench {
+
+namespace {
+
+constexpr uint64_t RANDOM_SEED = 1;
+
+const std::vector<std::string> FENS = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+
+auto kernelName() -> std::string
+{
+#if defined(USE_AVX2)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace
+
+auto registerNnueBenchmarks(const std::string& network_path) -> bool
+{
+    // Shared by the registered cases, which run after this returns
+    auto net = std::make_shared<NNUE::Network>();
+    std::string source = "random weights";
+    if (network_path.empty()) { NNUE::randomize(*net, RANDOM_SEED); }
+    else if (NNUE::load(network_path, *net)) { source = network_path; }
+    else {
+        return false;
+    }
+    const std::string LABEL = kernelName() + " kernels, " + source;
+
+    benchmark::RegisterBenchmark("nnue/psqt", [](benchmark::State& state) {
+        const std::vector<Position> POSITIONS = loadPositions(FENS);
+        std::size_t i = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(Eval::evaluate(POSITIONS[i++ % POSITIONS.size()]));
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+
+    benchmark::RegisterBenchmark("nnue/refresh", [net, LABEL](benchmark::State& state) {
+        const std::vector<Position> POSITIONS = loadPositions(FENS);
+        std::size_t i = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(NNUE::evaluate(*net, POSITIONS[i++ % POSITIONS.size()]));
+        }
+        state.SetItemsProcessed(state.iterations());
+        state.SetLabel(LABEL);
+    });
+
+    // Every legal move of every position, as a search would make them one ply below a node.
+    // Parents are evaluated once up front, so each call pays only for one move's update.
+    benchmark::RegisterBenchmark("nnue/incremental", [net, LABEL](benchmark::State& state) {
+        std::vector<Position> positions = loadPositions(FENS);
+        std::vector<std::pair<std::size_t, Move>> children;
+        std::vector<NNUE::AccumulatorStack> stacks(positions.size());
+        for (std::size_t index = 0; index < positions.size(); ++index) {
+            for (const Move MOVE : MoveGen::generateLegal(positions[index])) {
+                children.emplace_back(index, MOVE);
+            }
+            stacks[index].reset();
+            static_cast<void>(NNUE::evaluate(*net, positions[index], stacks[index]));
+        }
+
+        std::size_t i = 0;
+        for (auto _ : state) {
+            const auto& [index, move] = children[i++ % children.size()];
+            Position& pos = positions[index];
+            NNUE::AccumulatorStack& stack = stacks[index];
+            stack.push(pos, move);
+            pos.makeMove(move);
+            benchmark::DoNotOptimize(NNUE::evaluate(*net, pos, stack));
+            pos.unmakeMove();
+            stack.pop();
+        }
+        state.SetItemsProcessed(state.iterations());
+        state.SetLabel(LABEL);
+    });
+    return true;
+}
+
+} // namespace Chess::Bench
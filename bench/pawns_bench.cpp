@@ -0,0 +1,90 @@
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench.h"
+#include "eval.h"
+#include "material.h"
+#include "move.h"
+#include "movegen.h"
+#include "pawns.h"
+#include "position.h"
+
+namespace Chess::Bench {
+
+namespace {
+
+constexpr int TREE_DEPTH = 3;
+
+const std::vector<std::string> FENS = {
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP2BPPP/R2QKB1R w KQ - 0 8",
+    "2r2rk1/pp1bqppp/2n1pn2/3p4/3P4/2PBPN2/P1Q2PPP/R1B2RK1 w - - 4 13",
+};
+
+// Evaluates every node of a full-width tree, the way a search evaluates leaves and stand-pats
+auto walk(Position& pos, Pawns::Table& table, Material::Table& material, int depth) -> int
+{
+    int sink = Eval::evaluate(pos, table, material);
+    if (depth == 0) { return sink; }
+
+    for (const Move MOVE : MoveGen::generateLegal(pos)) {
+        pos.makeMove(MOVE);
+        sink ^= walk(pos, table, material, depth - 1);
+        pos.unmakeMove();
+    }
+    return sink;
+}
+
+auto hitRate(uint64_t hits, uint64_t probes) -> double
+{
+    return probes == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(probes);
+}
+
+} // namespace
+
+auto registerPawnBenchmarks() -> void
+{
+    benchmark::RegisterBenchmark("pawns/evalUncached", [](benchmark::State& state) {
+        const std::vector<Position> POSITIONS = loadPositions(FENS);
+        std::size_t i = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(Eval::evaluate(POSITIONS[i++ % POSITIONS.size()]));
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+
+    benchmark::RegisterBenchmark("pawns/evalCached", [](benchmark::State& state) {
+        const std::vector<Position> POSITIONS = loadPositions(FENS);
+        Pawns::Table table;
+        Material::Table material;
+        std::size_t i = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(
+                Eval::evaluate(POSITIONS[i++ % POSITIONS.size()], table, material));
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+
+    // Starts from empty tables each time, so the hit rates are those of one tree
+    benchmark::RegisterBenchmark("pawns/evalTree", [](benchmark::State& state) {
+        std::vector<Position> positions = loadPositions(FENS);
+        Pawns::Table table;
+        Material::Table material;
+        for (auto _ : state) {
+            state.PauseTiming();
+            table.clear();
+            material.clear();
+            state.ResumeTiming();
+            for (Position& pos : positions) {
+                benchmark::DoNotOptimize(walk(pos, table, material, TREE_DEPTH));
+            }
+        }
+        state.counters["pawn_hits"] = hitRate(table.hits(), table.probes());
+        state.counters["material_hits"] = hitRate(material.hits(), material.probes());
+    });
+}
+
+} // namespace Chess::Bench
@@ -0,0 +1,81 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench.h"
+#include "bitboard.h"
+#include "constants.h"
+#include "types.h"
+
+namespace Chess::Bench {
+
+using namespace Util;
+
+namespace {
+
+constexpr std::size_t SAMPLE_COUNT = 4096;
+
+struct Sample {
+    Square square;
+    Bitboard occupied;
+};
+
+auto makeSamples() -> std::vector<Sample>
+{
+    constexpr std::uint64_t SEED = 0xB5AD4ECEDA1CE2A9ULL;
+
+    // NOLINTNEXTLINE(cert-msc51-cpp,cert-msc32-c) - Reproducible benchmark input
+    std::mt19937_64 rng(SEED);
+    std::vector<Sample> samples(SAMPLE_COUNT);
+    for (auto& sample : samples) {
+        sample.square = fromIdx<Square>(rng() % Constants::Board::SQUARE_COUNT);
+        // AND of two draws gives ~25% density, close to a middlegame board
+        sample.occupied = rng() & rng();
+    }
+    return samples;
+}
+
+template <typename Attacks>
+auto registerAttacks(const std::string& name, const std::vector<Sample>& samples, Attacks attacks)
+    -> void
+{
+    benchmark::RegisterBenchmark(name.c_str(), [samples, attacks](benchmark::State& state) {
+        std::size_t i = 0;
+        for (auto _ : state) {
+            const Sample& sample = samples[i++ % SAMPLE_COUNT];
+            benchmark::DoNotOptimize(attacks(sample.square, sample.occupied));
+        }
+        state.SetItemsProcessed(state.iterations());
+    });
+}
+
+template <Bitboards::SliderBackend BACKEND>
+auto registerBackend(const std::string& label, const std::vector<Sample>& samples) -> void
+{
+    registerAttacks("sliders/" + label + "/bishop", samples, [](Square square, Bitboard occupied) {
+        return Bitboards::bishopAttacks<BACKEND>(square, occupied);
+    });
+    registerAttacks("sliders/" + label + "/rook", samples, [](Square square, Bitboard occupied) {
+        return Bitboards::rookAttacks<BACKEND>(square, occupied);
+    });
+    registerAttacks("sliders/" + label + "/queen", samples, [](Square square, Bitboard occupied) {
+        return Bitboards::queenAttacks<BACKEND>(square, occupied);
+    });
+}
+
+} // namespace
+
+// PEXT runs only in builds configured with -DDUCHESS_USE_PEXT=ON
+auto registerSliderBenchmarks() -> void
+{
+    const std::vector<Sample> SAMPLES = makeSamples();
+
+    registerBackend<Bitboards::SliderBackend::MAGIC>("magic", SAMPLES);
+#if defined(USE_PEXT)
+    registerBackend<Bitboards::SliderBackend::PEXT>("pext", SAMPLES);
+#endif
+}
+
+} // namespace Chess::Bench
@@ -0,0 +1,60 @@
+#include <array>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench.h"
+#include "position.h"
+#include "search.h"
+#include "tt.h"
+
+namespace Chess::Bench {
+
+namespace {
+
+constexpr int DEPTH = 10;
+constexpr std::size_t HASH_MB = 64;
+constexpr std::array<std::size_t, 6> THREAD_COUNTS = {1, 2, 4, 8, 16, 32};
+
+const std::vector<std::string> FENS = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+};
+
+} // namespace
+
+// Time to depth over every position from an empty table, so runs are comparable. Wall-clock
+// time is the time to depth; speedups are ratios between the thread counts' results.
+auto registerSmpBenchmarks() -> void
+{
+    for (const std::size_t THREADS : THREAD_COUNTS) {
+        const std::string NAME = "smp/threads:" + std::to_string(THREADS);
+        benchmark::RegisterBenchmark(NAME.c_str(), [THREADS](benchmark::State& state) {
+            TranspositionTable table(HASH_MB);
+            Search::ThreadPool pool(table, THREADS);
+            Search::Limits limits;
+            limits.depth = DEPTH;
+
+            uint64_t nodes = 0;
+            for (auto _ : state) {
+                for (const auto& fen : FENS) {
+                    state.PauseTiming();
+                    table.clear();
+                    const Position ROOT(fen);
+                    state.ResumeTiming();
+                    nodes += pool.search(ROOT, limits).nodes;
+                }
+            }
+            state.counters["nps"] =
+                benchmark::Counter(static_cast<double>(nodes), benchmark::Counter::kIsRate);
+        })
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime()
+            ->Iterations(1);
+    }
+}
+
+} // namespace Chess::Bench
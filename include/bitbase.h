@@ -0,0 +1,122 @@
+#ifndef CHESS_BITBASE_H
+#define CHESS_BITBASE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "constants.h"
+#include "mappedfile.h"
+#include "position.h"
+#include "types.h"
+
+namespace Chess::Bitbases {
+
+// Game-theoretic value for the side to move. The first three are the codes stored in tables.
+enum class Wdl : uint8_t { DRAW, WIN, LOSS, UNKNOWN };
+
+// The material of a table: the pieces besides the two kings, White's before Black's and each
+// side's in the order queen, rook, bishop, knight, pawn. Named like "KRKP", White first.
+struct Signature {
+    std::array<Piece, Constants::Bitbase::MAX_PIECES - 2> pieces{};
+    int count = 0;
+
+    auto operator==(const Signature& other) const -> bool;
+};
+
+// Accepts the pieces of each side in any order; false if the name is malformed or too large
+[[nodiscard]] auto parseSignature(std::string_view name, Signature& out) -> bool;
+[[nodiscard]] auto signatureName(const Signature& signature) -> std::string;
+// The same material with the colours the other way round
+[[nodiscard]] auto flipped(const Signature& signature) -> Signature;
+// The orientation tables are generated in: the side with more, or more valuable, pieces first
+[[nodiscard]] auto canonical(const Signature& signature) -> Signature;
+// Tables a capture or promotion can lead to, canonical and without the trivially drawn ones
+// (bare kings, a lone minor piece)
+[[nodiscard]] auto dependencies(const Signature& signature) -> std::vector<Signature>;
+// Positions a table holds, unreachable ones included: both sides to move, the white king on
+// the squares left by symmetry and every square for each other piece
+[[nodiscard]] auto tableSize(const Signature& signature) -> std::size_t;
+
+// One table of 2-bit values, either memory-mapped from a file or held in memory. Positions
+// are indexed by the side to move and the piece squares, reduced by the board's symmetries:
+// left-right with pawns, all eight without.
+class Table {
+public:
+    Table() = default;
+    ~Table();
+
+    Table(const Table&) = delete;
+    auto operator=(const Table&) -> Table& = delete;
+    Table(Table&&) = delete;
+    auto operator=(Table&&) -> Table& = delete;
+
+    // Maps `path`, replacing any contents. Fails if it cannot be mapped or the header or size
+    // does not match a table.
+    [[nodiscard]] auto open(const std::string& path) -> bool;
+    // Takes values packed four to a byte, lowest bits first
+    auto assign(const Signature& signature, std::vector<uint8_t> packed) -> void;
+    [[nodiscard]] auto save(const std::string& path) const -> bool;
+
+    [[nodiscard]] auto signature() const -> const Signature&;
+    [[nodiscard]] auto size() const -> std::size_t;
+    // UNKNOWN for an index that is not a legal position
+    [[nodiscard]] auto value(std::size_t index) const -> Wdl;
+
+private:
+    auto close() -> void;
+
+    MappedFile m_file;
+    std::vector<uint8_t> m_owned;
+    const uint8_t* m_values = nullptr;
+    Signature m_signature;
+    std::size_t m_size = 0;
+};
+
+inline auto Table::value(std::size_t index) const -> Wdl
+{
+    constexpr unsigned int BITS = 2;
+    constexpr unsigned int MASK = 3;
+    return static_cast<Wdl>((m_values[index / 4] >> ((index % 4) * BITS)) & MASK);
+}
+
+// The tables available for probing. Each serves its material with either colour to move and
+// with the colours swapped. Read-only once filled, so searchers share one.
+class Set {
+public:
+    // Opens every "<name>.bb" file in `directory`; returns how many were loaded
+    auto load(const std::string& directory) -> std::size_t;
+    // Replaces any table of the same material
+    auto add(std::unique_ptr<Table> table) -> void;
+    auto clear() -> void;
+
+    [[nodiscard]] auto find(const Signature& signature) const -> const Table*;
+    [[nodiscard]] auto size() const -> std::size_t;
+    // Most pieces of any table, kings included; 0 when empty
+    [[nodiscard]] auto maxPieces() const -> int;
+
+    // The value for the side to move, or UNKNOWN if no table covers the position. Castling
+    // rights and en passant squares are not part of any table, so positions with them are not
+    // covered.
+    [[nodiscard]] auto probe(const Position& pos) const -> Wdl;
+
+private:
+    std::vector<std::unique_ptr<Table>> m_tables;
+    int m_max_pieces = 0;
+};
+
+// Solves a table by retrograde iteration. Every pass marks positions won when a move reaches
+// a position lost for the opponent and lost when every move reaches one won for the opponent,
+// until a pass changes nothing; what is left is drawn. Moves that capture or promote are
+// looked up in `known`, which must hold every table of `dependencies(signature)`. Each pass is
+// split over `threads` by index range. False if a needed table is missing.
+[[nodiscard]] auto generate(const Signature& signature, const Set& known, std::size_t threads,
+                            Table& out) -> bool;
+
+} // namespace Chess::Bitbases
+
+#endif // CHESS_BITBASE_H
@@ -3,67 +3,423 @@
 
 #include <array>
 
+#if defined(USE_PEXT)
+#include <immintrin.h>
+#endif
+
+#include "compiler_macros.h"
 #include "constants.h"
 #include "types.h"
 
 namespace Chess {
 
+namespace Util {
+
+constexpr auto testBit(Bitboard bitb, Square square) -> bool
+{
+    return (bitb & (1ULL << static_cast<unsigned>(square))) != 0;
+};
+constexpr auto setBit(Bitboard& bitb, Square square) -> void
+{
+    bitb |= (1ULL << static_cast<unsigned>(square));
+}
+constexpr auto clearBit(Bitboard& bitb, Square square) -> void
+{
+    bitb &= ~(1ULL << static_cast<unsigned>(square));
+}
+constexpr auto squareBB(Square square) -> Bitboard
+{
+    return 1ULL << static_cast<unsigned>(square);
+}
+
+} // namespace Util
+
+// Compile-time generators for the static lookup tables below
+namespace Tables {
+
+constexpr auto makeFiles() -> std::array<Bitboard, Constants::Board::LENGTH>
+{
+    std::array<Bitboard, Constants::Board::LENGTH> files{};
+    for (int file = 0; file < Constants::Board::LENGTH; ++file) {
+        for (int rank = 0; rank < Constants::Board::LENGTH; ++rank) {
+            Util::setBit(files[file], Util::makeSquare(file, rank));
+        }
+    }
+    return files;
+}
+
+constexpr auto makeRanks() -> std::array<Bitboard, Constants::Board::LENGTH>
+{
+    std::array<Bitboard, Constants::Board::LENGTH> ranks{};
+    for (int rank = 0; rank < Constants::Board::LENGTH; ++rank) {
+        for (int file = 0; file < Constants::Board::LENGTH; ++file) {
+            Util::setBit(ranks[rank], Util::makeSquare(file, rank));
+        }
+    }
+    return ranks;
+}
+
+// Diagonal i holds the squares with file - rank == i - DIAGONAL_CENTER (a1-h8 direction);
+// anti-diagonal i holds the squares with file + rank == 2 * DIAGONAL_CENTER - i
+constexpr auto makeDiagonals(bool anti) -> std::array<Bitboard, Constants::Board::DIAGONAL_COUNT>
+{
+    std::array<Bitboard, Constants::Board::DIAGONAL_COUNT> diagonals{};
+    for (int i = 0; i < Constants::Board::DIAGONAL_COUNT; ++i) {
+        const int DIAG = i - Constants::Board::DIAGONAL_CENTER;
+        for (int file = 0; file < Constants::Board::LENGTH; ++file) {
+            const int RANK = anti ? Constants::Board::DIAGONAL_CENTER - file - DIAG : file - DIAG;
+            if (RANK >= 0 && RANK < Constants::Board::LENGTH) {
+                Util::setBit(diagonals[i], Util::makeSquare(file, RANK));
+            }
+        }
+    }
+    return diagonals;
+}
+
+constexpr auto makeSquares() -> std::array<Bitboard, Constants::Board::SQUARE_COUNT>
+{
+    std::array<Bitboard, Constants::Board::SQUARE_COUNT> squares{};
+    for (unsigned sq = 0; sq < Constants::Board::SQUARE_COUNT; ++sq) { squares[sq] = 1ULL << sq; }
+    return squares;
+}
+
+using SquarePairTable = std::array<std::array<Bitboard, Constants::Board::SQUARE_COUNT>,
+                                   Constants::Board::SQUARE_COUNT>;
+
+constexpr auto sign(int value) -> int { return static_cast<int>(value > 0) - (value < 0); }
+
+// between[a][b]: squares strictly between two aligned squares; line[a][b]: the whole line
+// through both of them. Both are empty for squares that share no rank, file or diagonal.
+constexpr auto makeSquarePairTable(bool full_line) -> SquarePairTable
+{
+    SquarePairTable table{};
+    for (int from = 0; from < Constants::Board::SQUARE_COUNT; ++from) {
+        for (int to = 0; to < Constants::Board::SQUARE_COUNT; ++to) {
+            const auto FROM = Util::fromIdx<Square>(from);
+            const auto TO = Util::fromIdx<Square>(to);
+            const int FILE_DELTA = Util::getFile(TO) - Util::getFile(FROM);
+            const int RANK_DELTA = Util::getRank(TO) - Util::getRank(FROM);
+            const bool ALIGNED = FILE_DELTA == 0 || RANK_DELTA == 0 ||
+                                 FILE_DELTA == RANK_DELTA || FILE_DELTA == -RANK_DELTA;
+            if (from == to || !ALIGNED) { continue; }
+
+            const int STEP_FILE = sign(FILE_DELTA);
+            const int STEP_RANK = sign(RANK_DELTA);
+            if (full_line) {
+                Util::setBit(table[from][to], FROM);
+                for (const int DIR : {1, -1}) {
+                    Square sq = Util::makeSquare(Util::getFile(FROM) + (DIR * STEP_FILE),
+                                                 Util::getRank(FROM) + (DIR * STEP_RANK));
+                    while (sq != Square::NONE) {
+                        Util::setBit(table[from][to], sq);
+                        sq = Util::makeSquare(Util::getFile(sq) + (DIR * STEP_FILE),
+                                              Util::getRank(sq) + (DIR * STEP_RANK));
+                    }
+                }
+            }
+            else {
+                Square sq = Util::makeSquare(Util::getFile(FROM) + STEP_FILE,
+                                             Util::getRank(FROM) + STEP_RANK);
+                while (sq != TO) {
+                    Util::setBit(table[from][to], sq);
+                    sq = Util::makeSquare(Util::getFile(sq) + STEP_FILE,
+                                          Util::getRank(sq) + STEP_RANK);
+                }
+            }
+        }
+    }
+    return table;
+}
+
+struct Offset {
+    int file;
+    int rank;
+};
+
+template <std::size_t N>
+constexpr auto makeLeaperAttacks(const std::array<Offset, N>& offsets)
+    -> std::array<Bitboard, Constants::Board::SQUARE_COUNT>
+{
+    std::array<Bitboard, Constants::Board::SQUARE_COUNT> attacks{};
+    for (int sq = 0; sq < Constants::Board::SQUARE_COUNT; ++sq) {
+        const auto SQUARE = Util::fromIdx<Square>(sq);
+        for (const Offset& offset : offsets) {
+            const Square TARGET = Util::makeSquare(Util::getFile(SQUARE) + offset.file,
+                                                   Util::getRank(SQUARE) + offset.rank);
+            if (TARGET != Square::NONE) { Util::setBit(attacks[sq], TARGET); }
+        }
+    }
+    return attacks;
+}
+
+constexpr std::array<Offset, 8> KNIGHT_OFFSETS = {
+    {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}}};
+constexpr std::array<Offset, 8> KING_OFFSETS = {
+    {{0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}}};
+constexpr std::array<Offset, 2> WHITE_PAWN_OFFSETS = {{{-1, 1}, {1, 1}}};
+constexpr std::array<Offset, 2> BLACK_PAWN_OFFSETS = {{{-1, -1}, {1, -1}}};
+
+} // namespace Tables
+
 class Bitboards {
 public:
+    // Index scheme used for sliding-piece lookups; PEXT requires building with BMI2
+    enum class SliderBackend : uint8_t { MAGIC, PEXT };
+
+#if defined(USE_PEXT)
+    static constexpr SliderBackend SLIDER_BACKEND = SliderBackend::PEXT;
+#else
+    static constexpr SliderBackend SLIDER_BACKEND = SliderBackend::MAGIC;
+#endif
+
+    // Fills the slider tables; every other table is generated at compile time
     static auto init() -> void;
+    // The instruction set of the multi-versioned kernels on this machine: "x86-64-v3" or
+    // "x86-64" in a dispatching build, otherwise "builtin" or "portable" for the whole build
+    static auto kernels() -> const char*;
 
-    static auto lsb(Bitboard bitb) -> Square;
-    static auto msb(Bitboard bitb) -> Square;
-    static auto popCount(Bitboard bitb) -> int;
-    static auto popLsb(Bitboard& bitb) -> Bitboard;
+    static constexpr auto lsb(Bitboard bitb) -> Square;
+    static constexpr auto msb(Bitboard bitb) -> Square;
+    static constexpr auto popCount(Bitboard bitb) -> int;
+    static constexpr auto popLsb(Bitboard& bitb) -> Bitboard;
+    static constexpr auto popSquare(Bitboard& bitb) -> Square;
 
     static auto print(Bitboard bitb) -> void;
 
-    static std::array<Bitboard, Constants::Board::LENGTH> files;
-    static std::array<Bitboard, Constants::Board::LENGTH> ranks;
-    static std::array<Bitboard, Constants::Board::DIAGONAL_COUNT> diagonals;
-    static std::array<Bitboard, Constants::Board::DIAGONAL_COUNT> anti_diagonals;
-    static std::array<Bitboard, Constants::Board::SQUARE_COUNT> squares;
+    template <SliderBackend BACKEND = SLIDER_BACKEND>
+    static auto bishopAttacks(Square square, Bitboard occupied) -> Bitboard;
+    template <SliderBackend BACKEND = SLIDER_BACKEND>
+    static auto rookAttacks(Square square, Bitboard occupied) -> Bitboard;
+    template <SliderBackend BACKEND = SLIDER_BACKEND>
+    static auto queenAttacks(Square square, Bitboard occupied) -> Bitboard;
+    // Attacks of a non-pawn piece type; leapers ignore `occupied`
+    template <PieceType TYPE> static auto attacks(Square square, Bitboard occupied) -> Bitboard;
+
+    static constexpr auto knightAttacks(Square square) -> Bitboard;
+    static constexpr auto kingAttacks(Square square) -> Bitboard;
+    static constexpr auto pawnAttacks(Color color, Square square) -> Bitboard;
+
+    static constexpr auto between(Square from, Square to) -> Bitboard;
+    static constexpr auto line(Square from, Square to) -> Bitboard;
+
+    static constexpr std::array<Bitboard, Constants::Board::LENGTH> files = Tables::makeFiles();
+    static constexpr std::array<Bitboard, Constants::Board::LENGTH> ranks = Tables::makeRanks();
+    static constexpr std::array<Bitboard, Constants::Board::DIAGONAL_COUNT> diagonals =
+        Tables::makeDiagonals(false);
+    static constexpr std::array<Bitboard, Constants::Board::DIAGONAL_COUNT> anti_diagonals =
+        Tables::makeDiagonals(true);
+    static constexpr std::array<Bitboard, Constants::Board::SQUARE_COUNT> squares =
+        Tables::makeSquares();
+
+    static constexpr std::array<Bitboard, Constants::Board::SQUARE_COUNT> knight_attacks =
+        Tables::makeLeaperAttacks(Tables::KNIGHT_OFFSETS);
+    static constexpr std::array<Bitboard, Constants::Board::SQUARE_COUNT> king_attacks =
+        Tables::makeLeaperAttacks(Tables::KING_OFFSETS);
+    static constexpr std::array<std::array<Bitboard, Constants::Board::SQUARE_COUNT>,
+                                Constants::Board::COLOR_COUNT>
+        pawn_attacks = {Tables::makeLeaperAttacks(Tables::WHITE_PAWN_OFFSETS),
+                        Tables::makeLeaperAttacks(Tables::BLACK_PAWN_OFFSETS)};
+
+    static constexpr Tables::SquarePairTable between_squares = Tables::makeSquarePairTable(false);
+    static constexpr Tables::SquarePairTable line_squares = Tables::makeSquarePairTable(true);
 
 private:
-    static std::array<int, Constants::Board::SQUARE_COUNT> debruijn_lut;
+    struct Magic {
+        Bitboard mask;
+        Bitboard magic;
+        Bitboard* attacks;
+#if defined(USE_PEXT)
+        Bitboard* pext_attacks;
+#endif
+        unsigned int shift;
+    };
+
+    template <SliderBackend BACKEND>
+    static auto lookup(const Magic& entry, Bitboard occupied) -> Bitboard;
+    static auto initSliders(std::array<Magic, Constants::Board::SQUARE_COUNT>& magics,
+                            const std::array<Bitboard, Constants::Board::SQUARE_COUNT>& numbers,
+                            Bitboard* table,
+                            Bitboard* pext_table,
+                            bool rook) -> void;
+
+    // clang-format off
+    static constexpr std::array<int, Constants::Board::SQUARE_COUNT> debruijn_lut = {
+        0,  1,  48, 2,  57, 49, 28, 3,
+        61, 58, 50, 42, 38, 29, 17, 4,
+        62, 55, 59, 36, 53, 51, 43, 22,
+        45, 39, 33, 30, 24, 18, 12, 5,
+        63, 47, 56, 27, 60, 41, 37, 16,
+        54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10,
+        25, 14, 19, 9,  13, 8,  7,  6
+    };
+    // clang-format on
     static constexpr Bitboard DEBRUIJN_CONSTANT = 0x03f79d71b4cb0a89ULL;
+
+    static std::array<Magic, Constants::Board::SQUARE_COUNT> bishop_magics;
+    static std::array<Magic, Constants::Board::SQUARE_COUNT> rook_magics;
+    static std::array<Bitboard, Constants::Attacks::BISHOP_TABLE_SIZE> bishop_table;
+    static std::array<Bitboard, Constants::Attacks::ROOK_TABLE_SIZE> rook_table;
+#if defined(USE_PEXT)
+    static std::array<Bitboard, Constants::Attacks::BISHOP_TABLE_SIZE> bishop_pext_table;
+    static std::array<Bitboard, Constants::Attacks::ROOK_TABLE_SIZE> rook_pext_table;
+#endif
 };
 
-namespace Util {
+// Without builtins: the De Bruijn index is always < 64, so the lookups skip bounds checks
+constexpr auto Bitboards::lsb(Bitboard bitb) -> Square
+{
+    if (bitb == 0) { return Square::NONE; }
+#if defined(HAS_BIT_BUILTINS)
+    return Util::fromIdx<Square>(static_cast<uint8_t>(__builtin_ctzll(bitb)));
+#else
+    return Util::fromIdx<Square>(
+        debruijn_lut[((bitb & -bitb) * DEBRUIJN_CONSTANT) >> Constants::DEBRUIJN_SHIFT]);
+#endif
+}
 
-inline auto testBit(Bitboard bitb, Square square) -> bool
+constexpr auto Bitboards::msb(Bitboard bitb) -> Square
 {
-    return (bitb & (1ULL << static_cast<unsigned>(square))) != 0;
-};
-inline auto setBit(Bitboard& bitb, Square square) -> void
+    if (bitb == 0) { return Square::NONE; }
+#if defined(HAS_BIT_BUILTINS)
+    return Util::fromIdx<Square>(
+        static_cast<uint8_t>(Constants::Board::SQUARE_COUNT - 1 - __builtin_clzll(bitb)));
+#else
+    for (unsigned int i = 0; i < Constants::MSB_RSHIFT_COUNT; ++i) { bitb |= bitb >> (1U << i); }
+    bitb &= ~(bitb >> 1ULL);
+
+    return Util::fromIdx<Square>(
+        debruijn_lut[(bitb * DEBRUIJN_CONSTANT) >> Constants::DEBRUIJN_SHIFT]);
+#endif
+}
+
+// The portable version sums bits in ever wider fields, then adds the eight byte sums with one
+// multiply
+constexpr auto Bitboards::popCount(Bitboard bitb) -> int
 {
-    bitb |= (1ULL << static_cast<unsigned>(square));
+#if defined(HAS_BIT_BUILTINS)
+    return __builtin_popcountll(bitb);
+#else
+    constexpr Bitboard PAIRS = 0x5555555555555555ULL;
+    constexpr Bitboard NIBBLES = 0x3333333333333333ULL;
+    constexpr Bitboard BYTES = 0x0F0F0F0F0F0F0F0FULL;
+    constexpr Bitboard BYTE_SUM = 0x0101010101010101ULL;
+    constexpr unsigned int TOP_BYTE_SHIFT = 56;
+
+    bitb -= (bitb >> 1U) & PAIRS;
+    bitb = (bitb & NIBBLES) + ((bitb >> 2U) & NIBBLES);
+    bitb = (bitb + (bitb >> 4U)) & BYTES;
+    return static_cast<int>((bitb * BYTE_SUM) >> TOP_BYTE_SHIFT);
+#endif
 }
-inline auto clearBit(Bitboard& bitb, Square square) -> void
+
+constexpr auto Bitboards::popLsb(Bitboard& bitb) -> Bitboard
 {
-    bitb &= ~(1ULL << static_cast<unsigned>(square));
+    const Bitboard BITB = bitb;
+    bitb &= (bitb - 1);
+    return BITB & ~bitb;
+}
+
+// Clears the lowest set bit and returns its square
+constexpr auto Bitboards::popSquare(Bitboard& bitb) -> Square
+{
+    const Square SQUARE = lsb(bitb);
+    bitb &= (bitb - 1);
+    return SQUARE;
+}
+
+constexpr auto Bitboards::knightAttacks(Square square) -> Bitboard
+{
+    return knight_attacks[Util::toIdx(square)];
+}
+
+constexpr auto Bitboards::kingAttacks(Square square) -> Bitboard
+{
+    return king_attacks[Util::toIdx(square)];
+}
+
+constexpr auto Bitboards::pawnAttacks(Color color, Square square) -> Bitboard
+{
+    return pawn_attacks[Util::toIdx(color)][Util::toIdx(square)];
+}
+
+constexpr auto Bitboards::between(Square from, Square to) -> Bitboard
+{
+    return between_squares[Util::toIdx(from)][Util::toIdx(to)];
+}
+
+constexpr auto Bitboards::line(Square from, Square to) -> Bitboard
+{
+    return line_squares[Util::toIdx(from)][Util::toIdx(to)];
+}
+
+// Slider lookups are inlined into callers; the tables are filled by `Bitboards::init()`
+template <Bitboards::SliderBackend BACKEND>
+inline auto Bitboards::lookup(const Magic& entry, Bitboard occupied) -> Bitboard
+{
+    if constexpr (BACKEND == SliderBackend::PEXT) {
+#if defined(USE_PEXT)
+        return entry.pext_attacks[_pext_u64(occupied, entry.mask)];
+#else
+        static_assert(BACKEND != SliderBackend::PEXT, "PEXT backend requires USE_PEXT (BMI2)");
+        return 0;
+#endif
+    }
+    else {
+        return entry.attacks[((occupied & entry.mask) * entry.magic) >> entry.shift];
+    }
+}
+
+template <Bitboards::SliderBackend BACKEND>
+inline auto Bitboards::bishopAttacks(Square square, Bitboard occupied) -> Bitboard
+{
+    return lookup<BACKEND>(bishop_magics[Util::toIdx(square)], occupied);
 }
-inline auto squareBB(Square square) -> Bitboard { return 1ULL << static_cast<unsigned>(square); }
 
-inline auto northOne(Bitboard bitb) -> Bitboard
+template <Bitboards::SliderBackend BACKEND>
+inline auto Bitboards::rookAttacks(Square square, Bitboard occupied) -> Bitboard
+{
+    return lookup<BACKEND>(rook_magics[Util::toIdx(square)], occupied);
+}
+
+template <Bitboards::SliderBackend BACKEND>
+inline auto Bitboards::queenAttacks(Square square, Bitboard occupied) -> Bitboard
+{
+    return bishopAttacks<BACKEND>(square, occupied) | rookAttacks<BACKEND>(square, occupied);
+}
+
+template <PieceType TYPE>
+inline auto Bitboards::attacks(Square square, Bitboard occupied) -> Bitboard
+{
+    static_assert(TYPE != PieceType::PAWN && TYPE != PieceType::NONE, "Pawn attacks need a color");
+
+    if constexpr (TYPE == PieceType::KNIGHT) { return knightAttacks(square); }
+    else if constexpr (TYPE == PieceType::BISHOP) { return bishopAttacks(square, occupied); }
+    else if constexpr (TYPE == PieceType::ROOK) { return rookAttacks(square, occupied); }
+    else if constexpr (TYPE == PieceType::QUEEN) { return queenAttacks(square, occupied); }
+    else { return kingAttacks(square); }
+}
+
+namespace Util {
+
+constexpr auto northOne(Bitboard bitb) -> Bitboard
 {
     return bitb << static_cast<unsigned>(Constants::Board::LENGTH);
 }
-inline auto southOne(Bitboard bitb) -> Bitboard
+constexpr auto southOne(Bitboard bitb) -> Bitboard
 {
     return bitb >> static_cast<unsigned>(Constants::Board::LENGTH);
 }
-inline auto eastOne(Bitboard bitb) -> Bitboard { return (bitb << 1ULL) & ~Bitboards::files.at(0); }
-inline auto westOne(Bitboard bitb) -> Bitboard
+constexpr auto eastOne(Bitboard bitb) -> Bitboard { return (bitb << 1ULL) & ~Bitboards::files[0]; }
+constexpr auto westOne(Bitboard bitb) -> Bitboard
 {
-    return (bitb >> 1ULL) & ~Bitboards::files.at(Constants::Board::LENGTH - 1);
+    return (bitb >> 1ULL) & ~Bitboards::files[Constants::Board::LENGTH - 1];
 }
 
-inline auto northEastOne(Bitboard bitb) -> Bitboard { return northOne(eastOne(bitb)); }
-inline auto northWestOne(Bitboard bitb) -> Bitboard { return northOne(westOne(bitb)); }
-inline auto southEastOne(Bitboard bitb) -> Bitboard { return southOne(eastOne(bitb)); }
-inline auto southWestOne(Bitboard bitb) -> Bitboard { return southOne(westOne(bitb)); }
+constexpr auto northEastOne(Bitboard bitb) -> Bitboard { return northOne(eastOne(bitb)); }
+constexpr auto northWestOne(Bitboard bitb) -> Bitboard { return northOne(westOne(bitb)); }
+constexpr auto southEastOne(Bitboard bitb) -> Bitboard { return southOne(eastOne(bitb)); }
+constexpr auto southWestOne(Bitboard bitb) -> Bitboard { return southOne(westOne(bitb)); }
 
 } // namespace Util
 
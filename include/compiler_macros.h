@@ -11,4 +11,27 @@
 #define UNROLL_PARTIAL
 #endif
 
+// Cache prefetch hint for table lookups that are known ahead of time
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address) static_cast<void>(address)
+#endif
+
+// Bit scans use the compiler builtins unless USE_PORTABLE asks for the table-based versions
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(USE_PORTABLE)
+#define HAS_BIT_BUILTINS
+#endif
+
+// Hot kernels are built for baseline x86-64 and for x86-64-v3, and the loader picks one per
+// function from cpuid at startup. Each version inlines its helpers, so builtins in them become
+// tzcnt, lzcnt and popcnt in the v3 code and bsf, bsr and a library call in the baseline.
+#if defined(USE_DISPATCH) && defined(HAS_BIT_BUILTINS) && defined(__x86_64__) &&                 \
+    defined(__ELF__) && !defined(__clang__) && __GNUC__ >= 12
+#define HAS_DISPATCH
+#define MULTIVERSION __attribute__((target_clones("default", "arch=x86-64-v3"), flatten))
+#else
+#define MULTIVERSION
+#endif
+
 #endif // CHESS_COMPILER_MACROS_H
\ No newline at end of file
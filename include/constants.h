@@ -27,10 +27,137 @@ constexpr int NO_SQUARE = -1;
 
 } // namespace Board
 
+namespace Attacks {
+
+// Sum of 2^popcount(relevant occupancy mask) over all 64 squares
+constexpr int BISHOP_TABLE_SIZE = 5248;
+constexpr int ROOK_TABLE_SIZE = 102400;
+
+} // namespace Attacks
+
+namespace Game {
+
+// Undo entries kept by Position; a power of two so the ring index is a mask
+constexpr int HISTORY_SIZE = 1024;
+
+// Halfmove clock value at which the fifty-move rule applies
+constexpr int FIFTY_MOVE_PLIES = 100;
+
+// Buffer size that holds any FEN `Position::toFen` writes plus its terminator
+constexpr int MAX_FEN_LENGTH = 128;
+
+} // namespace Game
+
+namespace Packed {
+
+// Size of one `PackedPosition`; every legal position has at most 32 pieces, one nibble each
+constexpr int RECORD_SIZE = 32;
+constexpr int MAX_PIECES = 32;
+constexpr int PIECE_BYTES = MAX_PIECES / 2;
+// `PackedPosition::score` when no score is known
+constexpr int SCORE_NONE = -32768;
+
+} // namespace Packed
+
+namespace MoveGen {
+
+constexpr int MAX_MOVES = 256;
+
+} // namespace MoveGen
+
+namespace Search {
+
+constexpr int MAX_PLY = 128;
+
+constexpr int INFINITE_SCORE = 32000;
+constexpr int MATE_SCORE = 31000;
+// Scores beyond this are mates found within MAX_PLY
+constexpr int MATE_BOUND = MATE_SCORE - MAX_PLY;
+// Bitbase wins score below every mate and above every evaluation, less the ply they are found
+// at; scores beyond BITBASE_BOUND are such wins or mates
+constexpr int BITBASE_WIN = MATE_BOUND - 1;
+constexpr int BITBASE_BOUND = BITBASE_WIN - MAX_PLY;
+
+constexpr auto isMateScore(int score) -> bool
+{
+    return score >= MATE_BOUND || score <= -MATE_BOUND;
+}
+
+} // namespace Search
+
+namespace Eval {
+
+// Phase of the starting position; promotions can push the running phase above it
+constexpr int MAX_PHASE = 24;
+
+// Floor of scores for positions a specialised endgame function knows to be won
+constexpr int KNOWN_WIN = 10000;
+
+// Scale factors shrink the score of drawish material towards zero, in units of 1/SCALE_NORMAL
+constexpr int SCALE_NORMAL = 64;
+
+} // namespace Eval
+
+namespace Bitbase {
+
+// Largest table, kings included
+constexpr int MAX_PIECES = 4;
+
+} // namespace Bitbase
+
+namespace Pawns {
+
+// Per-thread pawn hash entries; a power of two
+constexpr int TABLE_ENTRIES = 16384;
+
+} // namespace Pawns
+
+namespace Material {
+
+// Per-thread material hash entries; a power of two
+constexpr int TABLE_ENTRIES = 8192;
+
+} // namespace Material
+
+namespace NNUE {
+
+// HalfKP: the perspective's king square times the ten non-king pieces on each square
+constexpr int KING_SQUARES = 64;
+constexpr int PIECE_FEATURES = 10 * 64;
+constexpr int FEATURE_COUNT = KING_SQUARES * PIECE_FEATURES;
+
+constexpr int HIDDEN_SIZE = 256;
+constexpr int L2_SIZE = 32;
+constexpr int L3_SIZE = 32;
+
+// Layer inputs are clipped to [0, CRELU_MAX]; layer sums carry WEIGHT_SCALE_BITS of fraction
+constexpr int CRELU_MAX = 127;
+constexpr int WEIGHT_SCALE_BITS = 6;
+// Network output units per centipawn
+constexpr int OUTPUT_SCALE = 16;
+
+} // namespace NNUE
+
+namespace TT {
+
+constexpr int DEFAULT_SIZE_MB = 16;
+// Largest size the front ends accept, for this table and the tools' caches alike
+constexpr int MAX_SIZE_MB = 65536;
+constexpr int ENTRIES_PER_BUCKET = 4;
+constexpr int CACHE_LINE_SIZE = 64;
+constexpr int LARGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// Entries inspected by `hashfull`, the UCI metric is per mille
+constexpr int HASHFULL_SAMPLE = 1000;
+
+} // namespace TT
+
 namespace Zobrist {
 
 constexpr int PIECE_COUNT = 15;
 constexpr int CASTLING_COMBINATIONS = 16;
+// Most pieces of one kind a side can have: two originals plus eight promoted pawns
+constexpr int MAX_PIECES_PER_TYPE = 10;
 
 } // namespace Zobrist
 
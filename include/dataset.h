@@ -0,0 +1,106 @@
+#ifndef CHESS_DATASET_H
+#define CHESS_DATASET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "mappedfile.h"
+#include "packed.h"
+#include "position.h"
+
+namespace Chess {
+
+// Training data file: a header the size of one record, then `PackedPosition` records back to
+// back. Files are read through a read-only memory map, so records are used in place and any
+// one of them is reached without reading the others. A file written on a machine of the other
+// endianness fails the header check.
+class Dataset {
+public:
+    using Access = MappedFile::Access;
+
+    Dataset() = default;
+    ~Dataset();
+
+    Dataset(const Dataset&) = delete;
+    auto operator=(const Dataset&) -> Dataset& = delete;
+    Dataset(Dataset&& other) noexcept;
+    auto operator=(Dataset&& other) noexcept -> Dataset&;
+
+    // Maps `path`, replacing any open file. Fails if it cannot be mapped, has a bad header, or
+    // does not hold a whole number of records.
+    [[nodiscard]] auto open(const std::string& path, Access access = Access::SEQUENTIAL) -> bool;
+    auto close() -> void;
+
+    [[nodiscard]] auto size() const -> std::size_t;
+    [[nodiscard]] auto operator[](std::size_t index) const -> const PackedPosition&;
+    [[nodiscard]] auto begin() const -> const PackedPosition*;
+    [[nodiscard]] auto end() const -> const PackedPosition*;
+
+private:
+    MappedFile m_file;
+    const PackedPosition* m_records = nullptr;
+    std::size_t m_size = 0;
+};
+
+// Streams a range of a dataset into one caller-owned position, record by record, skipping
+// records `Position::fromPacked` rejects. Disjoint ranges can be read by separate threads.
+class DatasetReader {
+public:
+    explicit DatasetReader(const Dataset& dataset);
+    DatasetReader(const Dataset& dataset, std::size_t first, std::size_t last);
+
+    // Loads the next valid record into `pos`; false once the range is exhausted
+    [[nodiscard]] auto next(Position& pos) -> bool;
+    // The record last loaded, for its score and result
+    [[nodiscard]] auto record() const -> const PackedPosition&;
+    [[nodiscard]] auto skipped() const -> std::size_t;
+
+private:
+    const PackedPosition* m_next;
+    const PackedPosition* m_end;
+    const PackedPosition* m_current = nullptr;
+    std::size_t m_skipped = 0;
+};
+
+// Writes a dataset file record by record
+class DatasetWriter {
+public:
+    // Creates or truncates `path` and writes the header
+    [[nodiscard]] auto open(const std::string& path) -> bool;
+    [[nodiscard]] auto write(const PackedPosition& record) -> bool;
+    // Flushes and closes; false if any write failed
+    [[nodiscard]] auto close() -> bool;
+
+    [[nodiscard]] auto size() const -> std::size_t;
+
+private:
+    std::ofstream m_file;
+    std::size_t m_size = 0;
+};
+
+inline auto Dataset::size() const -> std::size_t { return m_size; }
+
+inline auto Dataset::operator[](std::size_t index) const -> const PackedPosition&
+{
+    return m_records[index];
+}
+
+inline auto Dataset::begin() const -> const PackedPosition* { return m_records; }
+
+inline auto Dataset::end() const -> const PackedPosition* { return m_records + m_size; }
+
+inline auto DatasetReader::next(Position& pos) -> bool
+{
+    while (m_next != m_end) {
+        m_current = m_next++;
+        if (pos.fromPacked(*m_current) == FenError::NONE) { return true; }
+        ++m_skipped;
+    }
+    return false;
+}
+
+} // namespace Chess
+
+#endif // CHESS_DATASET_H
@@ -0,0 +1,23 @@
+#ifndef CHESS_ENDGAME_H
+#define CHESS_ENDGAME_H
+
+#include "position.h"
+#include "types.h"
+
+namespace Chess::Endgames {
+
+// Specialised evaluation of a known material balance, in centipawns from `strong`'s point of
+// view. The material table picks one by material key, so each may assume its material.
+using Function = auto (*)(const Position& pos, Color strong) -> int;
+
+// Mating material (at least a rook or queen) against a lone king: drive the king to the edge
+auto kxk(const Position& pos, Color strong) -> int;
+// Bishop and knight against a lone king: drive the king to a corner of the bishop's colour
+auto kbnk(const Position& pos, Color strong) -> int;
+// King and pawn against king, by the rule of the square, key squares and the rook-pawn
+// corner. Positions the rules do not settle get an ordinary pawn-up score.
+auto kpk(const Position& pos, Color strong) -> int;
+
+} // namespace Chess::Endgames
+
+#endif // CHESS_ENDGAME_H
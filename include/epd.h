@@ -0,0 +1,32 @@
+#ifndef CHESS_EPD_H
+#define CHESS_EPD_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Chess::Epd {
+
+// One "opcode operands;" operation, viewing the line it was parsed from. Quotes around the
+// whole operand list are removed.
+struct Operation {
+    std::string_view opcode;
+    std::string_view operands;
+};
+
+// Splits an EPD line into a full six-field FEN for `Position::fromFen` and its operations.
+// The move counters come from FEN fields after the first four, or from the hmvc and fmvn
+// operations, else default to "0 1". False if the line has fewer than four fields.
+auto parse(std::string_view line, std::string& fen, std::vector<Operation>& operations) -> bool;
+
+// The operands of `opcode`, or an empty view
+auto find(const std::vector<Operation>& operations, std::string_view opcode) -> std::string_view;
+
+// Splits off the next blank-separated token of `text`
+auto nextToken(std::string_view& text) -> std::string_view;
+
+auto trim(std::string_view text) -> std::string_view;
+
+} // namespace Chess::Epd
+
+#endif // CHESS_EPD_H
@@ -0,0 +1,29 @@
+#ifndef CHESS_EVAL_H
+#define CHESS_EVAL_H
+
+#include <array>
+
+#include "constants.h"
+#include "material.h"
+#include "pawns.h"
+#include "position.h"
+#include "types.h"
+
+namespace Chess::Eval {
+
+// Centipawn values indexed by PieceType (NONE and KING are worth nothing), used for exchanges
+constexpr std::array<int, Constants::Board::PIECE_TYPE_COUNT + 1> PIECE_VALUES = {
+    0, 100, 320, 330, 500, 900, 0};
+
+constexpr auto pieceValue(PieceType type) -> int { return PIECE_VALUES[Util::toIdx(type)]; }
+
+// Tapered piece-square, pawn-structure and material evaluation in centipawns from the side to
+// move's point of view, or a specialised endgame evaluation where one applies. The second form
+// caches the pawn structure and material in the caller's tables.
+auto evaluate(const Position& pos) -> int;
+auto evaluate(const Position& pos, Pawns::Table& pawn_table, Material::Table& material_table)
+    -> int;
+
+} // namespace Chess::Eval
+
+#endif // CHESS_EVAL_H
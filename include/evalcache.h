@@ -0,0 +1,78 @@
+#ifndef CHESS_EVALCACHE_H
+#define CHESS_EVALCACHE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "position.h"
+#include "types.h"
+
+namespace Chess {
+
+// Direct-mapped, always-replace cache of evaluation entries for the part of a position
+// `KEY_OF` hashes. A miss refills the slot with `evaluate(pos, entry)`, found next to `Entry`;
+// a value-initialised `Entry` marks an empty slot. Not thread safe; each searcher owns one.
+template <typename Entry, HashKey (Position::*KEY_OF)() const, std::size_t DEFAULT_ENTRIES>
+class EvalCache {
+public:
+    explicit EvalCache(std::size_t entries = DEFAULT_ENTRIES);
+
+    // The entry for the position, evaluated on a miss
+    auto probe(const Position& pos) -> const Entry&;
+    auto clear() -> void;
+
+    [[nodiscard]] auto probes() const -> uint64_t;
+    [[nodiscard]] auto hits() const -> uint64_t;
+
+private:
+    std::vector<Entry> m_entries;
+    std::size_t m_mask;
+    uint64_t m_probes = 0;
+    uint64_t m_hits = 0;
+};
+
+template <typename Entry, HashKey (Position::*KEY_OF)() const, std::size_t DEFAULT_ENTRIES>
+EvalCache<Entry, KEY_OF, DEFAULT_ENTRIES>::EvalCache(std::size_t entries)
+    : m_entries(entries), m_mask(entries - 1)
+{
+    assert((entries & m_mask) == 0 && "evaluation cache size must be a power of two");
+    clear();
+}
+
+template <typename Entry, HashKey (Position::*KEY_OF)() const, std::size_t DEFAULT_ENTRIES>
+inline auto EvalCache<Entry, KEY_OF, DEFAULT_ENTRIES>::probe(const Position& pos) -> const Entry&
+{
+    const HashKey KEY = (pos.*KEY_OF)();
+    Entry& entry = m_entries[KEY & m_mask];
+    ++m_probes;
+    if (entry.key == KEY) { ++m_hits; }
+    else { evaluate(pos, entry); }
+    return entry;
+}
+
+template <typename Entry, HashKey (Position::*KEY_OF)() const, std::size_t DEFAULT_ENTRIES>
+auto EvalCache<Entry, KEY_OF, DEFAULT_ENTRIES>::clear() -> void
+{
+    std::fill(m_entries.begin(), m_entries.end(), Entry{});
+    m_probes = 0;
+    m_hits = 0;
+}
+
+template <typename Entry, HashKey (Position::*KEY_OF)() const, std::size_t DEFAULT_ENTRIES>
+auto EvalCache<Entry, KEY_OF, DEFAULT_ENTRIES>::probes() const -> uint64_t
+{
+    return m_probes;
+}
+
+template <typename Entry, HashKey (Position::*KEY_OF)() const, std::size_t DEFAULT_ENTRIES>
+auto EvalCache<Entry, KEY_OF, DEFAULT_ENTRIES>::hits() const -> uint64_t
+{
+    return m_hits;
+}
+
+} // namespace Chess
+
+#endif // CHESS_EVALCACHE_H
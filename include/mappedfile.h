@@ -0,0 +1,48 @@
+#ifndef CHESS_MAPPEDFILE_H
+#define CHESS_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Chess {
+
+// A whole file mapped read-only, shared by the loaders that use their files in place
+class MappedFile {
+public:
+    // Read-ahead hint for the mapping
+    enum class Access : uint8_t { SEQUENTIAL, RANDOM };
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    auto operator=(const MappedFile&) -> MappedFile& = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+
+    // Maps `path`, replacing any open file. Fails if it cannot be opened or mapped, or is empty.
+    [[nodiscard]] auto open(const std::string& path, Access access) -> bool;
+    auto close() -> void;
+
+    [[nodiscard]] auto isOpen() const -> bool;
+    [[nodiscard]] auto data() const -> const unsigned char*;
+    [[nodiscard]] auto size() const -> std::size_t;
+
+private:
+    void* m_mapping = nullptr;
+    std::size_t m_size = 0;
+};
+
+inline auto MappedFile::isOpen() const -> bool { return m_mapping != nullptr; }
+
+inline auto MappedFile::data() const -> const unsigned char*
+{
+    return static_cast<const unsigned char*>(m_mapping);
+}
+
+inline auto MappedFile::size() const -> std::size_t { return m_size; }
+
+} // namespace Chess
+
+#endif // CHESS_MAPPEDFILE_H
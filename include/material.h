@@ -0,0 +1,40 @@
+#ifndef CHESS_MATERIAL_H
+#define CHESS_MATERIAL_H
+
+#include <array>
+#include <cstdint>
+
+#include "constants.h"
+#include "endgame.h"
+#include "evalcache.h"
+#include "position.h"
+#include "psqt.h"
+#include "types.h"
+
+namespace Chess::Material {
+
+// Everything evaluation needs that depends only on how many pieces of each kind are on the
+// board, so it can be cached by `Position::materialKey`. Scores are from White's point of view.
+struct Entry {
+    HashKey key = 0;
+    // Bishop pair, and knights and rooks gaining or losing value with the pawn count
+    PSQT::Score imbalance;
+    // Applied to the score when the side named is ahead, out of SCALE_NORMAL
+    std::array<uint8_t, Constants::Board::COLOR_COUNT> scale{Constants::Eval::SCALE_NORMAL,
+                                                             Constants::Eval::SCALE_NORMAL};
+    // Replaces the ordinary evaluation when set, from `strong_side`'s point of view
+    Endgames::Function endgame = nullptr;
+    Color strong_side = Color::WHITE;
+    // Neither side can ever mate: a bare king against a king and at most one minor piece
+    bool draw = false;
+};
+
+// Fills `entry` from scratch
+auto evaluate(const Position& pos, Entry& entry) -> void;
+
+// Material changes only on captures and promotions, so the working set is tiny
+using Table = EvalCache<Entry, &Position::materialKey, Constants::Material::TABLE_ENTRIES>;
+
+} // namespace Chess::Material
+
+#endif // CHESS_MATERIAL_H
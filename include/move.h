@@ -0,0 +1,134 @@
+#ifndef CHESS_MOVE_H
+#define CHESS_MOVE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "constants.h"
+#include "types.h"
+
+namespace Chess {
+
+// 4-bit move flags: bit 2 marks captures, bit 3 marks promotions (low bits pick the piece)
+enum class MoveFlag : uint8_t {
+    QUIET = 0,
+    DOUBLE_PAWN_PUSH = 1,
+    KING_CASTLE = 2,
+    QUEEN_CASTLE = 3,
+    CAPTURE = 4,
+    EN_PASSANT = 5,
+    KNIGHT_PROMOTION = 8,
+    BISHOP_PROMOTION = 9,
+    ROOK_PROMOTION = 10,
+    QUEEN_PROMOTION = 11,
+    KNIGHT_PROMOTION_CAPTURE = 12,
+    BISHOP_PROMOTION_CAPTURE = 13,
+    ROOK_PROMOTION_CAPTURE = 14,
+    QUEEN_PROMOTION_CAPTURE = 15
+};
+
+// Packed 16-bit move: from (6 bits) | to (6 bits) | flag (4 bits). The all-zero value is "no move".
+class Move {
+public:
+    // Trivial so that move arrays need no initialisation; `Move()` / `Move{}` is the null move
+    Move() = default;
+    constexpr Move(Square from, Square to, MoveFlag flag = MoveFlag::QUIET)
+        : m_data(static_cast<uint16_t>(Util::toIdx(from) | (Util::toIdx(to) << TO_SHIFT) |
+                                       (Util::toIdx(flag) << FLAG_SHIFT)))
+    {
+    }
+
+    [[nodiscard]] constexpr auto from() const -> Square
+    {
+        return Util::fromIdx<Square>(m_data & SQUARE_MASK);
+    }
+    [[nodiscard]] constexpr auto to() const -> Square
+    {
+        return Util::fromIdx<Square>((m_data >> TO_SHIFT) & SQUARE_MASK);
+    }
+    [[nodiscard]] constexpr auto flag() const -> MoveFlag
+    {
+        return Util::fromIdx<MoveFlag>(m_data >> FLAG_SHIFT);
+    }
+
+    [[nodiscard]] constexpr auto isCapture() const -> bool
+    {
+        return (Util::toIdx(flag()) & CAPTURE_BIT) != 0;
+    }
+    [[nodiscard]] constexpr auto isPromotion() const -> bool
+    {
+        return (Util::toIdx(flag()) & PROMOTION_BIT) != 0;
+    }
+    [[nodiscard]] constexpr auto isCastle() const -> bool
+    {
+        return flag() == MoveFlag::KING_CASTLE || flag() == MoveFlag::QUEEN_CASTLE;
+    }
+    [[nodiscard]] constexpr auto isEnPassant() const -> bool
+    {
+        return flag() == MoveFlag::EN_PASSANT;
+    }
+    // Captures and promotions change material, everything else is "quiet" for move ordering
+    [[nodiscard]] constexpr auto isTactical() const -> bool
+    {
+        return (Util::toIdx(flag()) & (CAPTURE_BIT | PROMOTION_BIT)) != 0;
+    }
+    [[nodiscard]] constexpr auto promotionType() const -> PieceType
+    {
+        if (!isPromotion()) { return PieceType::NONE; }
+        return Util::fromIdx<PieceType>(Util::toIdx(PieceType::KNIGHT) +
+                                        (Util::toIdx(flag()) & PROMOTION_PIECE_MASK));
+    }
+
+    [[nodiscard]] constexpr auto isNone() const -> bool { return m_data == 0; }
+    [[nodiscard]] constexpr auto raw() const -> uint16_t { return m_data; }
+    [[nodiscard]] static constexpr auto fromRaw(uint16_t data) -> Move
+    {
+        Move move{};
+        move.m_data = data;
+        return move;
+    }
+
+    [[nodiscard]] auto toUci() const -> std::string;
+
+    constexpr auto operator==(const Move& other) const -> bool { return m_data == other.m_data; }
+    constexpr auto operator!=(const Move& other) const -> bool { return m_data != other.m_data; }
+
+private:
+    static constexpr unsigned int TO_SHIFT = 6;
+    static constexpr unsigned int FLAG_SHIFT = 12;
+    static constexpr uint16_t SQUARE_MASK = 0x3F;
+    static constexpr uint8_t CAPTURE_BIT = 0x4;
+    static constexpr uint8_t PROMOTION_BIT = 0x8;
+    static constexpr uint8_t PROMOTION_PIECE_MASK = 0x3;
+
+    uint16_t m_data;
+};
+
+// Fixed-capacity move container that lives on the stack; no legal position exceeds 218 moves
+class MoveList {
+public:
+    constexpr auto push(Move move) -> void { m_moves[m_size++] = move; }
+    constexpr auto clear() -> void { m_size = 0; }
+
+    [[nodiscard]] constexpr auto size() const -> std::size_t { return m_size; }
+    [[nodiscard]] constexpr auto empty() const -> bool { return m_size == 0; }
+    [[nodiscard]] auto contains(Move move) const -> bool;
+
+    constexpr auto operator[](std::size_t idx) -> Move& { return m_moves[idx]; }
+    constexpr auto operator[](std::size_t idx) const -> const Move& { return m_moves[idx]; }
+
+    constexpr auto begin() -> Move* { return m_moves.data(); }
+    constexpr auto end() -> Move* { return m_moves.data() + m_size; }
+    [[nodiscard]] constexpr auto begin() const -> const Move* { return m_moves.data(); }
+    [[nodiscard]] constexpr auto end() const -> const Move* { return m_moves.data() + m_size; }
+
+private:
+    std::array<Move, Constants::MoveGen::MAX_MOVES> m_moves;
+    std::size_t m_size = 0;
+};
+
+} // namespace Chess
+
+#endif // CHESS_MOVE_H
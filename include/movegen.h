@@ -0,0 +1,40 @@
+#ifndef CHESS_MOVEGEN_H
+#define CHESS_MOVEGEN_H
+
+#include <cstdint>
+
+#include "move.h"
+#include "position.h"
+#include "types.h"
+
+namespace Chess::MoveGen {
+
+// CAPTURES: every capture plus queen promotions by push.
+// QUIETS: every other non-capture, including castling and under-promotions by push.
+// EVASIONS: replies to a check (king steps, captures of the checker, interpositions).
+// NON_EVASIONS: CAPTURES + QUIETS.
+enum class GenType : uint8_t { CAPTURES, QUIETS, EVASIONS, NON_EVASIONS };
+
+// Appends pseudo-legal moves of the requested kind to `list`, without touching the heap.
+// EVASIONS must only be requested while the side to move is in check, the others only when it is
+// not. Pseudo-legal moves may still leave the own king in check unless they are king moves or
+// castling, which are always generated legal.
+template <GenType TYPE> auto generate(const Position& pos, MoveList& list) -> void;
+
+// All pseudo-legal moves, choosing EVASIONS or NON_EVASIONS from the check state
+auto generatePseudoLegal(const Position& pos, MoveList& list) -> void;
+
+// Strictly legal moves. Checkers, pinned pieces and the check-evasion mask are computed once up
+// front, so no move has to be made and tested afterwards.
+auto generateLegal(const Position& pos) -> MoveList;
+
+// Whether `move` could have been produced by `generatePseudoLegal` in this position. Used to
+// vet moves that come from elsewhere, such as hash moves and killers, before they are played.
+auto isPseudoLegal(const Position& pos, Move move) -> bool;
+
+// Whether a pseudo-legal `move` leaves the own king safe
+auto isLegal(const Position& pos, Move move) -> bool;
+
+} // namespace Chess::MoveGen
+
+#endif // CHESS_MOVEGEN_H
@@ -0,0 +1,89 @@
+#ifndef CHESS_MOVEPICK_H
+#define CHESS_MOVEPICK_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "constants.h"
+#include "move.h"
+#include "position.h"
+#include "types.h"
+
+namespace Chess::Search {
+
+// Butterfly history of quiet moves that caused cutoffs, indexed by [color][from][to]
+using HistoryTable = std::array<
+    std::array<std::array<int, Constants::Board::SQUARE_COUNT>, Constants::Board::SQUARE_COUNT>,
+    Constants::Board::COLOR_COUNT>;
+
+// Quiet reply that last refuted a move, indexed by [moved piece][destination]
+using CounterMoveTable =
+    std::array<std::array<Move, Constants::Board::SQUARE_COUNT>, Constants::Zobrist::PIECE_COUNT>;
+
+// Two most recent quiet cutoff moves at a ply
+using Killers = std::array<Move, 2>;
+
+// Hands out legal moves one at a time, best first, generating each group only when it is
+// reached: hash move, captures that do not lose material by SEE (in MVV-LVA order), killers,
+// counter move, quiets by history, then losing captures. A cutoff on an early move never pays
+// for generating or sorting the quiets.
+class MovePicker {
+public:
+    // Main search
+    MovePicker(const Position& pos,
+               Move tt_move,
+               const Killers& killers,
+               Move counter_move,
+               const HistoryTable& history);
+    // Quiescence search: captures and queen promotions, or every evasion when in check
+    MovePicker(const Position& pos, Move tt_move, const HistoryTable& history);
+
+    // The next legal move, or the null move once every stage is exhausted
+    auto next() -> Move;
+
+private:
+    enum class Stage : uint8_t {
+        TT_MOVE,
+        GENERATE_CAPTURES,
+        GOOD_CAPTURES,
+        FIRST_KILLER,
+        SECOND_KILLER,
+        COUNTER_MOVE,
+        GENERATE_QUIETS,
+        QUIETS,
+        BAD_CAPTURES,
+        EVASION_TT_MOVE,
+        GENERATE_EVASIONS,
+        EVASIONS,
+        QUIESCENCE_TT_MOVE,
+        GENERATE_QUIESCENCE,
+        QUIESCENCE_CAPTURES,
+        DONE
+    };
+
+    auto scoreCaptures(std::size_t begin, std::size_t end) -> void;
+    auto scoreQuiets(std::size_t begin, std::size_t end) -> void;
+    auto selectBest(std::size_t begin, std::size_t end) -> void;
+    [[nodiscard]] auto isRefutation(Move move) const -> bool;
+    [[nodiscard]] auto isLosingCapture(Move move) const -> bool;
+
+    const Position& m_pos;
+    const HistoryTable& m_history;
+    Move m_tt_move;
+    Killers m_killers;
+    Move m_counter_move;
+    Stage m_stage;
+
+    // Captures are generated first and quiets appended after them; losing captures are moved
+    // down into the slots already handed out, [0, m_bad_end)
+    MoveList m_moves;
+    std::array<int, Constants::MoveGen::MAX_MOVES> m_scores;
+    std::size_t m_current;
+    std::size_t m_bad_end;
+    std::size_t m_captures_end;
+};
+
+} // namespace Chess::Search
+
+#endif // CHESS_MOVEPICK_H
@@ -0,0 +1,93 @@
+#ifndef CHESS_NNUE_H
+#define CHESS_NNUE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "constants.h"
+#include "move.h"
+#include "position.h"
+#include "types.h"
+
+namespace Chess::NNUE {
+
+constexpr int FEATURES = Constants::NNUE::FEATURE_COUNT;
+constexpr int HIDDEN = Constants::NNUE::HIDDEN_SIZE;
+constexpr int L1_INPUTS = 2 * HIDDEN;
+constexpr int L2 = Constants::NNUE::L2_SIZE;
+constexpr int L3 = Constants::NNUE::L3_SIZE;
+
+// Widest SIMD register the kernels load from; every layer width is a multiple of it
+constexpr std::size_t SIMD_ALIGNMENT = 64;
+
+// HalfKP network. Each perspective's king square paired with every non-king piece selects rows
+// of the feature transformer, summed into an int16 accumulator per side. The two accumulators,
+// side to move first, feed 512 -> 32 -> 32 -> 1 int8 affine layers with clipped ReLU between.
+struct Network {
+    alignas(SIMD_ALIGNMENT) std::array<int16_t, HIDDEN> feature_biases;
+    alignas(SIMD_ALIGNMENT) std::array<int16_t, static_cast<std::size_t>(FEATURES) * HIDDEN>
+        feature_weights;
+    alignas(SIMD_ALIGNMENT) std::array<int32_t, L2> l1_biases;
+    alignas(SIMD_ALIGNMENT) std::array<int8_t, L2 * L1_INPUTS> l1_weights;
+    alignas(SIMD_ALIGNMENT) std::array<int32_t, L3> l2_biases;
+    alignas(SIMD_ALIGNMENT) std::array<int8_t, L3 * L2> l2_weights;
+    alignas(SIMD_ALIGNMENT) std::array<int8_t, L3> output_weights;
+    int32_t output_bias;
+};
+
+// Reads a network written by `save`. Fails without touching `net` if the file is missing,
+// truncated, or was built for different layer sizes.
+auto load(const std::string& path, Network& net) -> bool;
+auto save(const std::string& path, const Network& net) -> bool;
+
+// Small random weights, for tests and benchmarks when no trained network is at hand
+auto randomize(Network& net, uint64_t seed) -> void;
+
+// Pieces the move into a ply took off or put on the board; kings are not features
+struct DirtyPieces {
+    static constexpr int MAX = 3;
+    std::array<Piece, MAX> pieces;
+    std::array<Square, MAX> from; // NONE when the piece appears (promotion)
+    std::array<Square, MAX> to;   // NONE when the piece disappears (capture, promotion)
+    int count;
+};
+
+struct Accumulator {
+    alignas(SIMD_ALIGNMENT) std::array<std::array<int16_t, HIDDEN>, Constants::Board::COLOR_COUNT>
+        values;
+    std::array<bool, Constants::Board::COLOR_COUNT> computed;
+    // A king move invalidates every feature of its own perspective
+    std::array<bool, Constants::Board::COLOR_COUNT> refresh;
+    DirtyPieces dirty;
+};
+
+// One accumulator per search ply. Pushing only records what the move changes; the arithmetic
+// happens when a ply is evaluated, walking forward from the nearest computed ancestor, so
+// pruned subtrees never pay for it.
+class AccumulatorStack {
+public:
+    // Starts from a new root; both perspectives are rebuilt at the first evaluation
+    auto reset() -> void;
+    // Must be called with the position before `move` is made
+    auto push(const Position& pos, Move move) -> void;
+    auto pushNull() -> void;
+    auto pop() -> void;
+
+    // Brings the top accumulator up to date with `pos`, which must match the pushed moves
+    auto update(const Network& net, const Position& pos) -> const Accumulator&;
+
+private:
+    std::array<Accumulator, Constants::Search::MAX_PLY + 1> m_stack{};
+    std::size_t m_top = 0;
+};
+
+// Evaluation in centipawns from the side to move's point of view
+auto evaluate(const Network& net, const Position& pos, AccumulatorStack& stack) -> int;
+// Same, with both accumulators built from scratch
+auto evaluate(const Network& net, const Position& pos) -> int;
+
+} // namespace Chess::NNUE
+
+#endif // CHESS_NNUE_H
@@ -0,0 +1,41 @@
+#ifndef CHESS_PACKED_H
+#define CHESS_PACKED_H
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "bitboard.h"
+#include "constants.h"
+#include "types.h"
+
+namespace Chess {
+
+// Outcome of the game a training position was taken from
+enum class GameResult : uint8_t { NONE, WHITE_WIN, DRAW, BLACK_WIN };
+
+// Fixed-size position record for training data, written by `Position::pack` and read back by
+// `Position::fromPacked`. Fields are in host byte order, so files move only between machines of
+// the same endianness. Score and result are not part of the position and are filled by callers.
+struct PackedPosition {
+    Bitboard occupancy;
+    // Piece value of each occupied square in ascending square order, low nibble first
+    std::array<uint8_t, Constants::Packed::PIECE_BYTES> pieces;
+    // Bit 0 is set when Black is to move; bits 1 to 4 hold the castling rights
+    uint8_t state;
+    Square en_passant;
+    uint8_t halfmove_clock;
+    GameResult result;
+    uint16_t fullmove_number;
+    // Centipawns from the side to move's point of view, or SCORE_NONE
+    int16_t score;
+};
+
+static_assert(sizeof(PackedPosition) == Constants::Packed::RECORD_SIZE,
+              "packed positions must stay 32 bytes");
+static_assert(std::is_trivially_copyable_v<PackedPosition>,
+              "packed positions are read straight from mapped files");
+
+} // namespace Chess
+
+#endif // CHESS_PACKED_H
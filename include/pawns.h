@@ -0,0 +1,31 @@
+#ifndef CHESS_PAWNS_H
+#define CHESS_PAWNS_H
+
+#include <array>
+
+#include "constants.h"
+#include "evalcache.h"
+#include "position.h"
+#include "psqt.h"
+#include "types.h"
+
+namespace Chess::Pawns {
+
+// Evaluation terms that depend only on pawns and kings, so they can be cached by
+// `Position::pawnKey`: doubled, isolated and passed pawns, and the pawn shield in front of each
+// king. Scores are from White's point of view.
+struct Entry {
+    HashKey key;
+    PSQT::Score score;
+    std::array<Bitboard, Constants::Board::COLOR_COUNT> passed;
+};
+
+// Fills `entry` from scratch
+auto evaluate(const Position& pos, Entry& entry) -> void;
+
+// Pawns and kings rarely move in the search tree, so almost every probe hits
+using Table = EvalCache<Entry, &Position::pawnKey, Constants::Pawns::TABLE_ENTRIES>;
+
+} // namespace Chess::Pawns
+
+#endif // CHESS_PAWNS_H
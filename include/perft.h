@@ -0,0 +1,42 @@
+#ifndef CHESS_PERFT_H
+#define CHESS_PERFT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "position.h"
+#include "types.h"
+
+namespace Chess::Perft {
+
+// Subtree-count cache shared by all perft threads. Slots are written without locks: each one
+// stores `key ^ data` next to `data`, so a slot torn by two racing writers fails verification and
+// reads as a miss instead of returning a wrong count.
+class Table {
+public:
+    explicit Table(std::size_t megabytes);
+
+    [[nodiscard]] auto probe(HashKey key, int depth, std::uint64_t& nodes) const -> bool;
+    auto store(HashKey key, int depth, std::uint64_t nodes) -> void;
+
+private:
+    struct Entry {
+        std::atomic<std::uint64_t> check;
+        std::atomic<std::uint64_t> data;
+    };
+
+    [[nodiscard]] auto slot(HashKey key, int depth) const -> std::size_t;
+
+    std::vector<Entry> m_entries;
+    std::size_t m_mask;
+};
+
+// Leaf nodes at `depth` below `pos`. Depth-1 nodes are bulk-counted from the size of the legal
+// move list, and subtree counts are cached in `table` when one is given.
+auto count(Position& pos, int depth, Table* table = nullptr) -> std::uint64_t;
+
+} // namespace Chess::Perft
+
+#endif // CHESS_PERFT_H
@@ -0,0 +1,63 @@
+#ifndef CHESS_POLYGLOT_H
+#define CHESS_POLYGLOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mappedfile.h"
+#include "move.h"
+#include "position.h"
+#include "types.h"
+
+namespace Chess::Polyglot {
+
+// The position's key in Polyglot books. It uses the standard Random64 table rather than the
+// `Zobrist` keys, and counts an en passant square only when a pawn of the side to move stands
+// next to the double-pushed pawn, legal capture or not.
+auto key(const Position& pos) -> HashKey;
+
+struct BookMove {
+    Move move;
+    uint16_t weight;
+};
+
+// Read-only Polyglot `.bin` opening book. The file is memory-mapped and its 16-byte big-endian
+// records, sorted by key, are found by binary search, so a probe touches a handful of pages
+// however large the book is.
+class Book {
+public:
+    Book() = default;
+    ~Book();
+
+    Book(const Book&) = delete;
+    auto operator=(const Book&) -> Book& = delete;
+    Book(Book&&) = delete;
+    auto operator=(Book&&) -> Book& = delete;
+
+    // Maps `path`, replacing any open book. Fails if it cannot be mapped or does not hold a
+    // whole number of records.
+    [[nodiscard]] auto open(const std::string& path) -> bool;
+    auto close() -> void;
+
+    [[nodiscard]] auto isOpen() const -> bool;
+    [[nodiscard]] auto size() const -> std::size_t;
+
+    // The book's moves for `pos` in file order. Entries that are not legal moves here, as
+    // from a key collision, are left out.
+    auto probe(const Position& pos, std::vector<BookMove>& moves) const -> void;
+    // One of the book's moves chosen with probability proportional to its weight, using
+    // `random` as the source; the null move if the position is not in the book
+    [[nodiscard]] auto pick(const Position& pos, uint64_t random) const -> Move;
+
+private:
+    [[nodiscard]] auto keyAt(std::size_t index) const -> HashKey;
+
+    MappedFile m_file;
+    std::size_t m_size = 0;
+};
+
+} // namespace Chess::Polyglot
+
+#endif // CHESS_POLYGLOT_H
@@ -2,23 +2,81 @@
 #define CHESS_POSITION_H
 
 #include <array>
+#include <cstddef>
 #include <string>
+#include <string_view>
 
+#include "bitboard.h"
 #include "constants.h"
+#include "move.h"
+#include "psqt.h"
 #include "types.h"
 
 namespace Chess {
 
+struct PackedPosition;
+struct PositionSetup;
+
+// Irreversible state saved by `Position::makeMove` so `unmakeMove` can restore it
+struct UndoInfo {
+    HashKey hash;
+    HashKey pawn_key;
+    HashKey material_key;
+    PSQT::Score psqt;
+    int phase;
+    Move move;
+    Piece captured;
+    CastlingRightsBitField castling_rights;
+    Square en_passant_square;
+    uint16_t halfmove_clock;
+};
+
+// Why `Position::fromFen` rejected a FEN
+enum class FenError : uint8_t {
+    NONE,
+    PIECE_PLACEMENT,
+    SIDE_TO_MOVE,
+    CASTLING,
+    EN_PASSANT,
+    MOVE_COUNTERS,
+    KING_COUNT,
+    PIECE_COUNT,
+    PAWN_RANK,
+    OPPONENT_IN_CHECK
+};
+
+auto fenErrorToString(FenError error) -> std::string_view;
+
 class Position {
 public:
     Position();
+    // Lenient: loads like `fromFen` when it can. Otherwise malformed fields fall back to
+    // defaults and nothing is validated, but an en passant square is still kept only when a
+    // pawn could capture on it.
     explicit Position(const std::string& fen);
 
+    // Strict single-pass parse that never allocates or throws, for bulk loading. The move
+    // counters may be omitted. Besides syntax it checks one king per side, pawn ranks, piece
+    // counts reachable by promotion, castling rights against the king and rook squares, en
+    // passant against the pawn that just moved, and that the side not to move is not in check.
+    // An en passant square no pawn can capture on is dropped, as `makeMove` does. The history is
+    // cleared on success; on failure the position is left unchanged.
+    [[nodiscard]] auto fromFen(std::string_view fen) -> FenError;
+    // Loads a record written by `pack`, with the same checks and guarantees as `fromFen`
+    [[nodiscard]] auto fromPacked(const PackedPosition& packed) -> FenError;
+
     [[nodiscard]] auto pieceAt(Square square) const -> Piece;
     [[nodiscard]] auto getPieceBitboard(PieceType type, Color color) const -> Bitboard;
     [[nodiscard]] auto getColorBitboard(Color color) const -> Bitboard;
     [[nodiscard]] auto getOccupiedBitboard() const -> Bitboard;
 
+    // Unchecked inline accessors for move generation and search
+    [[nodiscard]] auto pieces(Color color, PieceType type) const -> Bitboard;
+    [[nodiscard]] auto pieces(PieceType type) const -> Bitboard;
+    [[nodiscard]] auto pieces(Color color) const -> Bitboard;
+    [[nodiscard]] auto occupied() const -> Bitboard;
+    [[nodiscard]] auto kingSquare(Color color) const -> Square;
+
     [[nodiscard]] auto getSideToMove() const -> Color;
     [[nodiscard]] auto hasCastlingRight(CastlingRight right) const -> bool;
     [[nodiscard]] auto getCastlingRights() const -> CastlingRightsBitField;
@@ -27,8 +85,49 @@ public:
     [[nodiscard]] auto getFullmoveNumber() const -> int;
 
     [[nodiscard]] auto hash() const -> HashKey;
+    // The same key recomputed from the board, which the incremental updates must match
+    [[nodiscard]] auto computeHash() const -> HashKey;
+    // Zobrist key of the pawns and kings only, for caching pawn-structure evaluation
+    [[nodiscard]] auto pawnKey() const -> HashKey;
+    // Zobrist key of how many pieces of each kind are on the board, for the material table
+    [[nodiscard]] auto materialKey() const -> HashKey;
+
+    // Material and piece-square sums from White's view, and the game phase. Both are kept
+    // incrementally alongside the hash, so evaluation never scans the board.
+    [[nodiscard]] auto psqt() const -> PSQT::Score;
+    [[nodiscard]] auto phase() const -> int;
+
+    // Moves must be legal. State is updated incrementally, including the hash.
+    auto makeMove(Move move) -> void;
+    auto unmakeMove() -> void;
+    [[nodiscard]] auto lastMove() const -> Move;
+
+    // Passes the turn for null-move pruning; must not be called while in check
+    auto makeNullMove() -> void;
+    auto unmakeNullMove() -> void;
+
+    // Pieces of both colors attacking `square`, with `occupied` as the blocker set
+    [[nodiscard]] auto attackersTo(Square square, Bitboard occupied) const -> Bitboard;
+    // Static exchange evaluation: whether `move` gains at least `threshold` centipawns once the
+    // exchange on its destination is played out with the least valuable attacker each time.
+    // Sliders behind a capturing piece join in as x-rays; pins are ignored.
+    [[nodiscard]] auto see(Move move, int threshold = 0) const -> bool;
+
+    // Enemy pieces giving check to the side to move
+    [[nodiscard]] auto checkers() const -> Bitboard;
+    [[nodiscard]] auto inCheck() const -> bool;
+    // Fifty-move rule, or the position already occurred since the last irreversible move
+    [[nodiscard]] auto isDraw() const -> bool;
 
     [[nodiscard]] auto toFen() const -> std::string;
+    // Allocation-free forms producing the same text. The first writes a terminated string and
+    // returns its length, or 0 if it needs more than `capacity` bytes (MAX_FEN_LENGTH always
+    // suffices); the second reuses the string's capacity.
+    auto toFen(char* out, std::size_t capacity) const -> std::size_t;
+    auto toFen(std::string& out) const -> void;
+    // Fills every field but the score and result, which are left unknown. Fails if the halfmove
+    // clock or fullmove number is too large for the record.
+    [[nodiscard]] auto pack(PackedPosition& out) const -> bool;
 
     auto print() const -> void;
 
@@ -49,15 +148,67 @@ private:
     int m_fullmove_number;
 
     HashKey m_position_hash;
+    HashKey m_pawn_key;
+    HashKey m_material_key;
+    PSQT::Score m_psqt;
+    int m_phase;
+
+    // Ring buffer of undo entries; only the newest HISTORY_SIZE moves can be unmade
+    std::array<UndoInfo, Constants::Game::HISTORY_SIZE> m_history;
+    std::size_t m_history_size;
+
+    auto putPiece(Piece piece, Square square) -> void;
+    auto removePiece(Square square) -> void;
+    auto movePiece(Square from, Square to) -> void;
 
     auto parseFenPiecePlacement(std::istringstream& iss) -> void;
     auto parseFenGameState(std::istringstream& iss) -> void;
-    [[nodiscard]] auto buildFenPiecePlacement() const -> std::string;
-    [[nodiscard]] auto buildFenGameState() const -> std::string;
-
-    [[nodiscard]] auto computeHash() const -> HashKey;
+    // Writes the unterminated FEN into a buffer of MAX_FEN_LENGTH bytes, returning its length
+    auto writeFen(char* buffer) const -> std::size_t;
+
+    // Validates a board assembled by `fromFen` or `fromPacked` and makes it the position
+    auto setUp(PositionSetup& setup) -> FenError;
+
+    // Recomputes every incrementally maintained key and evaluation term from the board
+    auto refreshState() -> void;
+    [[nodiscard]] auto computePawnKey() const -> HashKey;
+    [[nodiscard]] auto computeMaterialKey() const -> HashKey;
+    [[nodiscard]] auto pieceCount(Piece piece) const -> int;
+    // Full recomputes of the incremental evaluation terms, for initialisation and debug checks
+    [[nodiscard]] auto computePsqt() const -> PSQT::Score;
+    [[nodiscard]] auto computePhase() const -> int;
 };
 
+inline auto Position::pieces(Color color, PieceType type) const -> Bitboard
+{
+    return m_piece_bitboards[Util::toIdx(color)][Util::toIdx(type) - 1];
+}
+
+inline auto Position::pieces(PieceType type) const -> Bitboard
+{
+    return pieces(Color::WHITE, type) | pieces(Color::BLACK, type);
+}
+
+inline auto Position::pieces(Color color) const -> Bitboard
+{
+    return m_color_bitboards[Util::toIdx(color)];
+}
+
+inline auto Position::occupied() const -> Bitboard
+{
+    return m_color_bitboards[Util::toIdx(Color::WHITE)] |
+           m_color_bitboards[Util::toIdx(Color::BLACK)];
+}
+
+inline auto Position::psqt() const -> PSQT::Score { return m_psqt; }
+
+inline auto Position::phase() const -> int { return m_phase; }
+
+inline auto Position::kingSquare(Color color) const -> Square
+{
+    return Bitboards::lsb(pieces(color, PieceType::KING));
+}
+
 } // namespace Chess
 
 #endif // CHESS_POSITION_H
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef CHESS_SAN_H
+#define CHESS_SAN_H
+
+#include <string>
+#include <string_view>
+
+#include "move.h"
+#include "position.h"
+
+namespace Chess::San {
+
+// Standard algebraic notation of a legal move, such as "Nbd7", "exd6" or "e8=Q#". Finding the
+// check mark plays the move on a copy of the position, so this is not for hot paths.
+auto format(const Position& pos, Move move) -> std::string;
+
+// The legal move `san` names, or a null move if none or several do. Check marks, annotations
+// such as "!?", an "e.p." suffix with or without a space, "0-0" castling, a promotion without
+// '=' and a needless origin file or rank, as in "Ngf3", are accepted.
+auto parse(const Position& pos, std::string_view san) -> Move;
+
+} // namespace Chess::San
+
+#endif // CHESS_SAN_H
@@ -0,0 +1,177 @@
+#ifndef CHESS_SEARCH_H
+#define CHESS_SEARCH_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "bitbase.h"
+#include "constants.h"
+#include "material.h"
+#include "move.h"
+#include "movepick.h"
+#include "nnue.h"
+#include "pawns.h"
+#include "position.h"
+#include "timeman.h"
+#include "tt.h"
+#include "types.h"
+
+namespace Chess::Search {
+
+struct Limits {
+    int depth = Constants::Search::MAX_PLY - 1;
+    // Zero means no node limit. With several threads it bounds the main thread only.
+    uint64_t nodes = 0;
+    // Zero means no time limit. Like the node limit it bounds the main thread, and is checked
+    // every few thousand nodes.
+    std::chrono::milliseconds movetime{0};
+    // The side to move's clock, budgeted by `Time::Manager` when there is no movetime. Zero
+    // time means no clock; zero moves to go means sudden death.
+    std::chrono::milliseconds time{0};
+    std::chrono::milliseconds increment{0};
+    int moves_to_go = 0;
+    // Search without limits until `ponderhit`; the node and time limits then count from there
+    bool ponder = false;
+};
+
+struct Result {
+    Move best_move{};
+    int score = 0;
+    int depth = 0;
+    int seldepth = 0;
+    uint64_t nodes = 0;
+    MoveList pv;
+};
+
+// Called on the searching thread after each completed iteration
+using Reporter = std::function<void(const Result&)>;
+
+// Iterative-deepening principal variation search with quiescence, null-move pruning and late
+// move reductions. Each searcher works on its own copy of the root position and keeps its own
+// move-ordering tables; only the transposition table is shared.
+class Searcher {
+public:
+    // Searchers with a non-zero id are Lazy SMP helpers and skip some iterations
+    explicit Searcher(TranspositionTable& table, std::size_t id = 0);
+
+    // Evaluates with `network` instead of the piece-square tables; null switches back. The
+    // network must outlive the searches that use it.
+    auto setNetwork(const NNUE::Network* network) -> void;
+    // Probes `bitbases` below the root; null stops probing. Like the network it must outlive
+    // the searches that use it.
+    auto setBitbases(const Bitbases::Set* bitbases) -> void;
+    // Empty means no reports
+    auto setReporter(Reporter reporter) -> void;
+
+    // The caller ages the table with `newSearch` first; `ThreadPool` does this
+    auto search(const Position& root, const Limits& limits) -> Result;
+    // Forgets the move-ordering statistics that `search` otherwise carries over, so the next
+    // search does not depend on the ones before it
+    auto clear() -> void;
+
+    // Safe to call from another thread; the search returns its last completed iteration. A stop
+    // requested before the search starts ends it after depth 1.
+    auto stop() -> void;
+    // Safe to call from another thread: the pondering search switches to its limits
+    auto ponderhit() -> void;
+    // Withdraws a stop or ponderhit that arrived after the search returned, so it cannot affect
+    // the next one. The caller must know no search is running.
+    auto clearSignals() -> void;
+    // Safe to read from another thread while searching
+    [[nodiscard]] auto nodes() const -> uint64_t;
+
+private:
+    auto pvs(int alpha, int beta, int depth, int ply, bool allow_null) -> int;
+    auto quiescence(int alpha, int beta, int ply) -> int;
+    [[nodiscard]] auto shouldStop() -> bool;
+    auto startClock() -> void;
+    [[nodiscard]] auto skipsDepth(int depth) const -> bool;
+    auto countNode() -> void;
+    // Keep the accumulator stack in step with the position
+    auto makeMove(Move move) -> void;
+    auto unmakeMove() -> void;
+    [[nodiscard]] auto evaluate() -> int;
+    auto updatePv(int ply, Move move) -> void;
+    auto updateHistory(Move move, int bonus) -> void;
+    auto updateQuietStats(int ply, Move move) -> void;
+
+    Position m_pos;
+    TranspositionTable& m_table;
+    std::size_t m_id;
+    Limits m_limits;
+    std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_deadline;
+    Time::Manager m_time;
+    // The search has a time limit, and whether it comes from the clock rather than movetime
+    bool m_timed;
+    bool m_clock;
+    // Nodes spent under the current best root move in this iteration
+    uint64_t m_best_move_nodes;
+
+    std::atomic<uint64_t> m_nodes;
+    int m_seldepth;
+    int m_completed_depth;
+    std::atomic<bool> m_stop;
+    std::atomic<bool> m_ponderhit;
+    // Limits are ignored while set; only the searching thread touches it
+    bool m_pondering;
+
+    // Triangular PV table: m_pv[ply] is the best line found from `ply`
+    std::array<MoveList, Constants::Search::MAX_PLY + 1> m_pv;
+
+    HistoryTable m_history{};
+    CounterMoveTable m_counter_moves{};
+    Pawns::Table m_pawns;
+    Material::Table m_material;
+    std::array<Killers, Constants::Search::MAX_PLY + 1> m_killers{};
+
+    const NNUE::Network* m_network = nullptr;
+    NNUE::AccumulatorStack m_accumulators;
+    const Bitbases::Set* m_bitbases = nullptr;
+    // Off when the root is in a table already: every winning move would then score alike, and
+    // the evaluation has to steer the search towards actually converting
+    bool m_probe_bitbases = false;
+    Reporter m_reporter;
+};
+
+// Lazy SMP: every thread runs a full iterative-deepening search on the shared table, and the
+// helpers help by filling the table with results the main thread then finds for free.
+// Helpers stagger their depths so the threads do not all search the same iteration.
+class ThreadPool {
+public:
+    ThreadPool(TranspositionTable& table, std::size_t threads);
+
+    auto resize(std::size_t threads) -> void;
+    [[nodiscard]] auto size() const -> std::size_t;
+    // Applies to every thread, including ones added by a later `resize`
+    auto setNetwork(const NNUE::Network* network) -> void;
+    auto setBitbases(const Bitbases::Set* bitbases) -> void;
+    // Only the main thread reports, with nodes summed over all threads
+    auto setReporter(Reporter reporter) -> void;
+
+    // Blocks until the main thread finishes, then stops the helpers. Returns the main thread's
+    // result with nodes summed over all threads.
+    auto search(const Position& root, const Limits& limits) -> Result;
+    auto stop() -> void;
+    auto ponderhit() -> void;
+    auto clearSignals() -> void;
+
+private:
+    auto attachReporter() -> void;
+
+    TranspositionTable& m_table;
+    std::vector<std::unique_ptr<Searcher>> m_searchers;
+    const NNUE::Network* m_network = nullptr;
+    const Bitbases::Set* m_bitbases = nullptr;
+    Reporter m_reporter;
+};
+
+} // namespace Chess::Search
+
+#endif // CHESS_SEARCH_H
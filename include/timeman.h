@@ -0,0 +1,40 @@
+#ifndef CHESS_TIMEMAN_H
+#define CHESS_TIMEMAN_H
+
+#include <chrono>
+
+#include "move.h"
+
+namespace Chess::Time {
+
+// Spends the side to move's clock. The hard limit ends the search wherever it is; the soft
+// limit is only checked between iterations, and each completed iteration stretches it while
+// the best move keeps changing or the score falls, and shrinks it while one stable move takes
+// most of the nodes.
+class Manager {
+public:
+    // Remaining clock time, increment per move and moves until the next time control, zero
+    // for sudden death
+    auto init(std::chrono::milliseconds time, std::chrono::milliseconds increment,
+              int moves_to_go) -> void;
+    // One completed iteration: its best move and score, and the fraction of its nodes spent
+    // under the best move
+    auto update(Move best_move, int score, double best_move_share) -> void;
+
+    [[nodiscard]] auto softLimit() const -> std::chrono::milliseconds;
+    [[nodiscard]] auto hardLimit() const -> std::chrono::milliseconds;
+
+private:
+    std::chrono::milliseconds m_optimum{0};
+    std::chrono::milliseconds m_maximum{0};
+    double m_scale = 1.0;
+
+    Move m_best_move{};
+    int m_stable_iterations = 0;
+    int m_previous_score = 0;
+    bool m_first_iteration = true;
+};
+
+} // namespace Chess::Time
+
+#endif // CHESS_TIMEMAN_H
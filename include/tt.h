@@ -0,0 +1,77 @@
+#ifndef CHESS_TT_H
+#define CHESS_TT_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "constants.h"
+#include "move.h"
+#include "types.h"
+
+namespace Chess {
+
+enum class Bound : uint8_t { NONE = 0, UPPER = 1, LOWER = 2, EXACT = 3 };
+
+// Decoded contents of a transposition table entry
+struct TTData {
+    Move move;
+    int16_t score;
+    int16_t eval;
+    int depth;
+    Bound bound;
+};
+
+// Shared transposition table. Buckets of four 16-byte entries fill one cache line. Threads access
+// it without locks: each entry stores `key ^ data` next to `data`, so an entry torn by two racing
+// writers no longer verifies against any key and is treated as a miss.
+class TranspositionTable {
+public:
+    TranspositionTable();
+    explicit TranspositionTable(std::size_t megabytes);
+    ~TranspositionTable();
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    auto operator=(const TranspositionTable&) -> TranspositionTable& = delete;
+    TranspositionTable(TranspositionTable&&) = delete;
+    auto operator=(TranspositionTable&&) -> TranspositionTable& = delete;
+
+    // Reallocates to the largest power-of-two bucket count that fits in `megabytes` and clears
+    auto resize(std::size_t megabytes) -> void;
+    auto clear() -> void;
+    // Ages every existing entry by one search so it loses replacement priority
+    auto newSearch() -> void;
+
+    [[nodiscard]] auto probe(HashKey key, TTData& data) const -> bool;
+    auto store(HashKey key, Move move, int score, int eval, int depth, Bound bound) -> void;
+    auto prefetch(HashKey key) const -> void;
+
+    // Per mille of sampled entries written during the current search
+    [[nodiscard]] auto hashfull() const -> int;
+    [[nodiscard]] auto sizeInBytes() const -> std::size_t;
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+
+    struct alignas(Constants::TT::CACHE_LINE_SIZE) Bucket {
+        std::array<Entry, Constants::TT::ENTRIES_PER_BUCKET> entries;
+    };
+
+    static_assert(sizeof(Entry) == 16);
+    static_assert(sizeof(Bucket) == Constants::TT::CACHE_LINE_SIZE);
+
+    [[nodiscard]] auto bucket(HashKey key) const -> Bucket&;
+    auto release() -> void;
+
+    Bucket* m_buckets;
+    std::size_t m_bucket_count;
+    uint8_t m_generation;
+};
+
+} // namespace Chess
+
+#endif // CHESS_TT_H
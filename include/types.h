@@ -4,6 +4,8 @@
 #include <cstdint>
 #include <string>
 
+#include "constants.h"
+
 namespace Chess {
 
 using Bitboard = uint64_t;
@@ -58,16 +60,51 @@ constexpr auto fromIdx(std::underlying_type_t<EnumType> value) -> EnumType
     return static_cast<EnumType>(value);
 }
 
-auto getPieceColor(Piece piece) -> Color;
-auto getPieceType(Piece piece) -> PieceType;
-auto makePiece(PieceType type, Color color) -> Piece;
+// Piece helpers are inline; make/unmake calls them for every piece it touches
+constexpr auto getPieceColor(Piece piece) -> Color
+{
+    if (piece == Piece::NONE) { return Color::NONE; }
+    return fromIdx<Color>(toIdx(piece) / Constants::PIECE_COLOR_OFFSET);
+}
+
+constexpr auto getPieceType(Piece piece) -> PieceType
+{
+    if (piece == Piece::NONE) { return PieceType::NONE; }
+    return fromIdx<PieceType>(toIdx(piece) % Constants::PIECE_COLOR_OFFSET);
+}
+
+constexpr auto makePiece(PieceType type, Color color) -> Piece
+{
+    if (type == PieceType::NONE) { return Piece::NONE; }
+    if (color == Color::NONE) { return Piece::NONE; }
+
+    return fromIdx<Piece>(toIdx(type) + (toIdx(color) * Constants::PIECE_COLOR_OFFSET));
+}
 
 auto squareToString(Square square) -> std::string;
 auto stringToSquare(const std::string& str) -> Square;
 
-auto getFile(Square square) -> int;
-auto getRank(Square square) -> int;
-auto makeSquare(int file, int rank) -> Square;
+// Square arithmetic is constexpr so the bitboard tables can be generated at compile time
+constexpr auto getFile(Square square) -> int
+{
+    if (square == Square::NONE) { return Constants::Board::NO_SQUARE; }
+    return toIdx(square) % Constants::Board::LENGTH;
+}
+
+constexpr auto getRank(Square square) -> int
+{
+    if (square == Square::NONE) { return Constants::Board::NO_SQUARE; }
+    return toIdx(square) / Constants::Board::LENGTH;
+}
+
+constexpr auto makeSquare(int file, int rank) -> Square
+{
+    if (file < 0 || file > Constants::Board::LENGTH - 1 || rank < 0 ||
+        rank > Constants::Board::LENGTH - 1) {
+        return Square::NONE;
+    }
+    return fromIdx<Square>((rank * Constants::Board::LENGTH) + file);
+}
 
 auto pieceToChar(Piece piece) -> char;
 auto charToPiece(char chr) -> Piece;
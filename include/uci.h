@@ -0,0 +1,109 @@
+#ifndef CHESS_UCI_H
+#define CHESS_UCI_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "bitbase.h"
+#include "nnue.h"
+#include "polyglot.h"
+#include "position.h"
+#include "search.h"
+#include "tt.h"
+
+namespace Chess::Uci {
+
+// UCI protocol front end. The thread calling `loop` or `execute` reads commands and answers
+// the quick ones itself; searches run on a dedicated search thread, so `stop`, `ponderhit` and
+// `isready` are handled while one is in progress; a `go` sent then is refused rather than
+// waited on, and options that change what the search uses take effect once it is done. Output
+// lines are written whole and flushed.
+class Engine {
+public:
+    explicit Engine(std::ostream& out);
+    ~Engine();
+
+    Engine(const Engine&) = delete;
+    auto operator=(const Engine&) -> Engine& = delete;
+    Engine(Engine&&) = delete;
+    auto operator=(Engine&&) -> Engine& = delete;
+
+    // Reads commands until "quit" or the end of input, then stops any search
+    auto loop(std::istream& in) -> void;
+    // Handles one command line; false once it was "quit"
+    auto execute(std::string_view line) -> bool;
+    // Blocks until the search thread is idle, after it has printed any best move
+    auto waitForSearch() -> void;
+
+private:
+    auto position(std::string_view args) -> void;
+    auto go(std::string_view args) -> void;
+    auto setOption(std::string_view args) -> void;
+    auto stop() -> void;
+    auto ponderhit() -> void;
+
+    // Runs `action` now, or on the search thread once the current search has reported
+    auto whenIdle(std::function<void()> action) -> void;
+    auto searchLoop() -> void;
+    [[nodiscard]] auto infoLine(const Search::Result& result,
+                                std::chrono::milliseconds elapsed) const -> std::string;
+    auto report(const Search::Result& result, std::chrono::milliseconds elapsed) -> void;
+    auto send(std::string_view line) -> void;
+
+    std::ostream& m_out;
+    std::mutex m_output;
+
+    TranspositionTable m_table;
+    Search::ThreadPool m_pool;
+
+    // Probed at the root when OwnBook is on; the generator picks among weighted book moves
+    Polyglot::Book m_book;
+    bool m_own_book = false;
+    std::mt19937_64 m_random{std::random_device{}()};
+
+    // Loaded from the BitbasePath directory and probed by every search thread
+    Bitbases::Set m_bitbases;
+
+    // Loaded from EvalFile and shared by every search thread; none means the classical eval
+    std::unique_ptr<NNUE::Network> m_network;
+
+    // The position of the last `position` command, and what it was built from so the next one
+    // only has to play the moves added since
+    Position m_pos;
+    std::string m_base;
+    std::string m_moves;
+
+    // Handshake with the search thread, all guarded by m_mutex. `m_searching` is set only while
+    // the pool is inside `search`, so signals are forwarded to it only then.
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    Position m_root;
+    Search::Limits m_limits;
+    bool m_infinite = false;
+    bool m_pending = false;
+    bool m_busy = false;
+    bool m_searching = false;
+    bool m_stop_requested = false;
+    bool m_ponderhit_received = false;
+    bool m_quit = false;
+    std::vector<std::function<void()>> m_deferred;
+
+    // When the current search started; only the search thread touches it
+    std::chrono::steady_clock::time_point m_search_start;
+
+    std::thread m_search_thread;
+};
+
+} // namespace Chess::Uci
+
+#endif // CHESS_UCI_H
@@ -15,6 +15,9 @@ public:
     static auto getSideToMoveKey() -> HashKey;
     static auto getCastlingKey(CastlingRightsBitField rights) -> HashKey;
     static auto getEnPassantKey(Square square) -> HashKey;
+    // Key for having at least `count + 1` of `piece`; a material key XORs one per piece owned.
+    // Zero from MAX_PIECES_PER_TYPE on, so surplus pieces add nothing.
+    static auto getMaterialKey(Piece piece, int count) -> HashKey;
 
 private:
     static std::array<std::array<HashKey, Constants::Board::SQUARE_COUNT>,
@@ -23,6 +26,9 @@ private:
     static HashKey side_to_move_key;
     static std::array<HashKey, Constants::Zobrist::CASTLING_COMBINATIONS> castling_keys;
     static std::array<HashKey, Constants::Board::SQUARE_COUNT_WITH_EMPTY> en_passant_keys;
+    static std::array<std::array<HashKey, Constants::Zobrist::MAX_PIECES_PER_TYPE>,
+                      Constants::Zobrist::PIECE_COUNT>
+        material_keys;
 };
 
 } // namespace Chess
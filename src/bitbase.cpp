@@ -0,0 +1,776 @@
+#include "bitbase.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "bitboard.h"
+
+namespace Chess::Bitbases {
+
+using namespace Util;
+
+namespace {
+
+constexpr int MAX_PIECES = Constants::Bitbase::MAX_PIECES;
+constexpr int SQUARES = Constants::Board::SQUARE_COUNT;
+constexpr int LENGTH = Constants::Board::LENGTH;
+constexpr int HALF = LENGTH / 2;
+// XOR masks mirroring a square index left-right and top-bottom
+constexpr int FILE_FLIP = LENGTH - 1;
+constexpr int RANK_FLIP = SQUARES - LENGTH;
+
+constexpr uint32_t FILE_MAGIC = 0x42424344; // "DCBB"
+constexpr uint32_t FILE_VERSION = 1;
+constexpr std::size_t NAME_LENGTH = 8;
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    std::array<char, NAME_LENGTH> name;
+    uint64_t entries;
+    uint64_t reserved;
+};
+
+constexpr std::size_t VALUES_PER_BYTE = 4;
+constexpr unsigned int VALUE_BITS = 2;
+
+// The stored codes, then two more used only while generating: positions not solved yet, and
+// ones that cannot arise. Illegal positions are stored with the fourth code.
+constexpr uint8_t DRAW = 0;
+constexpr uint8_t WIN = 1;
+constexpr uint8_t LOSS = 2;
+constexpr uint8_t ILLEGAL = 3;
+constexpr uint8_t UNKNOWN = 4;
+
+// Indices handed to a worker at a time
+constexpr std::size_t CHUNK_SIZE = 4096;
+
+constexpr int PIECE_KINDS = 5;
+constexpr std::array<PieceType, PIECE_KINDS> PIECE_ORDER = {
+    PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT, PieceType::PAWN};
+constexpr std::array<char, PIECE_KINDS> PIECE_LETTERS = {'Q', 'R', 'B', 'N', 'P'};
+constexpr std::array<PieceType, 4> PROMOTIONS = {PieceType::QUEEN, PieceType::ROOK,
+                                                 PieceType::BISHOP, PieceType::KNIGHT};
+
+auto orderOf(PieceType type) -> int
+{
+    return static_cast<int>(std::find(PIECE_ORDER.begin(), PIECE_ORDER.end(), type) -
+                            PIECE_ORDER.begin());
+}
+
+// White's pieces before Black's, each side's in PIECE_ORDER
+auto sortKey(Piece piece) -> int
+{
+    return (toIdx(getPieceColor(piece)) * PIECE_KINDS) + orderOf(getPieceType(piece));
+}
+
+constexpr auto opponent(Color color) -> Color
+{
+    return color == Color::WHITE ? Color::BLACK : Color::WHITE;
+}
+
+// The squares the white king is reduced to, and each square's position among them
+struct KingRegion {
+    std::array<int, SQUARES> index;
+    std::array<Square, SQUARES> squares;
+    int size;
+};
+
+// With pawns only the left half of the board; without, the a1-d1-d4 triangle
+constexpr auto makeRegion(bool pawns) -> KingRegion
+{
+    KingRegion region{};
+    for (int square = 0; square < SQUARES; ++square) {
+        const int FILE = square % LENGTH;
+        const int RANK = square / LENGTH;
+        region.index[square] = -1;
+        if (FILE < HALF && (pawns || RANK <= FILE)) {
+            region.index[square] = region.size;
+            region.squares[region.size++] = fromIdx<Square>(static_cast<uint8_t>(square));
+        }
+    }
+    return region;
+}
+
+constexpr KingRegion PAWN_REGION = makeRegion(true);
+constexpr KingRegion PAWNLESS_REGION = makeRegion(false);
+
+auto hasPawns(const Signature& signature) -> bool
+{
+    return std::any_of(signature.pieces.begin(), signature.pieces.begin() + signature.count,
+                       [](Piece piece) { return getPieceType(piece) == PieceType::PAWN; });
+}
+
+auto regionFor(const Signature& signature) -> const KingRegion&
+{
+    return hasPawns(signature) ? PAWN_REGION : PAWNLESS_REGION;
+}
+
+auto sortSignature(Signature& signature) -> void
+{
+    for (int i = 1; i < signature.count; ++i) {
+        for (int j = i; j > 0 && sortKey(signature.pieces[j]) < sortKey(signature.pieces[j - 1]);
+             --j) {
+            std::swap(signature.pieces[j], signature.pieces[j - 1]);
+        }
+    }
+}
+
+auto removePiece(Signature signature, int index) -> Signature
+{
+    std::copy(signature.pieces.begin() + index + 1, signature.pieces.begin() + signature.count,
+              signature.pieces.begin() + index);
+    --signature.count;
+    return signature;
+}
+
+// Bare kings, or a lone knight or bishop: nobody can ever mate
+auto isTrivialDraw(const Signature& signature) -> bool
+{
+    if (signature.count == 0) { return true; }
+    const PieceType TYPE = getPieceType(signature.pieces[0]);
+    return signature.count == 1 && (TYPE == PieceType::KNIGHT || TYPE == PieceType::BISHOP);
+}
+
+// A position with at most MAX_PIECES pieces: the white king, the black king, then the rest
+struct Board {
+    std::array<Square, MAX_PIECES> squares{};
+    std::array<Piece, MAX_PIECES> pieces{};
+    int count = 2;
+    Color side = Color::WHITE;
+};
+
+auto kingSquare(const Board& board, Color color) -> Square { return board.squares[toIdx(color)]; }
+
+auto occupancy(const Board& board) -> Bitboard
+{
+    Bitboard occupied = 0;
+    for (int i = 0; i < board.count; ++i) { setBit(occupied, board.squares[i]); }
+    return occupied;
+}
+
+auto attacksFrom(Piece piece, Square square, Bitboard occupied) -> Bitboard
+{
+    switch (getPieceType(piece)) {
+        case PieceType::PAWN: return Bitboards::pawnAttacks(getPieceColor(piece), square);
+        case PieceType::KNIGHT: return Bitboards::knightAttacks(square);
+        case PieceType::BISHOP: return Bitboards::bishopAttacks(square, occupied);
+        case PieceType::ROOK: return Bitboards::rookAttacks(square, occupied);
+        case PieceType::QUEEN: return Bitboards::queenAttacks(square, occupied);
+        default: return Bitboards::kingAttacks(square);
+    }
+}
+
+auto isAttacked(const Board& board, Square target, Color by) -> bool
+{
+    const Bitboard OCCUPIED = occupancy(board);
+    for (int i = 0; i < board.count; ++i) {
+        if (getPieceColor(board.pieces[i]) == by &&
+            testBit(attacksFrom(board.pieces[i], board.squares[i], OCCUPIED), target)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+auto signatureOf(const Board& board) -> Signature
+{
+    Signature signature;
+    signature.count = board.count - 2;
+    std::copy(board.pieces.begin() + 2, board.pieces.begin() + board.count,
+              signature.pieces.begin());
+    return signature;
+}
+
+auto sortPieces(Board& board) -> void
+{
+    for (int i = 3; i < board.count; ++i) {
+        for (int j = i; j > 2 && sortKey(board.pieces[j]) < sortKey(board.pieces[j - 1]); --j) {
+            std::swap(board.pieces[j], board.pieces[j - 1]);
+            std::swap(board.squares[j], board.squares[j - 1]);
+        }
+    }
+}
+
+// The same position with the colours swapped and the board turned upside down
+auto flipColors(Board& board) -> void
+{
+    std::swap(board.squares[0], board.squares[1]);
+    for (int i = 0; i < board.count; ++i) {
+        board.squares[i] =
+            fromIdx<Square>(static_cast<uint8_t>(toIdx(board.squares[i]) ^ RANK_FLIP));
+        if (i >= 2) {
+            board.pieces[i] = makePiece(getPieceType(board.pieces[i]),
+                                        opponent(getPieceColor(board.pieces[i])));
+        }
+    }
+    board.side = opponent(board.side);
+    sortPieces(board);
+}
+
+// The board's pieces must be in the signature's order. The position is first mirrored so the
+// white king lands in its region.
+auto indexOf(const Signature& signature, const Board& board) -> std::size_t
+{
+    const bool PAWNS = hasPawns(signature);
+    const KingRegion& REGION = PAWNS ? PAWN_REGION : PAWNLESS_REGION;
+
+    const int KING = toIdx(board.squares[0]);
+    int flip = KING % LENGTH >= HALF ? FILE_FLIP : 0;
+    if (!PAWNS && KING / LENGTH >= HALF) { flip ^= RANK_FLIP; }
+    const int FLIPPED_KING = KING ^ flip;
+    const bool TRANSPOSE = !PAWNS && FLIPPED_KING / LENGTH > FLIPPED_KING % LENGTH;
+    const auto MAP = [flip, TRANSPOSE](Square square) -> std::size_t {
+        const int SQUARE = toIdx(square) ^ flip;
+        return static_cast<std::size_t>(
+            TRANSPOSE ? ((SQUARE % LENGTH) * LENGTH) + (SQUARE / LENGTH) : SQUARE);
+    };
+
+    std::size_t index = toIdx(board.side);
+    index = (index * REGION.size) + REGION.index[MAP(board.squares[0])];
+    for (int i = 1; i < board.count; ++i) { index = (index * SQUARES) + MAP(board.squares[i]); }
+    return index;
+}
+
+auto decode(const Signature& signature, std::size_t index) -> Board
+{
+    const KingRegion& REGION = regionFor(signature);
+    Board board;
+    board.count = signature.count + 2;
+    board.pieces[0] = Piece::WHITE_KING;
+    board.pieces[1] = Piece::BLACK_KING;
+    std::copy(signature.pieces.begin(), signature.pieces.begin() + signature.count,
+              board.pieces.begin() + 2);
+
+    for (int i = board.count - 1; i >= 1; --i) {
+        board.squares[i] = fromIdx<Square>(static_cast<uint8_t>(index % SQUARES));
+        index /= SQUARES;
+    }
+    board.squares[0] = REGION.squares[index % REGION.size];
+    board.side = fromIdx<Color>(static_cast<uint8_t>(index / REGION.size));
+    return board;
+}
+
+// Pieces on distinct squares, no pawn on a back rank, and the side not to move not in check
+auto isLegal(const Board& board) -> bool
+{
+    if (Bitboards::popCount(occupancy(board)) != board.count) { return false; }
+    for (int i = 2; i < board.count; ++i) {
+        const int RANK = getRank(board.squares[i]);
+        if (getPieceType(board.pieces[i]) == PieceType::PAWN && (RANK == 0 || RANK == LENGTH - 1)) {
+            return false;
+        }
+    }
+    return !isAttacked(board, kingSquare(board, opponent(board.side)), board.side);
+}
+
+auto removePieceAt(Board& board, int index) -> void
+{
+    std::copy(board.squares.begin() + index + 1, board.squares.begin() + board.count,
+              board.squares.begin() + index);
+    std::copy(board.pieces.begin() + index + 1, board.pieces.begin() + board.count,
+              board.pieces.begin() + index);
+    --board.count;
+}
+
+// Calls `visit(child, same_material, passed)` for each legal move until it returns true.
+// `passed` is the square a double push skipped, NONE for every other move. Children keep the
+// parent's piece order, less any captured piece.
+template <typename Visit> auto forEachChild(const Board& board, const Visit& visit) -> void
+{
+    const Color US = board.side;
+    const Bitboard OCCUPIED = occupancy(board);
+    Bitboard own = 0;
+    for (int i = 0; i < board.count; ++i) {
+        if (getPieceColor(board.pieces[i]) == US) { setBit(own, board.squares[i]); }
+    }
+
+    for (int i = 0; i < board.count; ++i) {
+        const Piece PIECE = board.pieces[i];
+        if (getPieceColor(PIECE) != US) { continue; }
+        const Square FROM = board.squares[i];
+        const bool PAWN = getPieceType(PIECE) == PieceType::PAWN;
+
+        Bitboard targets = attacksFrom(PIECE, FROM, OCCUPIED) & ~own;
+        Square double_push = Square::NONE;
+        Square passed = Square::NONE;
+        if (PAWN) {
+            // Pawns never stand on a back rank, so a square ahead always exists
+            const int FORWARD = US == Color::WHITE ? LENGTH : -LENGTH;
+            const int START_RANK = US == Color::WHITE ? 1 : LENGTH - 2;
+            const auto ONE = fromIdx<Square>(static_cast<uint8_t>(toIdx(FROM) + FORWARD));
+            targets &= OCCUPIED;
+            if (!testBit(OCCUPIED, ONE)) {
+                setBit(targets, ONE);
+                const auto TWO = fromIdx<Square>(static_cast<uint8_t>(toIdx(ONE) + FORWARD));
+                if (getRank(FROM) == START_RANK && !testBit(OCCUPIED, TWO)) {
+                    setBit(targets, TWO);
+                    double_push = TWO;
+                    passed = ONE;
+                }
+            }
+        }
+
+        while (targets != 0) {
+            const Square TO = Bitboards::popSquare(targets);
+            Board child = board;
+            child.side = opponent(US);
+            child.squares[i] = TO;
+            int mover = i;
+            bool same_material = true;
+
+            // Kings are never captured: the side not to move is not in check
+            for (int j = 2; j < child.count; ++j) {
+                if (j != mover && child.squares[j] == TO) {
+                    removePieceAt(child, j);
+                    mover -= mover > j ? 1 : 0;
+                    same_material = false;
+                    break;
+                }
+            }
+
+            if (isAttacked(child, kingSquare(child, US), child.side)) { continue; }
+
+            const int RANK = getRank(TO);
+            if (PAWN && (RANK == 0 || RANK == LENGTH - 1)) {
+                for (const PieceType PROMOTION : PROMOTIONS) {
+                    child.pieces[mover] = makePiece(PROMOTION, US);
+                    if (visit(child, false, Square::NONE)) { return; }
+                }
+            }
+            else if (visit(child, same_material, TO == double_push ? passed : Square::NONE)) {
+                return;
+            }
+        }
+    }
+}
+
+// Looks `board` up in whichever table holds its material, in either orientation
+auto probeBoard(const Set& set, Board board) -> Wdl
+{
+    sortPieces(board);
+    Signature signature = signatureOf(board);
+    if (const Table* table = set.find(signature)) {
+        return table->value(indexOf(signature, board));
+    }
+    if (isTrivialDraw(signature)) { return Wdl::DRAW; }
+
+    flipColors(board);
+    signature = signatureOf(board);
+    if (const Table* table = set.find(signature)) {
+        return table->value(indexOf(signature, board));
+    }
+    return isTrivialDraw(signature) ? Wdl::DRAW : Wdl::UNKNOWN;
+}
+
+// The value of `child`, just reached by a double push over `passed`, once its side to move may
+// also take en passant. `value` is its value without that capture, which is how it is stored.
+auto withEnPassant(const Board& child, Square passed, uint8_t value, const Set& known,
+                   std::atomic<bool>& missing) -> uint8_t
+{
+    const Color THEM = child.side;
+    const Color US = opponent(THEM);
+    const Piece CAPTURER = makePiece(PieceType::PAWN, THEM);
+    const int AHEAD = US == Color::WHITE ? LENGTH : -LENGTH;
+    const auto PUSHED = fromIdx<Square>(static_cast<uint8_t>(toIdx(passed) + AHEAD));
+
+    bool any_capture = false;
+    bool capture_draws = false;
+    for (int i = 2; i < child.count; ++i) {
+        if (child.pieces[i] != CAPTURER ||
+            !testBit(Bitboards::pawnAttacks(US, passed), child.squares[i])) {
+            continue;
+        }
+        Board grandchild = child;
+        grandchild.squares[i] = passed;
+        grandchild.side = US;
+        for (int j = 2; j < grandchild.count; ++j) {
+            if (grandchild.squares[j] == PUSHED) {
+                removePieceAt(grandchild, j);
+                break;
+            }
+        }
+        if (isAttacked(grandchild, kingSquare(grandchild, THEM), US)) { continue; }
+
+        any_capture = true;
+        const Wdl WDL = probeBoard(known, grandchild);
+        if (WDL == Wdl::UNKNOWN) {
+            missing.store(true, std::memory_order_relaxed);
+            return UNKNOWN;
+        }
+        if (WDL == Wdl::LOSS) { return WIN; }
+        capture_draws = capture_draws || WDL == Wdl::DRAW;
+    }
+    if (!any_capture) { return value; }
+
+    // A stored mate or stalemate does not count when the capture was the only move
+    bool other_move = false;
+    forEachChild(child, [&other_move](const Board&, bool, Square) {
+        other_move = true;
+        return true;
+    });
+    if (!other_move) { return capture_draws ? DRAW : LOSS; }
+    return value == LOSS && capture_draws ? DRAW : value;
+}
+
+// One pass's verdict on an unsolved position, UNKNOWN if it cannot tell yet
+auto solve(const Signature& signature, const Board& board, const std::atomic<uint8_t>* values,
+           const Set& known, std::atomic<bool>& missing) -> uint8_t
+{
+    bool any_move = false;
+    bool wins = false;
+    bool all_won = true;
+    bool all_known = true;
+
+    forEachChild(board, [&](const Board& child, bool same_material, Square passed) {
+        any_move = true;
+        uint8_t value = UNKNOWN;
+        if (same_material) {
+            value = values[indexOf(signature, child)].load(std::memory_order_relaxed);
+        }
+        else {
+            const Wdl WDL = probeBoard(known, child);
+            if (WDL == Wdl::UNKNOWN) { missing.store(true, std::memory_order_relaxed); }
+            else { value = toIdx(WDL); }
+        }
+        if (passed != Square::NONE) { value = withEnPassant(child, passed, value, known, missing); }
+
+        // Values are for the child's side to move, the opponent
+        wins = value == LOSS;
+        all_won = all_won && value == WIN;
+        all_known = all_known && value != UNKNOWN;
+        return wins;
+    });
+
+    if (wins) { return WIN; }
+    if (!any_move) {
+        return isAttacked(board, kingSquare(board, board.side), opponent(board.side)) ? LOSS
+                                                                                     : DRAW;
+    }
+    if (all_won) { return LOSS; }
+    return all_known ? DRAW : UNKNOWN;
+}
+
+// Runs `body(first, last)` over [0, size) in chunks handed out to `threads` workers
+template <typename Body>
+auto parallelFor(std::size_t size, std::size_t threads, const Body& body) -> void
+{
+    std::atomic<std::size_t> next{0};
+    const auto WORK = [&] {
+        while (true) {
+            const std::size_t FIRST = next.fetch_add(CHUNK_SIZE, std::memory_order_relaxed);
+            if (FIRST >= size) { return; }
+            body(FIRST, std::min(FIRST + CHUNK_SIZE, size));
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < threads; ++i) { workers.emplace_back(WORK); }
+    WORK();
+    for (std::thread& worker : workers) { worker.join(); }
+}
+
+} // namespace
+
+auto Signature::operator==(const Signature& other) const -> bool
+{
+    return count == other.count &&
+           std::equal(pieces.begin(), pieces.begin() + count, other.pieces.begin());
+}
+
+auto parseSignature(std::string_view name, Signature& out) -> bool
+{
+    if (name.size() < 2 || name[0] != 'K') { return false; }
+    const std::size_t SECOND_KING = name.find('K', 1);
+    if (SECOND_KING == std::string_view::npos) { return false; }
+
+    Signature signature;
+    Color color = Color::WHITE;
+    for (std::size_t i = 1; i < name.size(); ++i) {
+        if (i == SECOND_KING) {
+            color = Color::BLACK;
+            continue;
+        }
+        const auto* const LETTER = std::find(PIECE_LETTERS.begin(), PIECE_LETTERS.end(), name[i]);
+        if (LETTER == PIECE_LETTERS.end() ||
+            signature.count == static_cast<int>(signature.pieces.size())) {
+            return false;
+        }
+        signature.pieces[signature.count++] =
+            makePiece(PIECE_ORDER[LETTER - PIECE_LETTERS.begin()], color);
+    }
+
+    sortSignature(signature);
+    out = signature;
+    return true;
+}
+
+auto signatureName(const Signature& signature) -> std::string
+{
+    std::string name = "K";
+    Color color = Color::WHITE;
+    for (int i = 0; i < signature.count; ++i) {
+        if (color == Color::WHITE && getPieceColor(signature.pieces[i]) == Color::BLACK) {
+            name += 'K';
+            color = Color::BLACK;
+        }
+        name += PIECE_LETTERS[orderOf(getPieceType(signature.pieces[i]))];
+    }
+    if (color == Color::WHITE) { name += 'K'; }
+    return name;
+}
+
+auto flipped(const Signature& signature) -> Signature
+{
+    Signature result = signature;
+    for (int i = 0; i < result.count; ++i) {
+        result.pieces[i] =
+            makePiece(getPieceType(result.pieces[i]), opponent(getPieceColor(result.pieces[i])));
+    }
+    sortSignature(result);
+    return result;
+}
+
+auto canonical(const Signature& signature) -> Signature
+{
+    // Each side's pieces as ranks in PIECE_ORDER, strongest first; lower ranks are stronger
+    std::vector<int> white;
+    std::vector<int> black;
+    for (int i = 0; i < signature.count; ++i) {
+        const int RANK = orderOf(getPieceType(signature.pieces[i]));
+        (getPieceColor(signature.pieces[i]) == Color::WHITE ? white : black).push_back(RANK);
+    }
+    const bool BLACK_STRONGER =
+        black.size() > white.size() || (black.size() == white.size() && black < white);
+    return BLACK_STRONGER ? flipped(signature) : signature;
+}
+
+auto dependencies(const Signature& signature) -> std::vector<Signature>
+{
+    std::vector<Signature> result;
+    const auto ADD = [&result](Signature next) {
+        sortSignature(next);
+        next = canonical(next);
+        if (!isTrivialDraw(next) && std::find(result.begin(), result.end(), next) == result.end()) {
+            result.push_back(next);
+        }
+    };
+
+    for (int i = 0; i < signature.count; ++i) {
+        const Piece PIECE = signature.pieces[i];
+        ADD(removePiece(signature, i));
+        if (getPieceType(PIECE) != PieceType::PAWN) { continue; }
+
+        // Promotions, quiet or taking any enemy piece
+        for (const PieceType PROMOTION : PROMOTIONS) {
+            Signature promoted = signature;
+            promoted.pieces[i] = makePiece(PROMOTION, getPieceColor(PIECE));
+            ADD(promoted);
+            for (int j = 0; j < signature.count; ++j) {
+                if (getPieceColor(signature.pieces[j]) != getPieceColor(PIECE)) {
+                    ADD(removePiece(promoted, j));
+                }
+            }
+        }
+    }
+    return result;
+}
+
+auto tableSize(const Signature& signature) -> std::size_t
+{
+    std::size_t size = static_cast<std::size_t>(Constants::Board::COLOR_COUNT) *
+                       static_cast<std::size_t>(regionFor(signature).size);
+    for (int i = 0; i <= signature.count; ++i) { size *= SQUARES; }
+    return size;
+}
+
+Table::~Table() { close(); }
+
+auto Table::open(const std::string& path) -> bool
+{
+    close();
+    if (!m_file.open(path, MappedFile::Access::RANDOM)) { return false; }
+
+    const std::size_t BYTES = m_file.size();
+    const auto* header = reinterpret_cast<const FileHeader*>(m_file.data());
+    Signature signature;
+    const bool VALID =
+        BYTES >= sizeof(FileHeader) && header->magic == FILE_MAGIC &&
+        header->version == FILE_VERSION &&
+        parseSignature(std::string_view(header->name.data(),
+                                        ::strnlen(header->name.data(), NAME_LENGTH)),
+                       signature) &&
+        header->entries == tableSize(signature) &&
+        BYTES == sizeof(FileHeader) + ((header->entries + VALUES_PER_BYTE - 1) / VALUES_PER_BYTE);
+    if (!VALID) {
+        m_file.close();
+        return false;
+    }
+
+    m_values = reinterpret_cast<const uint8_t*>(header + 1);
+    m_signature = signature;
+    m_size = header->entries;
+    return true;
+}
+
+auto Table::assign(const Signature& signature, std::vector<uint8_t> packed) -> void
+{
+    close();
+    m_owned = std::move(packed);
+    m_values = m_owned.data();
+    m_signature = signature;
+    m_size = tableSize(signature);
+}
+
+auto Table::save(const std::string& path) const -> bool
+{
+    FileHeader header{FILE_MAGIC, FILE_VERSION, {}, m_size, 0};
+    const std::string NAME = signatureName(m_signature);
+    std::copy(NAME.begin(), NAME.end(), header.name.begin());
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(m_values),
+               static_cast<std::streamsize>((m_size + VALUES_PER_BYTE - 1) / VALUES_PER_BYTE));
+    file.close();
+    return static_cast<bool>(file);
+}
+
+auto Table::signature() const -> const Signature& { return m_signature; }
+
+auto Table::size() const -> std::size_t { return m_size; }
+
+auto Table::close() -> void
+{
+    m_file.close();
+    m_owned.clear();
+    m_values = nullptr;
+    m_signature = Signature();
+    m_size = 0;
+}
+
+auto Set::load(const std::string& directory) -> std::size_t
+{
+    std::size_t loaded = 0;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (entry.path().extension() != ".bb") { continue; }
+        auto table = std::make_unique<Table>();
+        if (table->open(entry.path().string())) {
+            add(std::move(table));
+            ++loaded;
+        }
+    }
+    return loaded;
+}
+
+auto Set::add(std::unique_ptr<Table> table) -> void
+{
+    m_max_pieces = std::max(m_max_pieces, table->signature().count + 2);
+    for (auto& existing : m_tables) {
+        if (existing->signature() == table->signature()) {
+            existing = std::move(table);
+            return;
+        }
+    }
+    m_tables.push_back(std::move(table));
+}
+
+auto Set::clear() -> void
+{
+    m_tables.clear();
+    m_max_pieces = 0;
+}
+
+auto Set::find(const Signature& signature) const -> const Table*
+{
+    for (const auto& table : m_tables) {
+        if (table->signature() == signature) { return table.get(); }
+    }
+    return nullptr;
+}
+
+auto Set::size() const -> std::size_t { return m_tables.size(); }
+
+auto Set::maxPieces() const -> int { return m_max_pieces; }
+
+auto Set::probe(const Position& pos) const -> Wdl
+{
+    if (Bitboards::popCount(pos.occupied()) > m_max_pieces || pos.getCastlingRights() != 0 ||
+        pos.getEnPassantSquare() != Square::NONE) {
+        return Wdl::UNKNOWN;
+    }
+
+    Board board;
+    board.squares[0] = pos.kingSquare(Color::WHITE);
+    board.squares[1] = pos.kingSquare(Color::BLACK);
+    board.pieces[0] = Piece::WHITE_KING;
+    board.pieces[1] = Piece::BLACK_KING;
+    board.side = pos.getSideToMove();
+    for (const Color COLOR : {Color::WHITE, Color::BLACK}) {
+        for (const PieceType TYPE : PIECE_ORDER) {
+            Bitboard pieces = pos.pieces(COLOR, TYPE);
+            while (pieces != 0) {
+                board.squares[board.count] = Bitboards::popSquare(pieces);
+                board.pieces[board.count++] = makePiece(TYPE, COLOR);
+            }
+        }
+    }
+    return probeBoard(*this, board);
+}
+
+auto generate(const Signature& signature, const Set& known, std::size_t threads, Table& out)
+    -> bool
+{
+    const std::size_t SIZE = tableSize(signature);
+    const auto values = std::make_unique<std::atomic<uint8_t>[]>(SIZE);
+    std::atomic<bool> missing{false};
+
+    parallelFor(SIZE, threads, [&](std::size_t first, std::size_t last) {
+        for (std::size_t index = first; index < last; ++index) {
+            values[index].store(isLegal(decode(signature, index)) ? UNKNOWN : ILLEGAL,
+                                std::memory_order_relaxed);
+        }
+    });
+
+    // Workers may see values another thread set earlier in the same pass; that only speeds up
+    // convergence, since a value, once set, is final
+    bool changed = true;
+    while (changed && !missing.load(std::memory_order_relaxed)) {
+        std::atomic<bool> progress{false};
+        parallelFor(SIZE, threads, [&](std::size_t first, std::size_t last) {
+            bool solved = false;
+            for (std::size_t index = first; index < last; ++index) {
+                if (values[index].load(std::memory_order_relaxed) != UNKNOWN) { continue; }
+                const uint8_t VALUE =
+                    solve(signature, decode(signature, index), values.get(), known, missing);
+                if (VALUE != UNKNOWN) {
+                    values[index].store(VALUE, std::memory_order_relaxed);
+                    solved = true;
+                }
+            }
+            if (solved) { progress.store(true, std::memory_order_relaxed); }
+        });
+        changed = progress.load(std::memory_order_relaxed);
+    }
+    if (missing.load(std::memory_order_relaxed)) { return false; }
+
+    // Neither side can force anything from what is left
+    std::vector<uint8_t> packed((SIZE + VALUES_PER_BYTE - 1) / VALUES_PER_BYTE, 0);
+    for (std::size_t index = 0; index < SIZE; ++index) {
+        uint8_t value = values[index].load(std::memory_order_relaxed);
+        if (value == UNKNOWN) { value = DRAW; }
+        packed[index / VALUES_PER_BYTE] |=
+            static_cast<uint8_t>(value << ((index % VALUES_PER_BYTE) * VALUE_BITS));
+    }
+    out.assign(signature, std::move(packed));
+    return true;
+}
+
+} // namespace Chess::Bitbases
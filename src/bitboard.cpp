@@ -11,113 +11,164 @@ namespace Chess {
 
 using namespace Util;
 
-std::array<Bitboard, Constants::Board::LENGTH> Bitboards::files;
-std::array<Bitboard, Constants::Board::LENGTH> Bitboards::ranks;
-std::array<Bitboard, Constants::Board::DIAGONAL_COUNT> Bitboards::diagonals;
-std::array<Bitboard, Constants::Board::DIAGONAL_COUNT> Bitboards::anti_diagonals;
-std::array<Bitboard, Constants::Board::SQUARE_COUNT> Bitboards::squares;
-std::array<int, Constants::Board::SQUARE_COUNT> Bitboards::debruijn_lut;
+std::array<Bitboards::Magic, Constants::Board::SQUARE_COUNT> Bitboards::bishop_magics;
+std::array<Bitboards::Magic, Constants::Board::SQUARE_COUNT> Bitboards::rook_magics;
+std::array<Bitboard, Constants::Attacks::BISHOP_TABLE_SIZE> Bitboards::bishop_table;
+std::array<Bitboard, Constants::Attacks::ROOK_TABLE_SIZE> Bitboards::rook_table;
+#if defined(USE_PEXT)
+std::array<Bitboard, Constants::Attacks::BISHOP_TABLE_SIZE> Bitboards::bishop_pext_table;
+std::array<Bitboard, Constants::Attacks::ROOK_TABLE_SIZE> Bitboards::rook_pext_table;
+#endif
 
-auto Bitboards::init() -> void
+namespace {
+
+// Fancy magic numbers for shift = 64 - popcount(mask), found offline with a seeded sparse search
+// clang-format off
+constexpr std::array<Bitboard, Constants::Board::SQUARE_COUNT> BISHOP_MAGIC_NUMBERS = {
+    0x0002100102008200ULL, 0x1068010114010800ULL, 0x4124410417000050ULL, 0x0044040088200010ULL,
+    0x000C50C01201000AULL, 0x0021100250000200ULL, 0x02A4008844500040ULL, 0x1402028404420220ULL,
+    0x0801041002021419ULL, 0x0010040114410200ULL, 0x0000040C04055910ULL, 0x0000040400940002ULL,
+    0x4280040504000862ULL, 0x4000010120522008ULL, 0x0100111808040461ULL, 0x2000008208020200ULL,
+    0x1088800490440804ULL, 0x0410120550022040ULL, 0x802040040903A600ULL, 0x661800A120806001ULL,
+    0x4003000290400088ULL, 0x2016022108022210ULL, 0x2442051412010402ULL, 0x208620020882180CULL,
+    0x405010024BA00108ULL, 0x1004220010020840ULL, 0xC028410608020402ULL, 0x0001080004020420ULL,
+    0x1001010000104000ULL, 0x0008002212008400ULL, 0x2880811002080240ULL, 0x0104504001010800ULL,
+    0x8224444091053000ULL, 0x080C026010020410ULL, 0x4484040A00050208ULL, 0x8982020080080080ULL,
+    0x008C108400A20102ULL, 0x40108C0100149010ULL, 0x800C208400048440ULL, 0x00949109020A0284ULL,
+    0x2000822020111080ULL, 0x8904044104008810ULL, 0x0182101808000400ULL, 0x00400020110A0801ULL,
+    0x0005A00410400408ULL, 0x442002004A002110ULL, 0x0048218802008090ULL, 0x0B08020040509A05ULL,
+    0x4000440208400000ULL, 0x0401820490840610ULL, 0x2010008048081000ULL, 0x0000000042120201ULL,
+    0x50000A1002021080ULL, 0x0000242008024581ULL, 0x1045900408008400ULL, 0x002002020A002112ULL,
+    0x000201208808A800ULL, 0x00601D0101100211ULL, 0x0012008308880440ULL, 0x0100904800420200ULL,
+    0x0009000050A20202ULL, 0xC408102212021E09ULL, 0x200050A101040080ULL, 0x0502101101110200ULL
+};
+
+constexpr std::array<Bitboard, Constants::Board::SQUARE_COUNT> ROOK_MAGIC_NUMBERS = {
+    0x4180002050804008ULL, 0x8440001008200040ULL, 0x0200088020401200ULL, 0x2200060008102040ULL,
+    0x0100040208010010ULL, 0x0900080100040002ULL, 0x0400100084084221ULL, 0x0100022100008B4AULL,
+    0x0008800080401022ULL, 0x40A0804000200080ULL, 0x0883002000C30032ULL, 0x0080800800100082ULL,
+    0x0422002010080600ULL, 0x9012000200085004ULL, 0x2200800100020080ULL, 0x0002000104489412ULL,
+    0x8011010020408000ULL, 0xC392020021008040ULL, 0x0000420010802200ULL, 0x0008090010010020ULL,
+    0xA0F3010004100800ULL, 0x8C01010004000208ULL, 0x1000808001000200ULL, 0x9400020004094097ULL,
+    0x0080004240002000ULL, 0x0000200080400080ULL, 0x1040420200108020ULL, 0x2410080080100081ULL,
+    0x0010040080080080ULL, 0x0015000300280400ULL, 0x0808020400083061ULL, 0x0204140200005091ULL,
+    0x0852204001800880ULL, 0x1120004001802180ULL, 0x0E00200080801002ULL, 0x0C0C204202000811ULL,
+    0x0125001005000800ULL, 0x0802001004040020ULL, 0x1081214804001082ULL, 0x0010210486000044ULL,
+    0x2400208040008005ULL, 0x0150014020024000ULL, 0x0120020400101000ULL, 0x0600210010010008ULL,
+    0x4441000800050010ULL, 0x0004000200808004ULL, 0x0100080142040010ULL, 0x04010144A1020014ULL,
+    0x0008800840002080ULL, 0x0040201000400040ULL, 0x2008102000410100ULL, 0x0284500088008480ULL,
+    0x1200100500080100ULL, 0x0004102040040801ULL, 0x2000110810621400ULL, 0x0400008044210200ULL,
+    0xAA80041042208301ULL, 0x1700110042002082ULL, 0x1005410108200411ULL, 0x0808280C1001A101ULL,
+    0x1182002010040802ULL, 0x800200082110C402ULL, 0x0282000100A44802ULL, 0x000000204409008AULL
+};
+// clang-format on
+
+struct Direction {
+    int file;
+    int rank;
+};
+
+constexpr std::array<Direction, 4> BISHOP_DIRECTIONS = {{{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}};
+constexpr std::array<Direction, 4> ROOK_DIRECTIONS = {{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+
+// Reference ray walk, only used while filling the lookup tables
+auto slidingAttacks(Square square, Bitboard occupied, const std::array<Direction, 4>& directions)
+    -> Bitboard
 {
-    for (int file = 0; file < Constants::Board::LENGTH; ++file) {
-        files.at(file) = 0ULL;
-        UNROLL_LOOP
-        for (int rank = 0; rank < Constants::Board::LENGTH; ++rank) {
-            setBit(files.at(file), makeSquare(file, rank));
-        }
-    }
-
-    for (int rank = 0; rank < Constants::Board::LENGTH; ++rank) {
-        ranks.at(rank) = 0ULL;
-        UNROLL_LOOP
-        for (int file = 0; file < Constants::Board::LENGTH; ++file) {
-            setBit(ranks.at(rank), makeSquare(file, rank));
-        }
-    }
-
-    for (int i = 0; i < Constants::Board::DIAGONAL_COUNT; ++i) {
-        diagonals.at(i) = 0ULL;
-        const int DIAG = i - Constants::Board::DIAGONAL_CENTER;
-        UNROLL_LOOP
-        for (int file = 0; file < Constants::Board::LENGTH; ++file) {
-            const int RANK = file - DIAG;
-            if (RANK >= 0 && RANK < Constants::Board::LENGTH) {
-                setBit(diagonals.at(i), makeSquare(file, RANK));
-            }
-        }
-    }
-
-    for (int i = 0; i < Constants::Board::DIAGONAL_COUNT; ++i) {
-        anti_diagonals.at(i) = 0ULL;
-        const int DIAG = i - Constants::Board::DIAGONAL_CENTER;
-        UNROLL_LOOP
-        for (int file = 0; file < Constants::Board::LENGTH; ++file) {
-            const int RANK = Constants::Board::DIAGONAL_CENTER - file - DIAG;
-            if (RANK >= 0 && RANK < Constants::Board::LENGTH) {
-                setBit(anti_diagonals.at(i), makeSquare(file, RANK));
-            }
+    Bitboard attacks = 0;
+    for (const Direction& dir : directions) {
+        int file = getFile(square) + dir.file;
+        int rank = getRank(square) + dir.rank;
+        Square target = makeSquare(file, rank);
+        while (target != Square::NONE) {
+            setBit(attacks, target);
+            if (testBit(occupied, target)) { break; }
+            file += dir.file;
+            rank += dir.rank;
+            target = makeSquare(file, rank);
         }
     }
-
-    UNROLL_LOOP
-    for (unsigned sq = 0; sq < Constants::Board::SQUARE_COUNT; ++sq) {
-        squares.at(sq) = 1ULL << sq;
-    }
-
-    // clang-format off
-    constexpr std::array<int, Constants::Board::SQUARE_COUNT> INDEX64 = {
-        0,  1,  48, 2,  57, 49, 28, 3,
-        61, 58, 50, 42, 38, 29, 4,  17,
-        62, 55, 59, 36, 53, 51, 43, 22,
-        45, 39, 33, 30, 24, 5,  18, 11,
-        63, 10, 56, 21, 27, 37, 47, 35,
-        54, 52, 15, 32, 23, 14, 44, 20,
-        46, 26, 34, 25, 60, 19, 13, 9, 
-        12, 8,  16, 7,  41, 40, 6,  31
-    };
-    // clang-format on
-    debruijn_lut = INDEX64;
+    return attacks;
 }
 
-auto Bitboards::lsb(Bitboard bitb) -> Square
-{
-    if (bitb == 0) { return Square::NONE; }
-    return fromIdx<Square>(
-        debruijn_lut.at(((bitb & -bitb) * DEBRUIJN_CONSTANT) >> Constants::DEBRUIJN_SHIFT));
-}
+} // namespace
 
-auto Bitboards::msb(Bitboard bitb) -> Square
+auto Bitboards::init() -> void
 {
-    if (bitb == 0) { return Square::NONE; }
-
-    UNROLL_LOOP
-    for (unsigned int i = 0; i < Constants::MSB_RSHIFT_COUNT; ++i) { bitb |= bitb >> (1U << i); }
-    bitb &= ~(bitb >> 1ULL);
-
-    return fromIdx<Square>(
-        debruijn_lut.at((bitb * DEBRUIJN_CONSTANT) >> Constants::DEBRUIJN_SHIFT));
+#if defined(USE_PEXT)
+    initSliders(bishop_magics, BISHOP_MAGIC_NUMBERS, bishop_table.data(), bishop_pext_table.data(),
+                false);
+    initSliders(rook_magics, ROOK_MAGIC_NUMBERS, rook_table.data(), rook_pext_table.data(), true);
+#else
+    initSliders(bishop_magics, BISHOP_MAGIC_NUMBERS, bishop_table.data(), nullptr, false);
+    initSliders(rook_magics, ROOK_MAGIC_NUMBERS, rook_table.data(), nullptr, true);
+#endif
 }
 
-auto Bitboards::popCount(Bitboard bitb) -> int
+// Asks cpuid the same question the loader's resolvers ask
+auto Bitboards::kernels() -> const char*
 {
-#if defined(__GNUC__) || defined(__clang__)
-    return __builtin_popcountll(bitb);
+#if defined(HAS_DISPATCH)
+    return __builtin_cpu_supports("x86-64-v3") != 0 ? "x86-64-v3" : "x86-64";
+#elif defined(HAS_BIT_BUILTINS)
+    return "builtin";
 #else
-    int count = 0;
-    while (b) {
-        b &= b - 1;
-        count++;
-    }
-    return count;
+    return "portable";
 #endif
 }
 
-auto Bitboards::popLsb(Bitboard& bitb) -> Bitboard
+auto Bitboards::initSliders(std::array<Magic, Constants::Board::SQUARE_COUNT>& magics,
+                            const std::array<Bitboard, Constants::Board::SQUARE_COUNT>& numbers,
+                            Bitboard* table,
+                            [[maybe_unused]] Bitboard* pext_table,
+                            bool rook) -> void
 {
-    const Bitboard BITB = bitb;
-    bitb &= (bitb - 1);
-    return BITB & ~bitb;
+    const auto& directions = rook ? ROOK_DIRECTIONS : BISHOP_DIRECTIONS;
+    const Bitboard BOARD_EDGES = files.at(0) | files.at(Constants::Board::LENGTH - 1) |
+                                 ranks.at(0) | ranks.at(Constants::Board::LENGTH - 1);
+
+    std::size_t offset = 0;
+    for (int sq = 0; sq < Constants::Board::SQUARE_COUNT; ++sq) {
+        const auto SQUARE = fromIdx<Square>(sq);
+        const int FILE = getFile(SQUARE);
+        const int RANK = getRank(SQUARE);
+        Magic& entry = magics.at(sq);
+
+        // Relevant occupancy: the square's lines minus the board edges they run into
+        if (rook) {
+            const Bitboard FILE_EDGES = ranks.at(0) | ranks.at(Constants::Board::LENGTH - 1);
+            const Bitboard RANK_EDGES = files.at(0) | files.at(Constants::Board::LENGTH - 1);
+            entry.mask = (files.at(FILE) & ~FILE_EDGES) | (ranks.at(RANK) & ~RANK_EDGES);
+        }
+        else {
+            const int DIAGONAL = FILE - RANK + Constants::Board::DIAGONAL_CENTER;
+            const int ANTI_DIAGONAL = (2 * Constants::Board::DIAGONAL_CENTER) - FILE - RANK;
+            entry.mask =
+                (diagonals.at(DIAGONAL) | anti_diagonals.at(ANTI_DIAGONAL)) & ~BOARD_EDGES;
+        }
+        entry.mask &= ~squares.at(sq);
+
+        const int BITS = popCount(entry.mask);
+        entry.magic = numbers.at(sq);
+        entry.shift = static_cast<unsigned int>(Constants::Board::SQUARE_COUNT - BITS);
+        entry.attacks = table + offset;
+#if defined(USE_PEXT)
+        entry.pext_attacks = pext_table + offset;
+#endif
+
+        // Carry-Rippler walk over every subset of the mask
+        Bitboard occupied = 0;
+        do {
+            const Bitboard ATTACKS = slidingAttacks(SQUARE, occupied, directions);
+            entry.attacks[((occupied & entry.mask) * entry.magic) >> entry.shift] = ATTACKS;
+#if defined(USE_PEXT)
+            entry.pext_attacks[_pext_u64(occupied, entry.mask)] = ATTACKS;
+#endif
+            occupied = (occupied - entry.mask) & entry.mask;
+        } while (occupied != 0);
+
+        offset += std::size_t{1} << static_cast<unsigned int>(BITS);
+    }
 }
 
 void Bitboards::print(Bitboard bitb)
@@ -0,0 +1,121 @@
+#include "dataset.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <utility>
+
+#include "constants.h"
+
+namespace Chess {
+
+namespace {
+
+constexpr uint32_t FILE_MAGIC = 0x44504344; // "DCPD"
+constexpr uint32_t FILE_VERSION = 1;
+
+// Padded to one record so the records after it stay aligned in the mapping
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    std::array<uint32_t, 5> reserved;
+};
+
+static_assert(sizeof(FileHeader) == sizeof(PackedPosition), "header must fill one record");
+
+constexpr FileHeader EXPECTED_HEADER = {
+    FILE_MAGIC, FILE_VERSION, Constants::Packed::RECORD_SIZE, {}};
+
+} // namespace
+
+Dataset::~Dataset() { close(); }
+
+Dataset::Dataset(Dataset&& other) noexcept
+    : m_file(std::move(other.m_file)), m_records(std::exchange(other.m_records, nullptr)),
+      m_size(std::exchange(other.m_size, 0))
+{
+}
+
+auto Dataset::operator=(Dataset&& other) noexcept -> Dataset&
+{
+    if (this != &other) {
+        m_file = std::move(other.m_file);
+        m_records = std::exchange(other.m_records, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+auto Dataset::open(const std::string& path, Access access) -> bool
+{
+    close();
+    if (!m_file.open(path, access)) { return false; }
+
+    const std::size_t BYTES = m_file.size();
+    const auto* header = reinterpret_cast<const FileHeader*>(m_file.data());
+    if (BYTES < sizeof(FileHeader) || (BYTES - sizeof(FileHeader)) % sizeof(PackedPosition) != 0 ||
+        header->magic != EXPECTED_HEADER.magic || header->version != EXPECTED_HEADER.version ||
+        header->record_size != EXPECTED_HEADER.record_size) {
+        m_file.close();
+        return false;
+    }
+
+    m_records = reinterpret_cast<const PackedPosition*>(header + 1);
+    m_size = (BYTES - sizeof(FileHeader)) / sizeof(PackedPosition);
+    return true;
+}
+
+auto Dataset::close() -> void
+{
+    m_file.close();
+    m_records = nullptr;
+    m_size = 0;
+}
+
+DatasetReader::DatasetReader(const Dataset& dataset) : DatasetReader(dataset, 0, dataset.size())
+{
+}
+
+DatasetReader::DatasetReader(const Dataset& dataset, std::size_t first, std::size_t last)
+    : m_next(dataset.begin() + std::min({first, last, dataset.size()})),
+      m_end(dataset.begin() + std::min(last, dataset.size()))
+{
+    assert(first <= dataset.size() && "reader range starts past the end of the dataset");
+}
+
+auto DatasetReader::record() const -> const PackedPosition&
+{
+    assert(m_current != nullptr && "no record has been read yet");
+    return *m_current;
+}
+
+auto DatasetReader::skipped() const -> std::size_t { return m_skipped; }
+
+auto DatasetWriter::open(const std::string& path) -> bool
+{
+    m_file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+    m_size = 0;
+    if (!m_file) { return false; }
+
+    m_file.write(reinterpret_cast<const char*>(&EXPECTED_HEADER), sizeof(EXPECTED_HEADER));
+    return static_cast<bool>(m_file);
+}
+
+auto DatasetWriter::write(const PackedPosition& record) -> bool
+{
+    m_file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    if (!m_file) { return false; }
+    ++m_size;
+    return true;
+}
+
+auto DatasetWriter::close() -> bool
+{
+    m_file.close();
+    return !m_file.fail();
+}
+
+auto DatasetWriter::size() const -> std::size_t { return m_size; }
+
+} // namespace Chess
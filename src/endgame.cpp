@@ -0,0 +1,143 @@
+#include "endgame.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "bitboard.h"
+#include "constants.h"
+#include "eval.h"
+
+namespace Chess::Endgames {
+
+using namespace Util;
+
+namespace {
+
+constexpr int LENGTH = Constants::Board::LENGTH;
+constexpr int LAST_RANK = Constants::Board::MAX_RANK;
+constexpr int KNOWN_WIN = Constants::Eval::KNOWN_WIN;
+
+// Bonuses per step of the weak king away from the centre or towards a mating corner, and per
+// step the kings are closer than the width of the board
+constexpr int PUSH_TO_EDGE = 20;
+constexpr int PUSH_TO_CORNER = 40;
+constexpr int PUSH_CLOSE = 10;
+// Bonus per rank a lone pawn has advanced
+constexpr int PAWN_RANK_BONUS = 20;
+
+constexpr auto opponent(Color color) -> Color
+{
+    return color == Color::WHITE ? Color::BLACK : Color::WHITE;
+}
+
+auto distance(Square lhs, Square rhs) -> int
+{
+    return std::max(std::abs(getFile(lhs) - getFile(rhs)), std::abs(getRank(lhs) - getRank(rhs)));
+}
+
+// 0 on the four centre squares up to 6 in the corners
+auto centerDistance(Square square) -> int
+{
+    constexpr int HIGH_CENTER = LENGTH / 2;
+    constexpr int LOW_CENTER = HIGH_CENTER - 1;
+    return std::max(LOW_CENTER - getFile(square), getFile(square) - HIGH_CENTER) +
+           std::max(LOW_CENTER - getRank(square), getRank(square) - HIGH_CENTER);
+}
+
+// The same square seen from `color`'s side of the board, so its pawns always move up
+auto relativeSquare(Color color, Square square) -> Square
+{
+    constexpr uint8_t RANK_FLIP = Constants::Board::SQUARE_COUNT - LENGTH;
+    return color == Color::WHITE ? square : fromIdx<Square>(toIdx(square) ^ RANK_FLIP);
+}
+
+auto nonPawnMaterial(const Position& pos, Color color) -> int
+{
+    int material = 0;
+    for (uint8_t type = toIdx(PieceType::KNIGHT); type < toIdx(PieceType::KING); ++type) {
+        const auto PIECE_TYPE = fromIdx<PieceType>(type);
+        material +=
+            Eval::pieceValue(PIECE_TYPE) * Bitboards::popCount(pos.pieces(color, PIECE_TYPE));
+    }
+    return material;
+}
+
+} // namespace
+
+auto kxk(const Position& pos, Color strong) -> int
+{
+    const Square STRONG_KING = pos.kingSquare(strong);
+    const Square WEAK_KING = pos.kingSquare(opponent(strong));
+
+    return KNOWN_WIN + nonPawnMaterial(pos, strong) +
+           (Eval::pieceValue(PieceType::PAWN) *
+            Bitboards::popCount(pos.pieces(strong, PieceType::PAWN))) +
+           (PUSH_TO_EDGE * centerDistance(WEAK_KING)) +
+           (PUSH_CLOSE * (LENGTH - 1 - distance(STRONG_KING, WEAK_KING)));
+}
+
+auto kbnk(const Position& pos, Color strong) -> int
+{
+    const Square STRONG_KING = pos.kingSquare(strong);
+    const Square WEAK_KING = pos.kingSquare(opponent(strong));
+    const Square BISHOP = Bitboards::lsb(pos.pieces(strong, PieceType::BISHOP));
+
+    // Mate is only possible in the two corners the bishop can cover; a1 is a dark square
+    const bool DARK_BISHOP = (getFile(BISHOP) + getRank(BISHOP)) % 2 == 0;
+    const int CORNER_DISTANCE =
+        DARK_BISHOP ? std::min(distance(WEAK_KING, Square::A1), distance(WEAK_KING, Square::H8))
+                    : std::min(distance(WEAK_KING, Square::A8), distance(WEAK_KING, Square::H1));
+
+    return KNOWN_WIN + Eval::pieceValue(PieceType::KNIGHT) + Eval::pieceValue(PieceType::BISHOP) +
+           (PUSH_TO_CORNER * (LENGTH - 1 - CORNER_DISTANCE)) +
+           (PUSH_CLOSE * (LENGTH - 1 - distance(STRONG_KING, WEAK_KING)));
+}
+
+auto kpk(const Position& pos, Color strong) -> int
+{
+    const Square PAWN = relativeSquare(strong, Bitboards::lsb(pos.pieces(strong, PieceType::PAWN)));
+    const Square STRONG_KING = relativeSquare(strong, pos.kingSquare(strong));
+    const Square WEAK_KING = relativeSquare(strong, pos.kingSquare(opponent(strong)));
+    const bool STRONG_TO_MOVE = pos.getSideToMove() == strong;
+
+    const int FILE = getFile(PAWN);
+    const int RANK = getRank(PAWN);
+    const Square PROMOTION = makeSquare(FILE, LAST_RANK);
+    const int SCORE = Eval::pieceValue(PieceType::PAWN) + (PAWN_RANK_BONUS * RANK);
+
+    // Rule of the square: the pawn runs home unless the weak king reaches the promotion square
+    // in time. A pawn on its starting rank gains a step from the double push.
+    const int STEPS = LAST_RANK - RANK - (RANK == 1 ? 1 : 0);
+    const bool BLOCKED_BY_OWN_KING = getFile(STRONG_KING) == FILE && getRank(STRONG_KING) > RANK;
+    if (!BLOCKED_BY_OWN_KING &&
+        distance(WEAK_KING, PROMOTION) - (STRONG_TO_MOVE ? 0 : 1) > STEPS) {
+        return KNOWN_WIN + SCORE;
+    }
+
+    // An undefended pawn next to the weak king is simply taken
+    if (!STRONG_TO_MOVE && distance(WEAK_KING, PAWN) == 1 && distance(STRONG_KING, PAWN) > 1) {
+        return 0;
+    }
+
+    // A rook pawn is a draw once the weak king reaches the promotion corner
+    if (FILE == 0 || FILE == LENGTH - 1) {
+        return distance(WEAK_KING, PROMOTION) <= 1 ? 0 : SCORE;
+    }
+
+    // With its king on a key square the strong side wins whoever is to move: two ranks ahead
+    // of the pawn on the adjacent files, or one or two ranks ahead once it has crossed the
+    // middle of the board
+    const int KEY_LOW = RANK < LENGTH / 2 ? RANK + 2 : std::min(RANK + 1, LAST_RANK - 1);
+    const int KEY_HIGH = std::min(RANK + 2, LAST_RANK);
+    if (std::abs(getFile(STRONG_KING) - FILE) <= 1 && getRank(STRONG_KING) >= KEY_LOW &&
+        getRank(STRONG_KING) <= KEY_HIGH) {
+        return KNOWN_WIN + SCORE;
+    }
+
+    // A weak king in front of the pawn holds unless it loses the opposition
+    if (getFile(WEAK_KING) == FILE && getRank(WEAK_KING) > RANK) { return SCORE / 4; }
+
+    return SCORE;
+}
+
+} // namespace Chess::Endgames
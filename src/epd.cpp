@@ -0,0 +1,90 @@
+#include "epd.h"
+
+#include <algorithm>
+#include <array>
+
+namespace Chess::Epd {
+
+namespace {
+
+// FEN fields before the operations; the two move counters are optional
+constexpr int FEN_HEAD_FIELDS = 4;
+constexpr int FEN_COUNTER_FIELDS = 2;
+
+constexpr std::string_view BLANKS = " \t\r\n";
+
+auto isNumber(std::string_view text) -> bool
+{
+    return !text.empty() && text.find_first_not_of("0123456789") == std::string_view::npos;
+}
+
+} // namespace
+
+auto trim(std::string_view text) -> std::string_view
+{
+    const std::size_t FIRST = text.find_first_not_of(BLANKS);
+    if (FIRST == std::string_view::npos) { return {}; }
+    return text.substr(FIRST, text.find_last_not_of(BLANKS) - FIRST + 1);
+}
+
+auto nextToken(std::string_view& text) -> std::string_view
+{
+    text = trim(text);
+    const std::size_t END = std::min(text.find_first_of(BLANKS), text.size());
+    const std::string_view TOKEN = text.substr(0, END);
+    text.remove_prefix(END);
+    return TOKEN;
+}
+
+auto parse(std::string_view line, std::string& fen, std::vector<Operation>& operations) -> bool
+{
+    fen.clear();
+    operations.clear();
+
+    for (int field = 0; field < FEN_HEAD_FIELDS; ++field) {
+        const std::string_view TOKEN = nextToken(line);
+        if (TOKEN.empty()) { return false; }
+        if (field > 0) { fen += ' '; }
+        fen += TOKEN;
+    }
+
+    std::array<std::string_view, FEN_COUNTER_FIELDS> counters = {"0", "1"};
+    for (std::string_view& counter : counters) {
+        std::string_view rest = line;
+        const std::string_view TOKEN = nextToken(rest);
+        if (!isNumber(TOKEN)) { break; }
+        counter = TOKEN;
+        line = rest;
+    }
+
+    while (!trim(line).empty()) {
+        const std::size_t END = std::min(line.find(';'), line.size());
+        std::string_view text = line.substr(0, END);
+        line.remove_prefix(std::min(END + 1, line.size()));
+
+        Operation operation{nextToken(text), trim(text)};
+        std::string_view& operands = operation.operands;
+        if (operands.size() >= 2 && operands.front() == '"' && operands.back() == '"') {
+            operands = operands.substr(1, operands.size() - 2);
+        }
+        if (operation.opcode == "hmvc" && isNumber(operands)) { counters[0] = operands; }
+        if (operation.opcode == "fmvn" && isNumber(operands)) { counters[1] = operands; }
+        operations.push_back(operation);
+    }
+
+    for (const std::string_view COUNTER : counters) {
+        fen += ' ';
+        fen += COUNTER;
+    }
+    return true;
+}
+
+auto find(const std::vector<Operation>& operations, std::string_view opcode) -> std::string_view
+{
+    for (const Operation& operation : operations) {
+        if (operation.opcode == opcode) { return operation.operands; }
+    }
+    return {};
+}
+
+} // namespace Chess::Epd
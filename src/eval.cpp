@@ -0,0 +1,79 @@
+#include "eval.h"
+
+#include <algorithm>
+
+#include "bitboard.h"
+#include "compiler_macros.h"
+#include "constants.h"
+#include "psqt.h"
+
+namespace Chess::Eval {
+
+using namespace Util;
+
+namespace {
+
+// A passed pawn with a piece on its stop square is much less of a threat
+constexpr PSQT::Score BLOCKED_PASSER = {-5, -20};
+
+auto blockedPassers(const Position& pos, const Pawns::Entry& pawns, Color color) -> int
+{
+    const Bitboard PASSED = pawns.passed[toIdx(color)];
+    const Bitboard STOPS = color == Color::WHITE ? PASSED << Constants::Board::LENGTH
+                                                 : PASSED >> Constants::Board::LENGTH;
+    return Bitboards::popCount(STOPS & pos.occupied());
+}
+
+auto taper(const Position& pos, const Pawns::Entry& pawns, const Material::Entry& material)
+    -> int
+{
+    constexpr int MAX_PHASE = Constants::Eval::MAX_PHASE;
+
+    const int BLOCKED =
+        blockedPassers(pos, pawns, Color::WHITE) - blockedPassers(pos, pawns, Color::BLACK);
+    const PSQT::Score TERMS = pos.psqt() + pawns.score + material.imbalance +
+                              PSQT::Score{BLOCKED_PASSER.mg * BLOCKED, BLOCKED_PASSER.eg * BLOCKED};
+
+    // Taper between the middlegame and endgame sums; the piece-square part is maintained by
+    // make/unmake and the rest comes from the pawn and material tables
+    const int PHASE = std::min(pos.phase(), MAX_PHASE);
+    const int TAPERED = ((TERMS.mg * PHASE) + (TERMS.eg * (MAX_PHASE - PHASE))) / MAX_PHASE;
+
+    // Drawish material pulls the leading side's score towards zero
+    const int SCALE = material.scale[toIdx(TAPERED > 0 ? Color::WHITE : Color::BLACK)];
+    const int SCORE = TAPERED * SCALE / Constants::Eval::SCALE_NORMAL;
+
+    return pos.getSideToMove() == Color::WHITE ? SCORE : -SCORE;
+}
+
+auto evaluateEndgame(const Position& pos, const Material::Entry& material) -> int
+{
+    const int SCORE = material.endgame(pos, material.strong_side);
+    return pos.getSideToMove() == material.strong_side ? SCORE : -SCORE;
+}
+
+} // namespace
+
+MULTIVERSION auto evaluate(const Position& pos) -> int
+{
+    Material::Entry material{};
+    Material::evaluate(pos, material);
+    if (material.draw) { return 0; }
+    if (material.endgame != nullptr) { return evaluateEndgame(pos, material); }
+
+    Pawns::Entry pawns{};
+    Pawns::evaluate(pos, pawns);
+    return taper(pos, pawns, material);
+}
+
+MULTIVERSION auto evaluate(
+    const Position& pos, Pawns::Table& pawn_table, Material::Table& material_table) -> int
+{
+    const Material::Entry& material = material_table.probe(pos);
+    if (material.draw) { return 0; }
+    if (material.endgame != nullptr) { return evaluateEndgame(pos, material); }
+
+    return taper(pos, pawn_table.probe(pos), material);
+}
+
+} // namespace Chess::Eval
@@ -1,24 +1,19 @@
 #include <iostream>
 
 #include "bitboard.h"
-#include "position.h"
+#include "uci.h"
 #include "zobrist.h"
 
 using namespace Chess;
-using namespace Util;
 
 auto main() -> int
 {
     Bitboards::init();
     Zobrist::init();
 
-    std::cout << "\n╔══════════════════════════════════════╗";
-    std::cout << "\n║            DuChess Engine            ║";
-    std::cout << "\n╚══════════════════════════════════════╝\n";
-
-    Position position;
-
-    position.print();
+    // The main thread reads commands; searches run on the engine's own thread
+    Uci::Engine engine(std::cout);
+    engine.loop(std::cin);
 
     return 0;
-}
\ No newline at end of file
+}
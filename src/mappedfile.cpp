@@ -0,0 +1,63 @@
+#include "mappedfile.h"
+
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Chess {
+
+MappedFile::~MappedFile() { close(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_mapping(std::exchange(other.m_mapping, nullptr)), m_size(std::exchange(other.m_size, 0))
+{
+}
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile&
+{
+    if (this != &other) {
+        close();
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+auto MappedFile::open(const std::string& path, Access access) -> bool
+{
+    close();
+
+    const int DESCRIPTOR = ::open(path.c_str(), O_RDONLY);
+    if (DESCRIPTOR < 0) { return false; }
+
+    struct stat status{};
+    const bool SIZED = ::fstat(DESCRIPTOR, &status) == 0;
+    const auto BYTES = SIZED ? static_cast<std::size_t>(status.st_size) : 0;
+    if (BYTES == 0) {
+        ::close(DESCRIPTOR);
+        return false;
+    }
+
+    // The mapping keeps the file referenced after its descriptor is closed
+    void* mapping = ::mmap(nullptr, BYTES, PROT_READ, MAP_PRIVATE, DESCRIPTOR, 0);
+    ::close(DESCRIPTOR);
+    if (mapping == MAP_FAILED) { return false; }
+    ::posix_madvise(mapping, BYTES,
+                    access == Access::SEQUENTIAL ? POSIX_MADV_SEQUENTIAL : POSIX_MADV_RANDOM);
+
+    m_mapping = mapping;
+    m_size = BYTES;
+    return true;
+}
+
+auto MappedFile::close() -> void
+{
+    if (m_mapping != nullptr) { ::munmap(m_mapping, m_size); }
+    m_mapping = nullptr;
+    m_size = 0;
+}
+
+} // namespace Chess
@@ -0,0 +1,118 @@
+#include "material.h"
+
+#include "bitboard.h"
+#include "compiler_macros.h"
+#include "eval.h"
+
+namespace Chess::Material {
+
+using namespace Util;
+
+namespace {
+
+constexpr int SCALE_NORMAL = Constants::Eval::SCALE_NORMAL;
+// Pawnless sides that are at most a minor piece ahead: hopeless without a rook's worth of
+// material, and nearly so with it
+constexpr uint8_t SCALE_NO_MATING_MATERIAL = 0;
+constexpr uint8_t SCALE_MINOR_VS_NOTHING = 4;
+constexpr uint8_t SCALE_MINOR_AHEAD = 14;
+
+constexpr PSQT::Score BISHOP_PAIR = {30, 50};
+// Per own pawn above or below the base count: knights like closed boards, rooks open ones
+constexpr int IMBALANCE_BASE_PAWNS = 5;
+constexpr int KNIGHT_PER_PAWN = 6;
+constexpr int ROOK_PER_PAWN = -12;
+
+struct Counts {
+    int pawns;
+    int knights;
+    int bishops;
+    int rooks;
+    int queens;
+    int non_pawn_material;
+};
+
+auto countSide(const Position& pos, Color color) -> Counts
+{
+    Counts counts{Bitboards::popCount(pos.pieces(color, PieceType::PAWN)),
+                  Bitboards::popCount(pos.pieces(color, PieceType::KNIGHT)),
+                  Bitboards::popCount(pos.pieces(color, PieceType::BISHOP)),
+                  Bitboards::popCount(pos.pieces(color, PieceType::ROOK)),
+                  Bitboards::popCount(pos.pieces(color, PieceType::QUEEN)),
+                  0};
+    counts.non_pawn_material = (Eval::pieceValue(PieceType::KNIGHT) * counts.knights) +
+                               (Eval::pieceValue(PieceType::BISHOP) * counts.bishops) +
+                               (Eval::pieceValue(PieceType::ROOK) * counts.rooks) +
+                               (Eval::pieceValue(PieceType::QUEEN) * counts.queens);
+    return counts;
+}
+
+auto imbalance(const Counts& us) -> PSQT::Score
+{
+    const int PAWN_SHIFT = us.pawns - IMBALANCE_BASE_PAWNS;
+    const int ADJUST = PAWN_SHIFT * ((KNIGHT_PER_PAWN * us.knights) + (ROOK_PER_PAWN * us.rooks));
+
+    PSQT::Score score{ADJUST, ADJUST};
+    if (us.bishops >= 2) { score += BISHOP_PAIR; }
+    return score;
+}
+
+auto isLoneKing(const Counts& side) -> bool
+{
+    return side.pawns == 0 && side.non_pawn_material == 0;
+}
+
+// Specialised evaluator for `us` against a lone king, if there is one
+auto endgameFor(const Counts& us) -> Endgames::Function
+{
+    if (us.queens + us.rooks > 0) { return &Endgames::kxk; }
+    if (us.pawns == 0 && us.knights == 1 && us.bishops == 1) { return &Endgames::kbnk; }
+    if (us.pawns == 1 && us.non_pawn_material == 0) { return &Endgames::kpk; }
+    return nullptr;
+}
+
+// How much of an advantage `us` can convert, judged by material alone
+auto scaleFor(const Counts& us, const Counts& them) -> uint8_t
+{
+    if (us.pawns > 0) { return SCALE_NORMAL; }
+
+    // Two knights cannot force mate either
+    if (us.non_pawn_material == 2 * Eval::pieceValue(PieceType::KNIGHT) && us.knights == 2) {
+        return SCALE_NO_MATING_MATERIAL;
+    }
+    if (us.non_pawn_material - them.non_pawn_material > Eval::pieceValue(PieceType::BISHOP)) {
+        return SCALE_NORMAL;
+    }
+    if (us.non_pawn_material < Eval::pieceValue(PieceType::ROOK)) {
+        return SCALE_NO_MATING_MATERIAL;
+    }
+    return them.non_pawn_material <= Eval::pieceValue(PieceType::BISHOP) ? SCALE_MINOR_VS_NOTHING
+                                                                         : SCALE_MINOR_AHEAD;
+}
+
+} // namespace
+
+MULTIVERSION auto evaluate(const Position& pos, Entry& entry) -> void
+{
+    const Counts WHITE_COUNTS = countSide(pos, Color::WHITE);
+    const Counts BLACK_COUNTS = countSide(pos, Color::BLACK);
+
+    entry.key = pos.materialKey();
+    entry.imbalance = imbalance(WHITE_COUNTS) - imbalance(BLACK_COUNTS);
+    entry.scale = {scaleFor(WHITE_COUNTS, BLACK_COUNTS), scaleFor(BLACK_COUNTS, WHITE_COUNTS)};
+    entry.endgame = nullptr;
+    entry.strong_side = Color::WHITE;
+
+    entry.draw = WHITE_COUNTS.pawns + BLACK_COUNTS.pawns == 0 &&
+                 WHITE_COUNTS.non_pawn_material + BLACK_COUNTS.non_pawn_material <=
+                     Eval::pieceValue(PieceType::BISHOP);
+    if (entry.draw) { return; }
+
+    if (isLoneKing(BLACK_COUNTS)) { entry.endgame = endgameFor(WHITE_COUNTS); }
+    else if (isLoneKing(WHITE_COUNTS)) {
+        entry.endgame = endgameFor(BLACK_COUNTS);
+        entry.strong_side = Color::BLACK;
+    }
+}
+
+} // namespace Chess::Material
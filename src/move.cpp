@@ -0,0 +1,26 @@
+#include "move.h"
+
+#include <algorithm>
+
+namespace Chess {
+
+using namespace Util;
+
+auto Move::toUci() const -> std::string
+{
+    if (isNone()) { return "0000"; }
+
+    std::string uci = squareToString(from()) + squareToString(to());
+    if (isPromotion()) {
+        // Lower-case piece letter, as UCI expects
+        uci += pieceToChar(makePiece(promotionType(), Color::BLACK));
+    }
+    return uci;
+}
+
+auto MoveList::contains(Move move) const -> bool
+{
+    return std::find(begin(), end(), move) != end();
+}
+
+} // namespace Chess
@@ -0,0 +1,551 @@
+#include "movegen.h"
+
+#include <array>
+
+#include "bitboard.h"
+#include "compiler_macros.h"
+#include "constants.h"
+#include "move.h"
+#include "position.h"
+#include "types.h"
+
+namespace Chess::MoveGen {
+
+using namespace Util;
+
+namespace {
+
+template <Color US> constexpr Color THEM = US == Color::WHITE ? Color::BLACK : Color::WHITE;
+
+// Square index delta of a single push for `US`
+template <Color US> constexpr int UP = US == Color::WHITE ? Constants::Board::LENGTH
+                                                          : -Constants::Board::LENGTH;
+
+// UP for a runtime color
+constexpr std::array<int, Constants::Board::COLOR_COUNT> PUSH_DELTA = {UP<Color::WHITE>,
+                                                                       UP<Color::BLACK>};
+
+constexpr auto offsetSquare(Square square, int delta) -> Square
+{
+    return fromIdx<Square>(static_cast<uint8_t>(toIdx(square) + delta));
+}
+
+template <Color US> constexpr auto pushUp(Bitboard bitb) -> Bitboard
+{
+    return US == Color::WHITE ? northOne(bitb) : southOne(bitb);
+}
+
+// Captures toward the a-file (west) and h-file (east) from `US`'s point of view
+template <Color US> constexpr auto captureWest(Bitboard bitb) -> Bitboard
+{
+    return US == Color::WHITE ? northWestOne(bitb) : southWestOne(bitb);
+}
+template <Color US> constexpr auto captureEast(Bitboard bitb) -> Bitboard
+{
+    return US == Color::WHITE ? northEastOne(bitb) : southEastOne(bitb);
+}
+
+template <Color US> auto isAttacked(const Position& pos, Square square, Bitboard occupied) -> bool
+{
+    return (pos.attackersTo(square, occupied) & pos.pieces(THEM<US>)) != 0;
+}
+
+template <GenType TYPE>
+auto addPromotions(MoveList& list, Square from, Square to, bool capture) -> void
+{
+    constexpr uint8_t CAPTURE_OFFSET =
+        toIdx(MoveFlag::KNIGHT_PROMOTION_CAPTURE) - toIdx(MoveFlag::KNIGHT_PROMOTION);
+    const uint8_t OFFSET = capture ? CAPTURE_OFFSET : 0;
+
+    // Queen promotions are always tactical; under-promotion pushes are generated with the quiets
+    if (TYPE != GenType::QUIETS || capture) {
+        list.push(Move(from, to, fromIdx<MoveFlag>(toIdx(MoveFlag::QUEEN_PROMOTION) + OFFSET)));
+    }
+    if (TYPE != GenType::CAPTURES || capture) {
+        list.push(Move(from, to, fromIdx<MoveFlag>(toIdx(MoveFlag::ROOK_PROMOTION) + OFFSET)));
+        list.push(Move(from, to, fromIdx<MoveFlag>(toIdx(MoveFlag::BISHOP_PROMOTION) + OFFSET)));
+        list.push(Move(from, to, fromIdx<MoveFlag>(toIdx(MoveFlag::KNIGHT_PROMOTION) + OFFSET)));
+    }
+}
+
+// Moves of the given `pawns`; in EVASIONS mode every destination is restricted to `target`
+template <Color US, GenType TYPE>
+auto generatePawnMoves(const Position& pos, MoveList& list, Bitboard pawns, Bitboard target)
+    -> void
+{
+    constexpr int PUSH = UP<US>;
+    constexpr int WEST = PUSH - 1;
+    constexpr int EAST = PUSH + 1;
+    constexpr Bitboard PROMOTION_FROM = Bitboards::ranks[US == Color::WHITE ? 6 : 1];
+    constexpr Bitboard DOUBLE_PUSH_STOP = Bitboards::ranks[US == Color::WHITE ? 2 : 5];
+
+    const Bitboard EMPTY = ~pos.occupied();
+    const Bitboard ENEMIES =
+        TYPE == GenType::EVASIONS ? pos.pieces(THEM<US>) & target : pos.pieces(THEM<US>);
+    const Bitboard PROMOTERS = pawns & PROMOTION_FROM;
+    const Bitboard MOVERS = pawns & ~PROMOTION_FROM;
+
+    // Single and double pushes
+    if constexpr (TYPE != GenType::CAPTURES) {
+        Bitboard single = pushUp<US>(MOVERS) & EMPTY;
+        Bitboard doubles = pushUp<US>(single & DOUBLE_PUSH_STOP) & EMPTY;
+        if constexpr (TYPE == GenType::EVASIONS) {
+            single &= target;
+            doubles &= target;
+        }
+        while (single != 0) {
+            const Square TO = Bitboards::popSquare(single);
+            list.push(Move(offsetSquare(TO, -PUSH), TO));
+        }
+        while (doubles != 0) {
+            const Square TO = Bitboards::popSquare(doubles);
+            list.push(Move(offsetSquare(TO, -2 * PUSH), TO, MoveFlag::DOUBLE_PAWN_PUSH));
+        }
+    }
+
+    // Promotions, by push and by capture
+    if (PROMOTERS != 0) {
+        Bitboard pushes = pushUp<US>(PROMOTERS) & EMPTY;
+        if constexpr (TYPE == GenType::EVASIONS) { pushes &= target; }
+        Bitboard west = captureWest<US>(PROMOTERS) & ENEMIES;
+        Bitboard east = captureEast<US>(PROMOTERS) & ENEMIES;
+
+        while (pushes != 0) {
+            const Square TO = Bitboards::popSquare(pushes);
+            addPromotions<TYPE>(list, offsetSquare(TO, -PUSH), TO, false);
+        }
+        if constexpr (TYPE != GenType::QUIETS) {
+            while (west != 0) {
+                const Square TO = Bitboards::popSquare(west);
+                addPromotions<TYPE>(list, offsetSquare(TO, -WEST), TO, true);
+            }
+            while (east != 0) {
+                const Square TO = Bitboards::popSquare(east);
+                addPromotions<TYPE>(list, offsetSquare(TO, -EAST), TO, true);
+            }
+        }
+    }
+
+    // Regular captures
+    if constexpr (TYPE != GenType::QUIETS) {
+        Bitboard west = captureWest<US>(MOVERS) & ENEMIES;
+        Bitboard east = captureEast<US>(MOVERS) & ENEMIES;
+        while (west != 0) {
+            const Square TO = Bitboards::popSquare(west);
+            list.push(Move(offsetSquare(TO, -WEST), TO, MoveFlag::CAPTURE));
+        }
+        while (east != 0) {
+            const Square TO = Bitboards::popSquare(east);
+            list.push(Move(offsetSquare(TO, -EAST), TO, MoveFlag::CAPTURE));
+        }
+    }
+}
+
+template <Color US, GenType TYPE>
+auto generateEnPassant(const Position& pos, MoveList& list, Bitboard target) -> void
+{
+    const Square EP_SQUARE = pos.getEnPassantSquare();
+    if (EP_SQUARE == Square::NONE) { return; }
+
+    // An en passant capture can only resolve a check given by the double-pushed pawn
+    if (TYPE == GenType::EVASIONS && !testBit(target, offsetSquare(EP_SQUARE, -UP<US>))) {
+        return;
+    }
+
+    Bitboard capturers =
+        Bitboards::pawnAttacks(THEM<US>, EP_SQUARE) & pos.pieces(US, PieceType::PAWN);
+    while (capturers != 0) {
+        list.push(Move(Bitboards::popSquare(capturers), EP_SQUARE, MoveFlag::EN_PASSANT));
+    }
+}
+
+template <Color US, PieceType PT>
+auto generatePieceMoves(const Position& pos, MoveList& list, Bitboard pieces, Bitboard target)
+    -> void
+{
+    const Bitboard OCCUPIED = pos.occupied();
+    const Bitboard ENEMIES = pos.pieces(THEM<US>);
+
+    while (pieces != 0) {
+        const Square FROM = Bitboards::popSquare(pieces);
+        const Bitboard ATTACKS = Bitboards::attacks<PT>(FROM, OCCUPIED) & target;
+
+        Bitboard captures = ATTACKS & ENEMIES;
+        Bitboard quiets = ATTACKS & ~ENEMIES;
+        while (captures != 0) {
+            list.push(Move(FROM, Bitboards::popSquare(captures), MoveFlag::CAPTURE));
+        }
+        while (quiets != 0) { list.push(Move(FROM, Bitboards::popSquare(quiets))); }
+    }
+}
+
+template <Color US> auto generateCastling(const Position& pos, MoveList& list) -> void
+{
+    constexpr bool WHITE = US == Color::WHITE;
+    constexpr CastlingRight KINGSIDE =
+        WHITE ? CastlingRight::WHITE_KINGSIDE : CastlingRight::BLACK_KINGSIDE;
+    constexpr CastlingRight QUEENSIDE =
+        WHITE ? CastlingRight::WHITE_QUEENSIDE : CastlingRight::BLACK_QUEENSIDE;
+    constexpr Square KING_FROM = WHITE ? Square::E1 : Square::E8;
+    constexpr Square KINGSIDE_ROOK = WHITE ? Square::H1 : Square::H8;
+    constexpr Square QUEENSIDE_ROOK = WHITE ? Square::A1 : Square::A8;
+
+    const Bitboard OCCUPIED = pos.occupied();
+
+    // Rights imply king and rook are still on their original squares. The king may not be in
+    // check (callers guarantee that), nor pass through or land on an attacked square.
+    if (pos.hasCastlingRight(KINGSIDE) &&
+        (Bitboards::between(KING_FROM, KINGSIDE_ROOK) & OCCUPIED) == 0 &&
+        !isAttacked<US>(pos, offsetSquare(KING_FROM, 1), OCCUPIED) &&
+        !isAttacked<US>(pos, offsetSquare(KING_FROM, 2), OCCUPIED)) {
+        list.push(Move(KING_FROM, offsetSquare(KING_FROM, 2), MoveFlag::KING_CASTLE));
+    }
+    if (pos.hasCastlingRight(QUEENSIDE) &&
+        (Bitboards::between(KING_FROM, QUEENSIDE_ROOK) & OCCUPIED) == 0 &&
+        !isAttacked<US>(pos, offsetSquare(KING_FROM, -1), OCCUPIED) &&
+        !isAttacked<US>(pos, offsetSquare(KING_FROM, -2), OCCUPIED)) {
+        list.push(Move(KING_FROM, offsetSquare(KING_FROM, -2), MoveFlag::QUEEN_CASTLE));
+    }
+}
+
+template <Color US> auto generateEvasions(const Position& pos, MoveList& list) -> void
+{
+    const Square KING = pos.kingSquare(US);
+    const Bitboard CHECKERS = pos.attackersTo(KING, pos.occupied()) & pos.pieces(THEM<US>);
+
+    // The king steps to any square not attacked once it has left its own square, so that it
+    // cannot retreat along the line of a checking slider
+    const Bitboard WITHOUT_KING = pos.occupied() ^ squareBB(KING);
+    const Bitboard ENEMIES = pos.pieces(THEM<US>);
+    Bitboard steps = Bitboards::kingAttacks(KING) & ~pos.pieces(US);
+    while (steps != 0) {
+        const Square TO = Bitboards::popSquare(steps);
+        if (isAttacked<US>(pos, TO, WITHOUT_KING)) { continue; }
+        list.push(Move(KING, TO, testBit(ENEMIES, TO) ? MoveFlag::CAPTURE : MoveFlag::QUIET));
+    }
+
+    // Double check: only the king can move
+    if ((CHECKERS & (CHECKERS - 1)) != 0) { return; }
+
+    const Square CHECKER = Bitboards::lsb(CHECKERS);
+    const Bitboard TARGET = Bitboards::between(KING, CHECKER) | CHECKERS;
+
+    generatePawnMoves<US, GenType::EVASIONS>(pos, list, pos.pieces(US, PieceType::PAWN), TARGET);
+    generateEnPassant<US, GenType::EVASIONS>(pos, list, TARGET);
+    generatePieceMoves<US, PieceType::KNIGHT>(
+        pos, list, pos.pieces(US, PieceType::KNIGHT), TARGET);
+    generatePieceMoves<US, PieceType::BISHOP>(
+        pos, list, pos.pieces(US, PieceType::BISHOP), TARGET);
+    generatePieceMoves<US, PieceType::ROOK>(pos, list, pos.pieces(US, PieceType::ROOK), TARGET);
+    generatePieceMoves<US, PieceType::QUEEN>(pos, list, pos.pieces(US, PieceType::QUEEN), TARGET);
+}
+
+template <Color US, GenType TYPE> auto generateAll(const Position& pos, MoveList& list) -> void
+{
+    if constexpr (TYPE == GenType::EVASIONS) {
+        generateEvasions<US>(pos, list);
+        return;
+    }
+
+    Bitboard target = 0;
+    if constexpr (TYPE == GenType::CAPTURES) { target = pos.pieces(THEM<US>); }
+    else if constexpr (TYPE == GenType::QUIETS) { target = ~pos.occupied(); }
+    else { target = ~pos.pieces(US); }
+
+    generatePawnMoves<US, TYPE>(pos, list, pos.pieces(US, PieceType::PAWN), target);
+    if constexpr (TYPE != GenType::QUIETS) { generateEnPassant<US, TYPE>(pos, list, target); }
+    generatePieceMoves<US, PieceType::KNIGHT>(pos, list, pos.pieces(US, PieceType::KNIGHT), target);
+    generatePieceMoves<US, PieceType::BISHOP>(pos, list, pos.pieces(US, PieceType::BISHOP), target);
+    generatePieceMoves<US, PieceType::ROOK>(pos, list, pos.pieces(US, PieceType::ROOK), target);
+    generatePieceMoves<US, PieceType::QUEEN>(pos, list, pos.pieces(US, PieceType::QUEEN), target);
+
+    // King steps are pseudo-legal here; castling is fully checked
+    generatePieceMoves<US, PieceType::KING>(pos, list, pos.pieces(US, PieceType::KING), target);
+    if constexpr (TYPE != GenType::CAPTURES) { generateCastling<US>(pos, list); }
+}
+
+// Squares attacked by the opponent of `US`, with `occupied` as the blocker set
+template <Color US> auto enemyAttacks(const Position& pos, Bitboard occupied) -> Bitboard
+{
+    constexpr Color ENEMY = THEM<US>;
+
+    const Bitboard PAWNS = pos.pieces(ENEMY, PieceType::PAWN);
+    Bitboard attacked = captureWest<ENEMY>(PAWNS) | captureEast<ENEMY>(PAWNS);
+
+    Bitboard knights = pos.pieces(ENEMY, PieceType::KNIGHT);
+    while (knights != 0) { attacked |= Bitboards::knightAttacks(Bitboards::popSquare(knights)); }
+
+    const Bitboard QUEENS = pos.pieces(ENEMY, PieceType::QUEEN);
+    Bitboard diagonal = pos.pieces(ENEMY, PieceType::BISHOP) | QUEENS;
+    while (diagonal != 0) {
+        attacked |= Bitboards::bishopAttacks(Bitboards::popSquare(diagonal), occupied);
+    }
+    Bitboard orthogonal = pos.pieces(ENEMY, PieceType::ROOK) | QUEENS;
+    while (orthogonal != 0) {
+        attacked |= Bitboards::rookAttacks(Bitboards::popSquare(orthogonal), occupied);
+    }
+
+    return attacked | Bitboards::kingAttacks(pos.kingSquare(ENEMY));
+}
+
+// Own pieces that are the only blocker between `king` and an enemy slider
+template <Color US> auto pinnedPieces(const Position& pos, Square king) -> Bitboard
+{
+    constexpr Color ENEMY = THEM<US>;
+
+    const Bitboard OCCUPIED = pos.occupied();
+    const Bitboard QUEENS = pos.pieces(ENEMY, PieceType::QUEEN);
+    Bitboard snipers =
+        (Bitboards::rookAttacks(king, 0) & (pos.pieces(ENEMY, PieceType::ROOK) | QUEENS)) |
+        (Bitboards::bishopAttacks(king, 0) & (pos.pieces(ENEMY, PieceType::BISHOP) | QUEENS));
+
+    Bitboard pinned = 0;
+    while (snipers != 0) {
+        const Square SNIPER = Bitboards::popSquare(snipers);
+        const Bitboard BLOCKERS = Bitboards::between(king, SNIPER) & OCCUPIED;
+        if (BLOCKERS != 0 && (BLOCKERS & (BLOCKERS - 1)) == 0) { pinned |= BLOCKERS; }
+    }
+    return pinned & pos.pieces(US);
+}
+
+template <Color US> auto generateLegalMoves(const Position& pos, MoveList& list) -> void
+{
+    const Square KING = pos.kingSquare(US);
+    const Bitboard OCCUPIED = pos.occupied();
+    const Bitboard OWN = pos.pieces(US);
+    const Bitboard CHECKERS = pos.attackersTo(KING, OCCUPIED) & pos.pieces(THEM<US>);
+
+    // The king is removed from the blockers so it cannot retreat along a checking line
+    const Bitboard DANGER = enemyAttacks<US>(pos, OCCUPIED ^ squareBB(KING));
+    generatePieceMoves<US, PieceType::KING>(pos, list, squareBB(KING), ~OWN & ~DANGER);
+
+    // Double check: only the king can move
+    if ((CHECKERS & (CHECKERS - 1)) != 0) { return; }
+
+    // Every other move has to capture the checker or interpose, if there is one
+    Bitboard check_mask = ~0ULL;
+    if (CHECKERS != 0) {
+        check_mask = Bitboards::between(KING, Bitboards::lsb(CHECKERS)) | CHECKERS;
+    }
+    else {
+        generateCastling<US>(pos, list);
+    }
+
+    const Bitboard PINNED = pinnedPieces<US>(pos, KING);
+    const Bitboard TARGET = ~OWN & check_mask;
+    const Bitboard PAWNS = pos.pieces(US, PieceType::PAWN);
+    const Bitboard BISHOPS = pos.pieces(US, PieceType::BISHOP);
+    const Bitboard ROOKS = pos.pieces(US, PieceType::ROOK);
+    const Bitboard QUEENS = pos.pieces(US, PieceType::QUEEN);
+
+    generatePawnMoves<US, GenType::EVASIONS>(pos, list, PAWNS & ~PINNED, check_mask);
+    generatePieceMoves<US, PieceType::KNIGHT>(
+        pos, list, pos.pieces(US, PieceType::KNIGHT) & ~PINNED, TARGET);
+    generatePieceMoves<US, PieceType::BISHOP>(pos, list, BISHOPS & ~PINNED, TARGET);
+    generatePieceMoves<US, PieceType::ROOK>(pos, list, ROOKS & ~PINNED, TARGET);
+    generatePieceMoves<US, PieceType::QUEEN>(pos, list, QUEENS & ~PINNED, TARGET);
+
+    // Pinned pieces may only slide along the pin line; pinned knights can never move
+    Bitboard pinned = PINNED;
+    while (pinned != 0) {
+        const Square FROM = Bitboards::popSquare(pinned);
+        const Bitboard FROM_BB = squareBB(FROM);
+        const Bitboard PIN_LINE = Bitboards::line(KING, FROM);
+
+        if ((PAWNS & FROM_BB) != 0) {
+            generatePawnMoves<US, GenType::EVASIONS>(pos, list, FROM_BB, check_mask & PIN_LINE);
+        }
+        else if ((BISHOPS & FROM_BB) != 0) {
+            generatePieceMoves<US, PieceType::BISHOP>(pos, list, FROM_BB, TARGET & PIN_LINE);
+        }
+        else if ((ROOKS & FROM_BB) != 0) {
+            generatePieceMoves<US, PieceType::ROOK>(pos, list, FROM_BB, TARGET & PIN_LINE);
+        }
+        else if ((QUEENS & FROM_BB) != 0) {
+            generatePieceMoves<US, PieceType::QUEEN>(pos, list, FROM_BB, TARGET & PIN_LINE);
+        }
+    }
+
+    // En passant removes two pawns from the board at once, which can expose the king along the
+    // rank; it is rare enough to verify directly against the resulting occupancy
+    const Square EP_SQUARE = pos.getEnPassantSquare();
+    if (EP_SQUARE != Square::NONE) {
+        const Bitboard CAPTURED = squareBB(offsetSquare(EP_SQUARE, -UP<US>));
+        Bitboard capturers = Bitboards::pawnAttacks(THEM<US>, EP_SQUARE) & PAWNS;
+        while (capturers != 0) {
+            const Square FROM = Bitboards::popSquare(capturers);
+            const Bitboard AFTER =
+                (OCCUPIED ^ squareBB(FROM) ^ CAPTURED) | squareBB(EP_SQUARE);
+            if ((pos.attackersTo(KING, AFTER) & pos.pieces(THEM<US>) & ~CAPTURED) == 0) {
+                list.push(Move(FROM, EP_SQUARE, MoveFlag::EN_PASSANT));
+            }
+        }
+    }
+}
+
+} // namespace
+
+MULTIVERSION auto isPseudoLegal(const Position& pos, Move move) -> bool
+{
+    if (move.isNone()) { return false; }
+
+    const Color US = pos.getSideToMove();
+    const Color ENEMY = US == Color::WHITE ? Color::BLACK : Color::WHITE;
+    const Square FROM = move.from();
+    const Square TO = move.to();
+    const Piece PIECE = pos.pieceAt(FROM);
+    const Piece TARGET = pos.pieceAt(TO);
+    const PieceType TYPE = getPieceType(PIECE);
+    const Bitboard OCCUPIED = pos.occupied();
+
+    if (PIECE == Piece::NONE || getPieceColor(PIECE) != US) { return false; }
+
+    if (move.isCastle()) {
+        // Rare enough to compare against the generator, which checks the passing squares
+        if (TYPE != PieceType::KING || pos.inCheck()) { return false; }
+        MoveList castles;
+        if (US == Color::WHITE) { generateCastling<Color::WHITE>(pos, castles); }
+        else {
+            generateCastling<Color::BLACK>(pos, castles);
+        }
+        return castles.contains(move);
+    }
+
+    // The flag has to describe what is actually on the target square
+    if (move.isEnPassant()) {
+        if (TYPE != PieceType::PAWN || TO != pos.getEnPassantSquare() ||
+            !testBit(Bitboards::pawnAttacks(US, FROM), TO)) {
+            return false;
+        }
+    }
+    else if (move.isCapture()) {
+        if (TARGET == Piece::NONE || getPieceColor(TARGET) != ENEMY ||
+            getPieceType(TARGET) == PieceType::KING) {
+            return false;
+        }
+    }
+    else if (TARGET != Piece::NONE) {
+        return false;
+    }
+
+    if (TYPE == PieceType::PAWN) {
+        const int PUSH = PUSH_DELTA[toIdx(US)];
+        const int LAST_RANK = US == Color::WHITE ? Constants::Board::MAX_RANK : 0;
+        if (move.isPromotion() != (getRank(TO) == LAST_RANK)) { return false; }
+
+        if (move.isCapture()) {
+            if (!testBit(Bitboards::pawnAttacks(US, FROM), TO)) { return false; }
+        }
+        else if (move.flag() == MoveFlag::DOUBLE_PAWN_PUSH) {
+            const int START_RANK = US == Color::WHITE ? 1 : Constants::Board::MAX_RANK - 1;
+            if (getRank(FROM) != START_RANK || toIdx(TO) != toIdx(FROM) + (2 * PUSH) ||
+                testBit(OCCUPIED, offsetSquare(FROM, PUSH))) {
+                return false;
+            }
+        }
+        else if (toIdx(TO) != toIdx(FROM) + PUSH) {
+            return false;
+        }
+    }
+    else {
+        if (move.isPromotion() || move.flag() == MoveFlag::DOUBLE_PAWN_PUSH ||
+            move.isEnPassant()) {
+            return false;
+        }
+
+        Bitboard attacks = 0;
+        switch (TYPE) {
+            case PieceType::KNIGHT: attacks = Bitboards::knightAttacks(FROM); break;
+            case PieceType::BISHOP: attacks = Bitboards::bishopAttacks(FROM, OCCUPIED); break;
+            case PieceType::ROOK: attacks = Bitboards::rookAttacks(FROM, OCCUPIED); break;
+            case PieceType::QUEEN: attacks = Bitboards::queenAttacks(FROM, OCCUPIED); break;
+            case PieceType::KING: attacks = Bitboards::kingAttacks(FROM); break;
+            default: break;
+        }
+        if (!testBit(attacks, TO)) { return false; }
+    }
+
+    // In check, anything but a king move has to capture the single checker or block it
+    const Bitboard CHECKERS = pos.checkers();
+    if (CHECKERS != 0 && TYPE != PieceType::KING) {
+        if ((CHECKERS & (CHECKERS - 1)) != 0) { return false; }
+
+        const Square KING = pos.kingSquare(US);
+        const Bitboard EVASION_TARGET = Bitboards::between(KING, Bitboards::lsb(CHECKERS)) |
+                                        CHECKERS;
+        // En passant resolves the check when the captured pawn is the checker
+        const Square CAPTURED = move.isEnPassant() ? offsetSquare(TO, -PUSH_DELTA[toIdx(US)]) : TO;
+        if (!testBit(EVASION_TARGET, TO) && !testBit(CHECKERS, CAPTURED)) { return false; }
+    }
+
+    return true;
+}
+
+auto isLegal(const Position& pos, Move move) -> bool
+{
+    const Color US = pos.getSideToMove();
+    const Bitboard ENEMIES = pos.pieces(US == Color::WHITE ? Color::BLACK : Color::WHITE);
+    const Square FROM = move.from();
+    const Square TO = move.to();
+    const Square KING = pos.kingSquare(US);
+    const Bitboard OCCUPIED = pos.occupied();
+
+    // Castling is only ever generated legal
+    if (move.isCastle()) { return true; }
+
+    // The king may not step onto an attacked square; it is lifted off the board so that it
+    // cannot hide behind itself on a checking line
+    if (FROM == KING) {
+        return (pos.attackersTo(TO, OCCUPIED ^ squareBB(FROM)) & ENEMIES) == 0;
+    }
+
+    if (move.isEnPassant()) {
+        const Bitboard CAPTURED = squareBB(offsetSquare(TO, -PUSH_DELTA[toIdx(US)]));
+        const Bitboard AFTER = (OCCUPIED ^ squareBB(FROM) ^ CAPTURED) | squareBB(TO);
+        return (pos.attackersTo(KING, AFTER) & ENEMIES & ~CAPTURED) == 0;
+    }
+
+    // Other pieces only matter when leaving a line through the king, where they may be pinned
+    const Bitboard LINE = Bitboards::line(KING, FROM);
+    if (LINE == 0 || testBit(LINE, TO)) { return true; }
+
+    const Bitboard AFTER = (OCCUPIED ^ squareBB(FROM)) | squareBB(TO);
+    const Bitboard QUEENS = pos.pieces(PieceType::QUEEN);
+    const Bitboard SLIDERS =
+        (Bitboards::bishopAttacks(KING, AFTER) & (pos.pieces(PieceType::BISHOP) | QUEENS)) |
+        (Bitboards::rookAttacks(KING, AFTER) & (pos.pieces(PieceType::ROOK) | QUEENS));
+    return (SLIDERS & ENEMIES & ~squareBB(TO)) == 0;
+}
+
+template <GenType TYPE> MULTIVERSION auto generate(const Position& pos, MoveList& list) -> void
+{
+    if (pos.getSideToMove() == Color::WHITE) { generateAll<Color::WHITE, TYPE>(pos, list); }
+    else {
+        generateAll<Color::BLACK, TYPE>(pos, list);
+    }
+}
+
+template auto generate<GenType::CAPTURES>(const Position& pos, MoveList& list) -> void;
+template auto generate<GenType::QUIETS>(const Position& pos, MoveList& list) -> void;
+template auto generate<GenType::EVASIONS>(const Position& pos, MoveList& list) -> void;
+template auto generate<GenType::NON_EVASIONS>(const Position& pos, MoveList& list) -> void;
+
+auto generatePseudoLegal(const Position& pos, MoveList& list) -> void
+{
+    if (pos.inCheck()) { generate<GenType::EVASIONS>(pos, list); }
+    else {
+        generate<GenType::NON_EVASIONS>(pos, list);
+    }
+}
+
+MULTIVERSION auto generateLegal(const Position& pos) -> MoveList
+{
+    MoveList list;
+    if (pos.getSideToMove() == Color::WHITE) { generateLegalMoves<Color::WHITE>(pos, list); }
+    else {
+        generateLegalMoves<Color::BLACK>(pos, list);
+    }
+    return list;
+}
+
+} // namespace Chess::MoveGen
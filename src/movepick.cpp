@@ -0,0 +1,225 @@
+#include "movepick.h"
+
+#include <utility>
+
+#include "eval.h"
+#include "movegen.h"
+
+namespace Chess::Search {
+
+using namespace Util;
+
+namespace {
+
+// Evasion captures sort ahead of any history score
+constexpr int CAPTURE_BONUS = 1 << 16;
+constexpr int VICTIM_WEIGHT = 16;
+
+auto capturedType(const Position& pos, Move move) -> PieceType
+{
+    return move.isEnPassant() ? PieceType::PAWN : getPieceType(pos.pieceAt(move.to()));
+}
+
+// MVV-LVA: most valuable victim first, cheapest attacker among equals
+auto mvvLva(const Position& pos, Move move) -> int
+{
+    return (VICTIM_WEIGHT * Eval::pieceValue(capturedType(pos, move))) +
+           Eval::pieceValue(move.promotionType()) - toIdx(getPieceType(pos.pieceAt(move.from())));
+}
+
+} // namespace
+
+MovePicker::MovePicker(const Position& pos,
+                       Move tt_move,
+                       const Killers& killers,
+                       Move counter_move,
+                       const HistoryTable& history)
+    : m_pos(pos),
+      m_history(history),
+      m_tt_move(MoveGen::isPseudoLegal(pos, tt_move) ? tt_move : Move()),
+      m_killers(killers),
+      m_counter_move(counter_move),
+      m_stage(pos.inCheck() ? Stage::EVASION_TT_MOVE : Stage::TT_MOVE),
+      m_scores(),
+      m_current(0),
+      m_bad_end(0),
+      m_captures_end(0)
+{
+}
+
+MovePicker::MovePicker(const Position& pos, Move tt_move, const HistoryTable& history)
+    : m_pos(pos),
+      m_history(history),
+      m_tt_move(MoveGen::isPseudoLegal(pos, tt_move) ? tt_move : Move()),
+      m_killers(),
+      m_counter_move(),
+      m_stage(pos.inCheck() ? Stage::EVASION_TT_MOVE : Stage::QUIESCENCE_TT_MOVE),
+      m_scores(),
+      m_current(0),
+      m_bad_end(0),
+      m_captures_end(0)
+{
+    // Outside of check quiescence only looks at tactical moves
+    if (m_stage == Stage::QUIESCENCE_TT_MOVE && !m_tt_move.isTactical()) { m_tt_move = Move(); }
+}
+
+auto MovePicker::scoreCaptures(std::size_t begin, std::size_t end) -> void
+{
+    for (std::size_t i = begin; i < end; ++i) { m_scores[i] = mvvLva(m_pos, m_moves[i]); }
+}
+
+auto MovePicker::scoreQuiets(std::size_t begin, std::size_t end) -> void
+{
+    const auto& side_history = m_history[toIdx(m_pos.getSideToMove())];
+    for (std::size_t i = begin; i < end; ++i) {
+        m_scores[i] = side_history[toIdx(m_moves[i].from())][toIdx(m_moves[i].to())];
+    }
+}
+
+// Swaps the best-scored move of [begin, end) into `begin`
+auto MovePicker::selectBest(std::size_t begin, std::size_t end) -> void
+{
+    std::size_t best = begin;
+    for (std::size_t i = begin + 1; i < end; ++i) {
+        if (m_scores[i] > m_scores[best]) { best = i; }
+    }
+    std::swap(m_moves[begin], m_moves[best]);
+    std::swap(m_scores[begin], m_scores[best]);
+}
+
+auto MovePicker::isRefutation(Move move) const -> bool
+{
+    return move == m_killers[0] || move == m_killers[1] || move == m_counter_move;
+}
+
+// Captures that lose material in the exchange that follows are deferred until after the quiets
+auto MovePicker::isLosingCapture(Move move) const -> bool { return !m_pos.see(move); }
+
+auto MovePicker::next() -> Move
+{
+    while (true) {
+        switch (m_stage) {
+            case Stage::TT_MOVE:
+            case Stage::EVASION_TT_MOVE:
+            case Stage::QUIESCENCE_TT_MOVE:
+                m_stage = fromIdx<Stage>(toIdx(m_stage) + 1);
+                if (!m_tt_move.isNone() && MoveGen::isLegal(m_pos, m_tt_move)) { return m_tt_move; }
+                break;
+
+            case Stage::GENERATE_CAPTURES:
+            case Stage::GENERATE_QUIESCENCE:
+                MoveGen::generate<MoveGen::GenType::CAPTURES>(m_pos, m_moves);
+                m_captures_end = m_moves.size();
+                scoreCaptures(0, m_captures_end);
+                m_current = 0;
+                m_stage = fromIdx<Stage>(toIdx(m_stage) + 1);
+                break;
+
+            case Stage::GOOD_CAPTURES:
+                while (m_current < m_captures_end) {
+                    selectBest(m_current, m_captures_end);
+                    const Move MOVE = m_moves[m_current];
+                    const int SCORE = m_scores[m_current++];
+                    if (MOVE == m_tt_move) { continue; }
+                    if (isLosingCapture(MOVE)) {
+                        m_moves[m_bad_end] = MOVE;
+                        m_scores[m_bad_end++] = SCORE;
+                        continue;
+                    }
+                    if (MoveGen::isLegal(m_pos, MOVE)) { return MOVE; }
+                }
+                m_stage = Stage::FIRST_KILLER;
+                break;
+
+            case Stage::FIRST_KILLER:
+            case Stage::SECOND_KILLER: {
+                const Move KILLER = m_killers[m_stage == Stage::FIRST_KILLER ? 0 : 1];
+                m_stage = fromIdx<Stage>(toIdx(m_stage) + 1);
+                if (!KILLER.isTactical() && KILLER != m_tt_move &&
+                    MoveGen::isPseudoLegal(m_pos, KILLER) && MoveGen::isLegal(m_pos, KILLER)) {
+                    return KILLER;
+                }
+                break;
+            }
+
+            case Stage::COUNTER_MOVE:
+                m_stage = Stage::GENERATE_QUIETS;
+                if (!m_counter_move.isTactical() && m_counter_move != m_tt_move &&
+                    m_counter_move != m_killers[0] && m_counter_move != m_killers[1] &&
+                    MoveGen::isPseudoLegal(m_pos, m_counter_move) &&
+                    MoveGen::isLegal(m_pos, m_counter_move)) {
+                    return m_counter_move;
+                }
+                break;
+
+            case Stage::GENERATE_QUIETS: {
+                MoveGen::generate<MoveGen::GenType::QUIETS>(m_pos, m_moves);
+                scoreQuiets(m_captures_end, m_moves.size());
+
+                // Insertion sort, best first; quiet lists are short and mostly unsorted
+                for (std::size_t i = m_captures_end + 1; i < m_moves.size(); ++i) {
+                    const Move MOVE = m_moves[i];
+                    const int SCORE = m_scores[i];
+                    std::size_t j = i;
+                    for (; j > m_captures_end && m_scores[j - 1] < SCORE; --j) {
+                        m_moves[j] = m_moves[j - 1];
+                        m_scores[j] = m_scores[j - 1];
+                    }
+                    m_moves[j] = MOVE;
+                    m_scores[j] = SCORE;
+                }
+                m_current = m_captures_end;
+                m_stage = Stage::QUIETS;
+                break;
+            }
+
+            case Stage::QUIETS:
+                while (m_current < m_moves.size()) {
+                    const Move MOVE = m_moves[m_current++];
+                    if (MOVE == m_tt_move || isRefutation(MOVE)) { continue; }
+                    if (MoveGen::isLegal(m_pos, MOVE)) { return MOVE; }
+                }
+                // Losing captures were collected in selection order, so they are already sorted
+                m_current = 0;
+                m_stage = Stage::BAD_CAPTURES;
+                break;
+
+            case Stage::BAD_CAPTURES:
+                while (m_current < m_bad_end) {
+                    const Move MOVE = m_moves[m_current++];
+                    if (MoveGen::isLegal(m_pos, MOVE)) { return MOVE; }
+                }
+                m_stage = Stage::DONE;
+                break;
+
+            case Stage::GENERATE_EVASIONS:
+                MoveGen::generate<MoveGen::GenType::EVASIONS>(m_pos, m_moves);
+                for (std::size_t i = 0; i < m_moves.size(); ++i) {
+                    const Move MOVE = m_moves[i];
+                    m_scores[i] = MOVE.isTactical()
+                                      ? CAPTURE_BONUS + mvvLva(m_pos, MOVE)
+                                      : m_history[toIdx(m_pos.getSideToMove())][toIdx(MOVE.from())]
+                                                 [toIdx(MOVE.to())];
+                }
+                m_captures_end = m_moves.size();
+                m_current = 0;
+                m_stage = Stage::EVASIONS;
+                break;
+
+            case Stage::EVASIONS:
+            case Stage::QUIESCENCE_CAPTURES:
+                while (m_current < m_captures_end) {
+                    selectBest(m_current, m_captures_end);
+                    const Move MOVE = m_moves[m_current++];
+                    if (MOVE == m_tt_move) { continue; }
+                    if (MoveGen::isLegal(m_pos, MOVE)) { return MOVE; }
+                }
+                m_stage = Stage::DONE;
+                break;
+
+            case Stage::DONE: return Move();
+        }
+    }
+}
+
+} // namespace Chess::Search
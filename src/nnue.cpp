@@ -0,0 +1,471 @@
+#include "nnue.h"
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <random>
+
+#include "bitboard.h"
+#include "compiler_macros.h"
+
+// Kernels are chosen at build time: AVX2 when configured with DUCHESS_USE_AVX2, otherwise SSE2,
+// which every x86-64 target has, otherwise plain loops. All three give identical results.
+#if defined(USE_AVX2)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Chess::NNUE {
+
+using namespace Util;
+
+namespace {
+
+constexpr int CRELU_MAX = Constants::NNUE::CRELU_MAX;
+constexpr int WEIGHT_SCALE_BITS = Constants::NNUE::WEIGHT_SCALE_BITS;
+constexpr int OUTPUT_SCALE = Constants::NNUE::OUTPUT_SCALE;
+
+constexpr uint32_t FILE_MAGIC = 0x4E4E4344; // "DCNN"
+constexpr uint32_t FILE_VERSION = 1;
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t features;
+    uint32_t hidden;
+    uint32_t l2;
+    uint32_t l3;
+};
+
+constexpr FileHeader EXPECTED_HEADER = {FILE_MAGIC, FILE_VERSION, FEATURES, HIDDEN, L2, L3};
+
+// Every array of `Network` in declaration order, for reading and writing the weights file
+template <typename Net, typename Visitor> auto forEachArray(Net& net, Visitor&& visit) -> void
+{
+    visit(net.feature_biases.data(), sizeof(net.feature_biases));
+    visit(net.feature_weights.data(), sizeof(net.feature_weights));
+    visit(net.l1_biases.data(), sizeof(net.l1_biases));
+    visit(net.l1_weights.data(), sizeof(net.l1_weights));
+    visit(net.l2_biases.data(), sizeof(net.l2_biases));
+    visit(net.l2_weights.data(), sizeof(net.l2_weights));
+    visit(net.output_weights.data(), sizeof(net.output_weights));
+    visit(&net.output_bias, sizeof(net.output_bias));
+}
+
+constexpr auto payloadSize() -> std::size_t
+{
+    return sizeof(Network::feature_biases) + sizeof(Network::feature_weights) +
+           sizeof(Network::l1_biases) + sizeof(Network::l1_weights) + sizeof(Network::l2_biases) +
+           sizeof(Network::l2_weights) + sizeof(Network::output_weights) +
+           sizeof(Network::output_bias);
+}
+
+constexpr auto offsetSquare(Square square, int delta) -> Square
+{
+    return fromIdx<Square>(static_cast<uint8_t>(toIdx(square) + delta));
+}
+
+// Features are seen from `perspective`: Black's board is flipped so both sides share weights
+auto featureIndex(Color perspective, Square king, Piece piece, Square square) -> std::size_t
+{
+    const int FLIP = perspective == Color::WHITE ? 0 : Constants::Board::SQUARE_COUNT - 8;
+    const int PIECE_INDEX = ((toIdx(getPieceType(piece)) - 1) * 2) +
+                            static_cast<int>(getPieceColor(piece) != perspective);
+    return (static_cast<std::size_t>(toIdx(king) ^ FLIP) * Constants::NNUE::PIECE_FEATURES) +
+           (static_cast<std::size_t>(PIECE_INDEX) * Constants::Board::SQUARE_COUNT) +
+           static_cast<std::size_t>(toIdx(square) ^ FLIP);
+}
+
+auto featureRow(const Network& net, std::size_t feature) -> const int16_t*
+{
+    return net.feature_weights.data() + (feature * HIDDEN);
+}
+
+// out = in + sum(adds) - sum(subs), one accumulator perspective wide
+auto updateAccumulator(const int16_t* in, int16_t* out, const int16_t* const* adds, int add_count,
+                       const int16_t* const* subs, int sub_count) -> void
+{
+#if defined(USE_AVX2)
+    constexpr int LANES = 16;
+    for (int chunk = 0; chunk < HIDDEN; chunk += LANES) {
+        __m256i sum = _mm256_load_si256(reinterpret_cast<const __m256i*>(in + chunk));
+        for (int i = 0; i < add_count; ++i) {
+            sum = _mm256_add_epi16(
+                sum, _mm256_load_si256(reinterpret_cast<const __m256i*>(adds[i] + chunk)));
+        }
+        for (int i = 0; i < sub_count; ++i) {
+            sum = _mm256_sub_epi16(
+                sum, _mm256_load_si256(reinterpret_cast<const __m256i*>(subs[i] + chunk)));
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i*>(out + chunk), sum);
+    }
+#elif defined(__SSE2__)
+    constexpr int LANES = 8;
+    for (int chunk = 0; chunk < HIDDEN; chunk += LANES) {
+        __m128i sum = _mm_load_si128(reinterpret_cast<const __m128i*>(in + chunk));
+        for (int i = 0; i < add_count; ++i) {
+            sum = _mm_add_epi16(sum,
+                                _mm_load_si128(reinterpret_cast<const __m128i*>(adds[i] + chunk)));
+        }
+        for (int i = 0; i < sub_count; ++i) {
+            sum = _mm_sub_epi16(sum,
+                                _mm_load_si128(reinterpret_cast<const __m128i*>(subs[i] + chunk)));
+        }
+        _mm_store_si128(reinterpret_cast<__m128i*>(out + chunk), sum);
+    }
+#else
+    for (int j = 0; j < HIDDEN; ++j) {
+        int sum = in[j];
+        for (int i = 0; i < add_count; ++i) { sum += adds[i][j]; }
+        for (int i = 0; i < sub_count; ++i) { sum -= subs[i][j]; }
+        out[j] = static_cast<int16_t>(sum);
+    }
+#endif
+}
+
+// Clipped ReLU of one accumulator perspective into the first layer's uint8 inputs
+auto clipAccumulator(const int16_t* in, uint8_t* out) -> void
+{
+#if defined(USE_AVX2)
+    constexpr int LANES = 32;
+    constexpr int LANE_ORDER = 0b11011000; // undoes the per-128-bit-lane interleave of packs
+    const __m256i ZERO = _mm256_setzero_si256();
+    for (int chunk = 0; chunk < HIDDEN; chunk += LANES) {
+        const __m256i LOW = _mm256_load_si256(reinterpret_cast<const __m256i*>(in + chunk));
+        const __m256i HIGH =
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(in + chunk + (LANES / 2)));
+        const __m256i PACKED = _mm256_max_epi8(_mm256_packs_epi16(LOW, HIGH), ZERO);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(out + chunk),
+                           _mm256_permute4x64_epi64(PACKED, LANE_ORDER));
+    }
+#elif defined(__SSE2__)
+    constexpr int LANES = 16;
+    const __m128i ZERO = _mm_setzero_si128();
+    for (int chunk = 0; chunk < HIDDEN; chunk += LANES) {
+        const __m128i LOW = _mm_max_epi16(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(in + chunk)), ZERO);
+        const __m128i HIGH = _mm_max_epi16(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(in + chunk + (LANES / 2))), ZERO);
+        _mm_store_si128(reinterpret_cast<__m128i*>(out + chunk), _mm_packs_epi16(LOW, HIGH));
+    }
+#else
+    for (int j = 0; j < HIDDEN; ++j) {
+        out[j] = static_cast<uint8_t>(std::clamp<int>(in[j], 0, CRELU_MAX));
+    }
+#endif
+}
+
+// out[i] = biases[i] + dot(in, weights row i), with `inputs` a multiple of 32
+auto affine(const uint8_t* in, int inputs, const int8_t* weights, const int32_t* biases,
+            int32_t* out, int outputs) -> void
+{
+#if defined(USE_AVX2)
+    constexpr int LANES = 32;
+    const __m256i ONES = _mm256_set1_epi16(1);
+    for (int row = 0; row < outputs; ++row) {
+        const int8_t* row_weights = weights + (static_cast<std::ptrdiff_t>(row) * inputs);
+        __m256i sum = _mm256_setzero_si256();
+        for (int chunk = 0; chunk < inputs; chunk += LANES) {
+            const __m256i INPUT = _mm256_load_si256(reinterpret_cast<const __m256i*>(in + chunk));
+            const __m256i WEIGHT =
+                _mm256_load_si256(reinterpret_cast<const __m256i*>(row_weights + chunk));
+            // Inputs are at most 127, so the pairwise int16 sums cannot saturate
+            const __m256i PAIRS = _mm256_maddubs_epi16(INPUT, WEIGHT);
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(PAIRS, ONES));
+        }
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+        out[row] = biases[row] + _mm_cvtsi128_si32(half);
+    }
+#elif defined(__SSE2__)
+    constexpr int LANES = 16;
+    constexpr int SIGN_SHIFT = 8;
+    const __m128i ZERO = _mm_setzero_si128();
+    for (int row = 0; row < outputs; ++row) {
+        const int8_t* row_weights = weights + (static_cast<std::ptrdiff_t>(row) * inputs);
+        __m128i sum = _mm_setzero_si128();
+        for (int chunk = 0; chunk < inputs; chunk += LANES) {
+            const __m128i INPUT = _mm_load_si128(reinterpret_cast<const __m128i*>(in + chunk));
+            const __m128i WEIGHT =
+                _mm_load_si128(reinterpret_cast<const __m128i*>(row_weights + chunk));
+            // Widen to int16: inputs by zero extension, weights by duplicating and shifting
+            const __m128i INPUT_LOW = _mm_unpacklo_epi8(INPUT, ZERO);
+            const __m128i INPUT_HIGH = _mm_unpackhi_epi8(INPUT, ZERO);
+            const __m128i WEIGHT_LOW =
+                _mm_srai_epi16(_mm_unpacklo_epi8(WEIGHT, WEIGHT), SIGN_SHIFT);
+            const __m128i WEIGHT_HIGH =
+                _mm_srai_epi16(_mm_unpackhi_epi8(WEIGHT, WEIGHT), SIGN_SHIFT);
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(INPUT_LOW, WEIGHT_LOW));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(INPUT_HIGH, WEIGHT_HIGH));
+        }
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+        out[row] = biases[row] + _mm_cvtsi128_si32(sum);
+    }
+#else
+    for (int row = 0; row < outputs; ++row) {
+        const int8_t* row_weights = weights + (static_cast<std::ptrdiff_t>(row) * inputs);
+        int32_t sum = biases[row];
+        for (int i = 0; i < inputs; ++i) { sum += in[i] * row_weights[i]; }
+        out[row] = sum;
+    }
+#endif
+}
+
+// Clipped ReLU between affine layers, dropping the weight scale
+template <std::size_t SIZE>
+auto clipLayer(const std::array<int32_t, SIZE>& in, std::array<uint8_t, SIZE>& out) -> void
+{
+    for (std::size_t i = 0; i < SIZE; ++i) {
+        out[i] = static_cast<uint8_t>(std::clamp(in[i] >> WEIGHT_SCALE_BITS, 0, CRELU_MAX));
+    }
+}
+
+auto refresh(const Network& net, const Position& pos, Color perspective, Accumulator& acc)
+    -> void
+{
+    const Square KING = pos.kingSquare(perspective);
+    int16_t* values = acc.values[toIdx(perspective)].data();
+    std::copy(net.feature_biases.begin(), net.feature_biases.end(), values);
+
+    for (uint8_t color = 0; color < Constants::Board::COLOR_COUNT; ++color) {
+        for (uint8_t type = toIdx(PieceType::PAWN); type < toIdx(PieceType::KING); ++type) {
+            const Piece PIECE = makePiece(fromIdx<PieceType>(type), fromIdx<Color>(color));
+            Bitboard bitboard = pos.pieces(fromIdx<Color>(color), fromIdx<PieceType>(type));
+            while (bitboard != 0) {
+                const Square SQUARE = Bitboards::popSquare(bitboard);
+                const int16_t* row =
+                    featureRow(net, featureIndex(perspective, KING, PIECE, SQUARE));
+                updateAccumulator(values, values, &row, 1, nullptr, 0);
+            }
+        }
+    }
+    acc.computed[toIdx(perspective)] = true;
+}
+
+// Derives `acc` from its parent by the pieces the move in between changed
+auto applyDirty(const Network& net, const Accumulator& parent, Accumulator& acc,
+                Color perspective, Square king) -> void
+{
+    std::array<const int16_t*, DirtyPieces::MAX> adds{};
+    std::array<const int16_t*, DirtyPieces::MAX> subs{};
+    int add_count = 0;
+    int sub_count = 0;
+
+    const DirtyPieces& dirty = acc.dirty;
+    for (int i = 0; i < dirty.count; ++i) {
+        if (dirty.from[i] != Square::NONE) {
+            subs[sub_count++] =
+                featureRow(net, featureIndex(perspective, king, dirty.pieces[i], dirty.from[i]));
+        }
+        if (dirty.to[i] != Square::NONE) {
+            adds[add_count++] =
+                featureRow(net, featureIndex(perspective, king, dirty.pieces[i], dirty.to[i]));
+        }
+    }
+
+    updateAccumulator(parent.values[toIdx(perspective)].data(),
+                      acc.values[toIdx(perspective)].data(), adds.data(), add_count, subs.data(),
+                      sub_count);
+    acc.computed[toIdx(perspective)] = true;
+}
+
+auto propagate(const Network& net, const Accumulator& acc, Color side_to_move) -> int
+{
+    const Color THEM = side_to_move == Color::WHITE ? Color::BLACK : Color::WHITE;
+
+    alignas(SIMD_ALIGNMENT) std::array<uint8_t, L1_INPUTS> inputs;
+    clipAccumulator(acc.values[toIdx(side_to_move)].data(), inputs.data());
+    clipAccumulator(acc.values[toIdx(THEM)].data(), inputs.data() + HIDDEN);
+
+    alignas(SIMD_ALIGNMENT) std::array<int32_t, L2> l1_sums;
+    alignas(SIMD_ALIGNMENT) std::array<uint8_t, L2> l1_outputs;
+    affine(inputs.data(), L1_INPUTS, net.l1_weights.data(), net.l1_biases.data(), l1_sums.data(),
+           L2);
+    clipLayer(l1_sums, l1_outputs);
+
+    alignas(SIMD_ALIGNMENT) std::array<int32_t, L3> l2_sums;
+    alignas(SIMD_ALIGNMENT) std::array<uint8_t, L3> l2_outputs;
+    affine(l1_outputs.data(), L2, net.l2_weights.data(), net.l2_biases.data(), l2_sums.data(), L3);
+    clipLayer(l2_sums, l2_outputs);
+
+    int32_t output = 0;
+    affine(l2_outputs.data(), L3, net.output_weights.data(), &net.output_bias, &output, 1);
+    return output / OUTPUT_SCALE;
+}
+
+} // namespace
+
+auto load(const std::string& path, Network& net) -> bool
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) { return false; }
+
+    const auto FILE_SIZE = static_cast<std::size_t>(file.tellg());
+    if (FILE_SIZE != sizeof(FileHeader) + payloadSize()) { return false; }
+    file.seekg(0);
+
+    FileHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != EXPECTED_HEADER.magic ||
+        header.version != EXPECTED_HEADER.version || header.features != EXPECTED_HEADER.features ||
+        header.hidden != EXPECTED_HEADER.hidden || header.l2 != EXPECTED_HEADER.l2 ||
+        header.l3 != EXPECTED_HEADER.l3) {
+        return false;
+    }
+
+    // The size was checked up front, so a failed read here is an I/O error, not a bad file
+    forEachArray(net, [&file](void* data, std::size_t size) {
+        file.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+    });
+    return static_cast<bool>(file);
+}
+
+auto save(const std::string& path, const Network& net) -> bool
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) { return false; }
+
+    file.write(reinterpret_cast<const char*>(&EXPECTED_HEADER), sizeof(EXPECTED_HEADER));
+    forEachArray(net, [&file](const void* data, std::size_t size) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    });
+    return static_cast<bool>(file);
+}
+
+auto randomize(Network& net, uint64_t seed) -> void
+{
+    // Ranges keep the accumulators well inside int16 and the layers away from saturation
+    constexpr int FEATURE_RANGE = 32;
+    constexpr int LAYER_RANGE = 64;
+    constexpr int BIAS_RANGE = 1024;
+
+    std::mt19937_64 rng(seed);
+    const auto UNIFORM = [&rng](int range) {
+        return std::uniform_int_distribution<int>(-range, range)(rng);
+    };
+
+    for (auto& bias : net.feature_biases) { bias = static_cast<int16_t>(UNIFORM(FEATURE_RANGE)); }
+    for (auto& weight : net.feature_weights) {
+        weight = static_cast<int16_t>(UNIFORM(FEATURE_RANGE));
+    }
+    for (auto& bias : net.l1_biases) { bias = UNIFORM(BIAS_RANGE); }
+    for (auto& weight : net.l1_weights) { weight = static_cast<int8_t>(UNIFORM(LAYER_RANGE)); }
+    for (auto& bias : net.l2_biases) { bias = UNIFORM(BIAS_RANGE); }
+    for (auto& weight : net.l2_weights) { weight = static_cast<int8_t>(UNIFORM(LAYER_RANGE)); }
+    for (auto& weight : net.output_weights) { weight = static_cast<int8_t>(UNIFORM(LAYER_RANGE)); }
+    net.output_bias = UNIFORM(BIAS_RANGE);
+}
+
+auto AccumulatorStack::reset() -> void
+{
+    m_top = 0;
+    m_stack[0].computed = {false, false};
+    m_stack[0].refresh = {true, true};
+    m_stack[0].dirty.count = 0;
+}
+
+auto AccumulatorStack::push(const Position& pos, Move move) -> void
+{
+    assert(m_top + 1 < m_stack.size() && "accumulator stack overflow");
+
+    Accumulator& acc = m_stack[++m_top];
+    acc.computed = {false, false};
+    acc.refresh = {false, false};
+
+    DirtyPieces& dirty = acc.dirty;
+    dirty.count = 0;
+    const auto ADD = [&dirty](Piece piece, Square from, Square to) {
+        dirty.pieces[dirty.count] = piece;
+        dirty.from[dirty.count] = from;
+        dirty.to[dirty.count] = to;
+        ++dirty.count;
+    };
+
+    const Square FROM = move.from();
+    const Square TO = move.to();
+    const Piece PIECE = pos.pieceAt(FROM);
+    const Color US = pos.getSideToMove();
+
+    if (getPieceType(PIECE) == PieceType::KING) { acc.refresh[toIdx(US)] = true; }
+    else if (move.isPromotion()) {
+        ADD(PIECE, FROM, Square::NONE);
+        ADD(makePiece(move.promotionType(), US), Square::NONE, TO);
+    }
+    else {
+        ADD(PIECE, FROM, TO);
+    }
+
+    if (move.isCastle()) {
+        // The rook is the only feature that moves; its squares follow the king's destination
+        const bool KINGSIDE = move.flag() == MoveFlag::KING_CASTLE;
+        const Square ROOK_FROM = offsetSquare(TO, KINGSIDE ? 1 : -2);
+        const Square ROOK_TO = offsetSquare(TO, KINGSIDE ? -1 : 1);
+        ADD(pos.pieceAt(ROOK_FROM), ROOK_FROM, ROOK_TO);
+    }
+    else if (move.isCapture()) {
+        const int PUSH = US == Color::WHITE ? Constants::Board::LENGTH : -Constants::Board::LENGTH;
+        const Square CAPTURE_SQUARE = move.isEnPassant() ? offsetSquare(TO, -PUSH) : TO;
+        ADD(pos.pieceAt(CAPTURE_SQUARE), CAPTURE_SQUARE, Square::NONE);
+    }
+}
+
+auto AccumulatorStack::pushNull() -> void
+{
+    assert(m_top + 1 < m_stack.size() && "accumulator stack overflow");
+
+    Accumulator& acc = m_stack[++m_top];
+    acc.computed = {false, false};
+    acc.refresh = {false, false};
+    acc.dirty.count = 0;
+}
+
+auto AccumulatorStack::pop() -> void
+{
+    assert(m_top > 0 && "pop without a matching push");
+    --m_top;
+}
+
+auto AccumulatorStack::update(const Network& net, const Position& pos) -> const Accumulator&
+{
+    Accumulator& top = m_stack[m_top];
+
+    UNROLL_LOOP
+    for (uint8_t color = 0; color < Constants::Board::COLOR_COUNT; ++color) {
+        if (top.computed[color]) { continue; }
+        const Color PERSPECTIVE = fromIdx<Color>(color);
+
+        // The king has not moved since the nearest computed ancestor unless a refresh is flagged
+        // on the way there; in that case rebuilding the top from the position is cheapest
+        std::size_t base = m_top;
+        while (!m_stack[base].computed[color] && !m_stack[base].refresh[color]) { --base; }
+
+        if (!m_stack[base].computed[color]) {
+            refresh(net, pos, PERSPECTIVE, top);
+            continue;
+        }
+
+        const Square KING = pos.kingSquare(PERSPECTIVE);
+        for (std::size_t ply = base + 1; ply <= m_top; ++ply) {
+            applyDirty(net, m_stack[ply - 1], m_stack[ply], PERSPECTIVE, KING);
+        }
+    }
+    return top;
+}
+
+auto evaluate(const Network& net, const Position& pos, AccumulatorStack& stack) -> int
+{
+    return propagate(net, stack.update(net, pos), pos.getSideToMove());
+}
+
+auto evaluate(const Network& net, const Position& pos) -> int
+{
+    Accumulator acc{};
+    refresh(net, pos, Color::WHITE, acc);
+    refresh(net, pos, Color::BLACK, acc);
+    return propagate(net, acc, pos.getSideToMove());
+}
+
+} // namespace Chess::NNUE
@@ -0,0 +1,128 @@
+#include "pawns.h"
+
+#include "bitboard.h"
+#include "compiler_macros.h"
+
+namespace Chess::Pawns {
+
+using namespace Util;
+
+namespace {
+
+constexpr int LENGTH = Constants::Board::LENGTH;
+
+using SquareMasks = std::array<std::array<Bitboard, Constants::Board::SQUARE_COUNT>,
+                               Constants::Board::COLOR_COUNT>;
+
+// Files either side of each file
+constexpr auto makeAdjacentFiles() -> std::array<Bitboard, LENGTH>
+{
+    std::array<Bitboard, LENGTH> masks{};
+    for (int file = 0; file < LENGTH; ++file) {
+        if (file > 0) { masks[file] |= Bitboards::files[file - 1]; }
+        if (file < LENGTH - 1) { masks[file] |= Bitboards::files[file + 1]; }
+    }
+    return masks;
+}
+
+constexpr std::array<Bitboard, LENGTH> ADJACENT_FILES = makeAdjacentFiles();
+
+// Squares in front of each square from each side's point of view, on its own file only or on
+// its own and the adjacent files
+constexpr auto makeForwardMasks(bool include_adjacent) -> SquareMasks
+{
+    SquareMasks masks{};
+    for (int square = 0; square < Constants::Board::SQUARE_COUNT; ++square) {
+        const auto SQUARE = fromIdx<Square>(static_cast<uint8_t>(square));
+        const int FILE = getFile(SQUARE);
+        const Bitboard FILES =
+            Bitboards::files[FILE] | (include_adjacent ? ADJACENT_FILES[FILE] : 0);
+
+        for (int rank = getRank(SQUARE) + 1; rank < LENGTH; ++rank) {
+            masks[toIdx(Color::WHITE)][square] |= FILES & Bitboards::ranks[rank];
+        }
+        for (int rank = getRank(SQUARE) - 1; rank >= 0; --rank) {
+            masks[toIdx(Color::BLACK)][square] |= FILES & Bitboards::ranks[rank];
+        }
+    }
+    return masks;
+}
+
+constexpr SquareMasks FORWARD_FILE = makeForwardMasks(false);
+constexpr SquareMasks PASSED_SPAN = makeForwardMasks(true);
+
+// Squares on a king's file and the adjacent ones, `distance` ranks in front of it
+constexpr auto makeShieldMasks(int distance) -> SquareMasks
+{
+    SquareMasks masks{};
+    for (int square = 0; square < Constants::Board::SQUARE_COUNT; ++square) {
+        const auto SQUARE = fromIdx<Square>(static_cast<uint8_t>(square));
+        const Bitboard FILES = Bitboards::files[getFile(SQUARE)] | ADJACENT_FILES[getFile(SQUARE)];
+        const int WHITE_RANK = getRank(SQUARE) + distance;
+        const int BLACK_RANK = getRank(SQUARE) - distance;
+
+        if (WHITE_RANK < LENGTH) {
+            masks[toIdx(Color::WHITE)][square] = FILES & Bitboards::ranks[WHITE_RANK];
+        }
+        if (BLACK_RANK >= 0) {
+            masks[toIdx(Color::BLACK)][square] = FILES & Bitboards::ranks[BLACK_RANK];
+        }
+    }
+    return masks;
+}
+
+constexpr SquareMasks SHIELD_CLOSE_SQUARES = makeShieldMasks(1);
+constexpr SquareMasks SHIELD_FAR_SQUARES = makeShieldMasks(2);
+
+constexpr PSQT::Score DOUBLED = {-10, -40};
+constexpr PSQT::Score ISOLATED = {-5, -15};
+// By rank from the pawn's own side; the piece-square tables already reward advanced pawns
+constexpr std::array<PSQT::Score, LENGTH> PASSED = {
+    {{0, 0}, {0, 5}, {5, 10}, {10, 20}, {20, 35}, {40, 60}, {70, 90}, {0, 0}}};
+// Own pawns one and two ranks in front of the king, on its file and the adjacent ones
+constexpr PSQT::Score SHIELD_CLOSE = {12, 0};
+constexpr PSQT::Score SHIELD_FAR = {6, 0};
+
+auto evaluateSide(const Position& pos, Color us, Bitboard& passed) -> PSQT::Score
+{
+    const Color THEM = us == Color::WHITE ? Color::BLACK : Color::WHITE;
+    const Bitboard OURS = pos.pieces(us, PieceType::PAWN);
+    const Bitboard THEIRS = pos.pieces(THEM, PieceType::PAWN);
+
+    PSQT::Score score{0, 0};
+    passed = 0;
+
+    Bitboard pawns = OURS;
+    while (pawns != 0) {
+        const Square SQUARE = Bitboards::popSquare(pawns);
+        const int RANK = us == Color::WHITE ? getRank(SQUARE) : LENGTH - 1 - getRank(SQUARE);
+        const bool BLOCKED_BY_OWN = (OURS & FORWARD_FILE[toIdx(us)][toIdx(SQUARE)]) != 0;
+
+        if ((OURS & ADJACENT_FILES[toIdx(SQUARE) % LENGTH]) == 0) { score += ISOLATED; }
+        // Only the rear pawn of a doubled pair is penalised, and it can never be passed
+        if (BLOCKED_BY_OWN) { score += DOUBLED; }
+        else if ((THEIRS & PASSED_SPAN[toIdx(us)][toIdx(SQUARE)]) == 0) {
+            passed |= squareBB(SQUARE);
+            score += PASSED[RANK];
+        }
+    }
+
+    const auto KING = toIdx(pos.kingSquare(us));
+    const int CLOSE = Bitboards::popCount(OURS & SHIELD_CLOSE_SQUARES[toIdx(us)][KING]);
+    const int FAR = Bitboards::popCount(OURS & SHIELD_FAR_SQUARES[toIdx(us)][KING]);
+    score += {(SHIELD_CLOSE.mg * CLOSE) + (SHIELD_FAR.mg * FAR),
+              (SHIELD_CLOSE.eg * CLOSE) + (SHIELD_FAR.eg * FAR)};
+
+    return score;
+}
+
+} // namespace
+
+MULTIVERSION auto evaluate(const Position& pos, Entry& entry) -> void
+{
+    entry.key = pos.pawnKey();
+    entry.score = evaluateSide(pos, Color::WHITE, entry.passed[toIdx(Color::WHITE)]) -
+                  evaluateSide(pos, Color::BLACK, entry.passed[toIdx(Color::BLACK)]);
+}
+
+} // namespace Chess::Pawns
@@ -0,0 +1,76 @@
+#include "perft.h"
+
+#include "constants.h"
+#include "move.h"
+#include "movegen.h"
+
+namespace Chess::Perft {
+
+namespace {
+
+constexpr unsigned int DEPTH_BITS = 8;
+constexpr std::uint64_t DEPTH_MASK = (1ULL << DEPTH_BITS) - 1;
+constexpr std::size_t BYTES_PER_MEGABYTE = 1ULL << 20U;
+
+// Spreads equal keys at different depths over different slots
+constexpr std::uint64_t DEPTH_SALT = 0x9E3779B97F4A7C15ULL;
+
+} // namespace
+
+Table::Table(std::size_t megabytes) : m_mask(0)
+{
+    // Largest power of two that fits in the budget, so the slot index is a mask
+    std::size_t entries = 1;
+    while (entries * 2 * sizeof(Entry) <= megabytes * BYTES_PER_MEGABYTE) { entries *= 2; }
+
+    m_entries = std::vector<Entry>(entries);
+    m_mask = entries - 1;
+}
+
+auto Table::slot(HashKey key, int depth) const -> std::size_t
+{
+    return (key ^ (DEPTH_SALT * static_cast<std::uint64_t>(depth))) & m_mask;
+}
+
+auto Table::probe(HashKey key, int depth, std::uint64_t& nodes) const -> bool
+{
+    const Entry& entry = m_entries[slot(key, depth)];
+    const std::uint64_t DATA = entry.data.load(std::memory_order_relaxed);
+    const std::uint64_t CHECK = entry.check.load(std::memory_order_relaxed);
+
+    if ((CHECK ^ DATA) != key || (DATA & DEPTH_MASK) != static_cast<std::uint64_t>(depth)) {
+        return false;
+    }
+    nodes = DATA >> DEPTH_BITS;
+    return true;
+}
+
+auto Table::store(HashKey key, int depth, std::uint64_t nodes) -> void
+{
+    Entry& entry = m_entries[slot(key, depth)];
+    const std::uint64_t DATA = (nodes << DEPTH_BITS) | static_cast<std::uint64_t>(depth);
+    entry.check.store(key ^ DATA, std::memory_order_relaxed);
+    entry.data.store(DATA, std::memory_order_relaxed);
+}
+
+auto count(Position& pos, int depth, Table* table) -> std::uint64_t
+{
+    if (depth <= 0) { return 1; }
+
+    const MoveList MOVES = MoveGen::generateLegal(pos);
+    if (depth == 1) { return MOVES.size(); }
+
+    std::uint64_t nodes = 0;
+    if (table != nullptr && table->probe(pos.hash(), depth, nodes)) { return nodes; }
+
+    for (const Move MOVE : MOVES) {
+        pos.makeMove(MOVE);
+        nodes += count(pos, depth - 1, table);
+        pos.unmakeMove();
+    }
+
+    if (table != nullptr) { table->store(pos.hash(), depth, nodes); }
+    return nodes;
+}
+
+} // namespace Chess::Perft
@@ -1,12 +1,22 @@
 #include "position.h"
 
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
 
 #include "bitboard.h"
 #include "compiler_macros.h"
 #include "constants.h"
+#include "eval.h"
+#include "move.h"
+#include "packed.h"
+#include "psqt.h"
 #include "types.h"
 #include "zobrist.h"
 
@@ -14,20 +24,425 @@ namespace Chess {
 
 using namespace Util;
 
+namespace {
+
+constexpr std::size_t HISTORY_MASK = Constants::Game::HISTORY_SIZE - 1;
+
+// Castling rights that survive a move touching each square (king and rook origins)
+using CastlingMasks = std::array<CastlingRightsBitField, Constants::Board::SQUARE_COUNT>;
+
+constexpr auto makeCastlingMasks() -> CastlingMasks
+{
+    CastlingMasks masks{};
+    for (auto& mask : masks) { mask = toIdx(CastlingRight::ALL); }
+
+    masks[toIdx(Square::E1)] &= ~(toIdx(CastlingRight::WHITE_KINGSIDE) |
+                                  toIdx(CastlingRight::WHITE_QUEENSIDE));
+    masks[toIdx(Square::H1)] &= ~toIdx(CastlingRight::WHITE_KINGSIDE);
+    masks[toIdx(Square::A1)] &= ~toIdx(CastlingRight::WHITE_QUEENSIDE);
+    masks[toIdx(Square::E8)] &= ~(toIdx(CastlingRight::BLACK_KINGSIDE) |
+                                  toIdx(CastlingRight::BLACK_QUEENSIDE));
+    masks[toIdx(Square::H8)] &= ~toIdx(CastlingRight::BLACK_KINGSIDE);
+    masks[toIdx(Square::A8)] &= ~toIdx(CastlingRight::BLACK_QUEENSIDE);
+    return masks;
+}
+
+constexpr CastlingMasks CASTLING_MASKS = makeCastlingMasks();
+
+// Bitboard slots of a piece known not to be NONE, skipping the checks in the Util helpers
+constexpr auto colorSlot(Piece piece) -> std::size_t
+{
+    return toIdx(piece) / Constants::PIECE_COLOR_OFFSET;
+}
+constexpr auto typeSlot(Piece piece) -> std::size_t
+{
+    return (toIdx(piece) % Constants::PIECE_COLOR_OFFSET) - 1U;
+}
+
+constexpr auto offsetSquare(Square square, int delta) -> Square
+{
+    return fromIdx<Square>(static_cast<uint8_t>(toIdx(square) + delta));
+}
+
+// Rook origin and destination for a castling move, derived from the king's destination
+constexpr auto castlingRookSquares(Move move) -> std::pair<Square, Square>
+{
+    if (move.flag() == MoveFlag::KING_CASTLE) {
+        return {offsetSquare(move.to(), 1), offsetSquare(move.to(), -1)};
+    }
+    return {offsetSquare(move.to(), -2), offsetSquare(move.to(), 1)};
+}
+
+struct CastlingRook {
+    CastlingRight right;
+    char letter;
+    Color color;
+    Square king;
+    Square rook;
+};
+
+// Each castling right in FEN order, with the pieces it needs on their original squares
+constexpr std::array<CastlingRook, 4> CASTLING_ROOKS = {{
+    {CastlingRight::WHITE_KINGSIDE, 'K', Color::WHITE, Square::E1, Square::H1},
+    {CastlingRight::WHITE_QUEENSIDE, 'Q', Color::WHITE, Square::E1, Square::A1},
+    {CastlingRight::BLACK_KINGSIDE, 'k', Color::BLACK, Square::E8, Square::H8},
+    {CastlingRight::BLACK_QUEENSIDE, 'q', Color::BLACK, Square::E8, Square::A8},
+}};
+
+constexpr auto castlingRightFromChar(char chr) -> CastlingRightsBitField
+{
+    switch (chr) {
+        case 'K': return toIdx(CastlingRight::WHITE_KINGSIDE);
+        case 'Q': return toIdx(CastlingRight::WHITE_QUEENSIDE);
+        case 'k': return toIdx(CastlingRight::BLACK_KINGSIDE);
+        case 'q': return toIdx(CastlingRight::BLACK_QUEENSIDE);
+        default: return 0;
+    }
+}
+
+// FEN letter of each Piece value
+constexpr std::string_view FEN_LETTERS = ".PNBRQK..pnbrqk";
+
+// Pieces by FEN letter; every other character maps to NONE
+constexpr auto makeFenPieces() -> std::array<Piece, 256>
+{
+    std::array<Piece, 256> pieces{};
+    for (uint8_t piece = 1; piece < FEN_LETTERS.size(); ++piece) {
+        if (FEN_LETTERS[piece] != '.') {
+            pieces[static_cast<unsigned char>(FEN_LETTERS[piece])] = fromIdx<Piece>(piece);
+        }
+    }
+    return pieces;
+}
+
+constexpr std::array<Piece, 256> FEN_PIECES = makeFenPieces();
+
+constexpr auto isFenBlank(char chr) -> bool
+{
+    return chr == ' ' || chr == '\t' || chr == '\r' || chr == '\n';
+}
+
+// The next blank-separated field from `cursor`, which is advanced past it; empty at the end
+constexpr auto nextFenField(std::string_view fen, std::size_t& cursor) -> std::string_view
+{
+    while (cursor < fen.size() && isFenBlank(fen[cursor])) { ++cursor; }
+    const std::size_t START = cursor;
+    while (cursor < fen.size() && !isFenBlank(fen[cursor])) { ++cursor; }
+    return fen.substr(START, cursor - START);
+}
+
+// A non-negative decimal filling the whole field
+auto parseFenCounter(std::string_view field, int& value) -> bool
+{
+    const char* const END = field.data() + field.size();
+    const auto [LAST, STATUS] = std::from_chars(field.data(), END, value);
+    return STATUS == std::errc() && LAST == END && value >= 0;
+}
+
+// Layout of `PackedPosition::pieces` and `PackedPosition::state`
+constexpr int PACKED_PIECE_BITS = 4;
+constexpr uint8_t PACKED_PIECE_MASK = (1U << PACKED_PIECE_BITS) - 1;
+constexpr uint8_t PACKED_BLACK_TO_MOVE = 1;
+
+} // namespace
+
+// A board and game state assembled by a loader, for `Position::setUp` to validate and commit.
+// The keys and evaluation terms are accumulated as pieces are placed instead of rescanning.
+struct PositionSetup {
+    std::array<Piece, Constants::Board::SQUARE_COUNT> squares{};
+    std::array<std::array<Bitboard, Constants::Board::PIECE_TYPE_COUNT>,
+               Constants::Board::COLOR_COUNT>
+        boards{};
+    std::array<Bitboard, Constants::Board::COLOR_COUNT> colors{};
+    std::array<int, Constants::Zobrist::PIECE_COUNT> counts{};
+    HashKey hash = 0;
+    HashKey pawn_key = 0;
+    HashKey material_key = 0;
+    PSQT::Score psqt{0, 0};
+    int phase = 0;
+
+    Color side_to_move = Color::WHITE;
+    CastlingRightsBitField castling_rights = 0;
+    Square en_passant = Square::NONE;
+    int halfmove_clock = 0;
+    int fullmove_number = 1;
+
+    // Fails on more of a kind than promotions could ever produce, which has no material key
+    auto place(Piece piece, Square square) -> bool
+    {
+        int& count = counts[toIdx(piece)];
+        if (count == Constants::Zobrist::MAX_PIECES_PER_TYPE) { return false; }
+
+        const HashKey KEY = Zobrist::getPieceSquareKey(piece, square);
+        const PieceType TYPE = getPieceType(piece);
+        squares[toIdx(square)] = piece;
+        boards[colorSlot(piece)][typeSlot(piece)] |= squareBB(square);
+        colors[colorSlot(piece)] |= squareBB(square);
+        hash ^= KEY;
+        if (TYPE == PieceType::PAWN || TYPE == PieceType::KING) { pawn_key ^= KEY; }
+        material_key ^= Zobrist::getMaterialKey(piece, count++);
+        psqt += PSQT::value(piece, square);
+        phase += PSQT::phaseWeight(TYPE);
+        return true;
+    }
+};
+
+auto fenErrorToString(FenError error) -> std::string_view
+{
+    switch (error) {
+        case FenError::NONE: return "no error";
+        case FenError::PIECE_PLACEMENT: return "malformed piece placement";
+        case FenError::SIDE_TO_MOVE: return "side to move is not 'w' or 'b'";
+        case FenError::CASTLING: return "invalid castling rights";
+        case FenError::EN_PASSANT: return "invalid en passant square";
+        case FenError::MOVE_COUNTERS: return "malformed move counters";
+        case FenError::KING_COUNT: return "each side needs exactly one king";
+        case FenError::PIECE_COUNT: return "more pieces than promotions allow";
+        case FenError::PAWN_RANK: return "pawn on the first or last rank";
+        case FenError::OPPONENT_IN_CHECK: return "side not to move is in check";
+    }
+    return "unknown error";
+}
+
 Position::Position() : Position("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1") {}
 
 Position::Position(const std::string& fen)
     : m_piece_bitboards(), m_color_bitboards(), m_pieces(), m_side_to_move(Color::WHITE),
       m_castling_rights(0), m_en_passant_square(Square::NONE), m_halfmove_clock(0),
-      m_fullmove_number(1)
+      m_fullmove_number(1), m_history_size(0)
 {
+    // The same FEN must hash the same whichever loader read it
+    if (fromFen(fen) == FenError::NONE) { return; }
+
     std::istringstream iss(fen);
 
     parseFenPiecePlacement(iss);
     parseFenGameState(iss);
+    refreshState();
+}
 
-    // NOLINTNEXTLINE(cppcoreguidelines-prefer-member-initializer) - Must be init last
-    m_position_hash = computeHash();
+auto Position::fromFen(std::string_view fen) -> FenError
+{
+    constexpr int LENGTH = Constants::Board::LENGTH;
+
+    PositionSetup setup;
+    std::size_t cursor = 0;
+
+    // 1. Piece placement, from the eighth rank down
+    int file = 0;
+    int rank = Constants::Board::MAX_RANK;
+    for (const char CHR : nextFenField(fen, cursor)) {
+        const Piece PIECE = FEN_PIECES[static_cast<unsigned char>(CHR)];
+        if (PIECE != Piece::NONE) {
+            if (file >= LENGTH) { return FenError::PIECE_PLACEMENT; }
+            const auto SQUARE = fromIdx<Square>(static_cast<uint8_t>((rank * LENGTH) + file++));
+            if (!setup.place(PIECE, SQUARE)) { return FenError::PIECE_COUNT; }
+        }
+        else if (CHR >= '1' && CHR <= '8') {
+            file += CHR - '0';
+            if (file > LENGTH) { return FenError::PIECE_PLACEMENT; }
+        }
+        else if (CHR == '/' && file == LENGTH && rank > 0) {
+            file = 0;
+            --rank;
+        }
+        else {
+            return FenError::PIECE_PLACEMENT;
+        }
+    }
+    if (file != LENGTH || rank != 0) { return FenError::PIECE_PLACEMENT; }
+
+    // 2. Active color
+    const std::string_view SIDE = nextFenField(fen, cursor);
+    if (SIDE != "w" && SIDE != "b") { return FenError::SIDE_TO_MOVE; }
+    setup.side_to_move = SIDE == "w" ? Color::WHITE : Color::BLACK;
+
+    // 3. Castling availability, each right at most once
+    const std::string_view CASTLING = nextFenField(fen, cursor);
+    if (CASTLING.empty()) { return FenError::CASTLING; }
+    if (CASTLING != "-") {
+        for (const char CHR : CASTLING) {
+            const CastlingRightsBitField RIGHT = castlingRightFromChar(CHR);
+            if (RIGHT == 0 || (setup.castling_rights & RIGHT) != 0) { return FenError::CASTLING; }
+            setup.castling_rights |= RIGHT;
+        }
+    }
+
+    // 4. En passant target square; `setUp` checks its rank
+    const std::string_view EN_PASSANT = nextFenField(fen, cursor);
+    if (EN_PASSANT != "-") {
+        if (EN_PASSANT.size() != 2 || EN_PASSANT[0] < 'a' || EN_PASSANT[0] > 'h' ||
+            EN_PASSANT[1] < '1' || EN_PASSANT[1] > '8') {
+            return FenError::EN_PASSANT;
+        }
+        setup.en_passant = makeSquare(EN_PASSANT[0] - 'a', EN_PASSANT[1] - '1');
+    }
+
+    // 5. and 6. Halfmove clock and fullmove number, optional, then nothing else
+    const std::string_view HALFMOVE = nextFenField(fen, cursor);
+    const std::string_view FULLMOVE = nextFenField(fen, cursor);
+    if ((!HALFMOVE.empty() && !parseFenCounter(HALFMOVE, setup.halfmove_clock)) ||
+        (!FULLMOVE.empty() && !parseFenCounter(FULLMOVE, setup.fullmove_number)) ||
+        !nextFenField(fen, cursor).empty()) {
+        return FenError::MOVE_COUNTERS;
+    }
+
+    return setUp(setup);
+}
+
+auto Position::fromPacked(const PackedPosition& packed) -> FenError
+{
+    PositionSetup setup;
+
+    Bitboard occupancy = packed.occupancy;
+    if (Bitboards::popCount(occupancy) > Constants::Packed::MAX_PIECES) {
+        return FenError::PIECE_PLACEMENT;
+    }
+    for (std::size_t index = 0; occupancy != 0; ++index) {
+        const Square SQUARE = Bitboards::popSquare(occupancy);
+        const auto CODE = static_cast<uint8_t>(
+            (packed.pieces[index / 2] >> (PACKED_PIECE_BITS * (index % 2))) & PACKED_PIECE_MASK);
+        if (CODE >= FEN_LETTERS.size() || FEN_LETTERS[CODE] == '.') {
+            return FenError::PIECE_PLACEMENT;
+        }
+        if (!setup.place(fromIdx<Piece>(CODE), SQUARE)) { return FenError::PIECE_COUNT; }
+    }
+
+    setup.side_to_move = (packed.state & PACKED_BLACK_TO_MOVE) != 0 ? Color::BLACK : Color::WHITE;
+    setup.castling_rights =
+        static_cast<CastlingRightsBitField>((packed.state >> 1) & toIdx(CastlingRight::ALL));
+    if (toIdx(packed.en_passant) > toIdx(Square::NONE)) { return FenError::EN_PASSANT; }
+    setup.en_passant = packed.en_passant;
+    setup.halfmove_clock = packed.halfmove_clock;
+    setup.fullmove_number = packed.fullmove_number;
+
+    return setUp(setup);
+}
+
+auto Position::setUp(PositionSetup& setup) -> FenError
+{
+    constexpr int LENGTH = Constants::Board::LENGTH;
+
+    const auto& squares = setup.squares;
+    const Color US = setup.side_to_move;
+    const Color THEM = US == Color::WHITE ? Color::BLACK : Color::WHITE;
+
+    const auto BOARD = [&setup](Color color, PieceType type) {
+        return setup.boards[toIdx(color)][toIdx(type) - 1];
+    };
+    const auto COUNT = [&setup](Color color, PieceType type) {
+        return setup.counts[toIdx(makePiece(type, color))];
+    };
+
+    for (const Color COLOR : {Color::WHITE, Color::BLACK}) {
+        if (COUNT(COLOR, PieceType::KING) != 1) { return FenError::KING_COUNT; }
+
+        // Pieces beyond the starting set must have come from promoted pawns
+        const auto EXTRA = [&COUNT, COLOR](PieceType type, int initial) {
+            return std::max(COUNT(COLOR, type) - initial, 0);
+        };
+        const int PROMOTED = EXTRA(PieceType::KNIGHT, 2) + EXTRA(PieceType::BISHOP, 2) +
+                             EXTRA(PieceType::ROOK, 2) + EXTRA(PieceType::QUEEN, 1);
+        if (COUNT(COLOR, PieceType::PAWN) + PROMOTED > LENGTH) { return FenError::PIECE_COUNT; }
+    }
+
+    const Bitboard BACK_RANKS =
+        Bitboards::ranks[0] | Bitboards::ranks[Constants::Board::MAX_RANK];
+    if (((BOARD(Color::WHITE, PieceType::PAWN) | BOARD(Color::BLACK, PieceType::PAWN)) &
+         BACK_RANKS) != 0) {
+        return FenError::PAWN_RANK;
+    }
+
+    for (const CastlingRook& castling : CASTLING_ROOKS) {
+        if ((setup.castling_rights & toIdx(castling.right)) != 0 &&
+            (squares[toIdx(castling.king)] != makePiece(PieceType::KING, castling.color) ||
+             squares[toIdx(castling.rook)] != makePiece(PieceType::ROOK, castling.color))) {
+            return FenError::CASTLING;
+        }
+    }
+
+    Square& en_passant = setup.en_passant;
+    if (en_passant != Square::NONE) {
+        // The target is on the side to move's sixth rank. The pawn that just double-pushed sits
+        // in front of it, and it is empty along with the square the pawn started from.
+        const int EP_RANK = US == Color::WHITE ? LENGTH - 3 : 2;
+        const int PUSH = US == Color::WHITE ? LENGTH : -LENGTH;
+        if (getRank(en_passant) != EP_RANK ||
+            squares[toIdx(offsetSquare(en_passant, -PUSH))] != makePiece(PieceType::PAWN, THEM) ||
+            squares[toIdx(en_passant)] != Piece::NONE ||
+            squares[toIdx(offsetSquare(en_passant, PUSH))] != Piece::NONE) {
+            return FenError::EN_PASSANT;
+        }
+        if ((Bitboards::pawnAttacks(THEM, en_passant) & BOARD(US, PieceType::PAWN)) == 0) {
+            en_passant = Square::NONE;
+        }
+    }
+
+    // The side that just moved cannot have left its king in check
+    const Square KING = Bitboards::lsb(BOARD(THEM, PieceType::KING));
+    const Bitboard OCCUPIED = setup.colors[toIdx(Color::WHITE)] | setup.colors[toIdx(Color::BLACK)];
+    const Bitboard QUEENS = BOARD(US, PieceType::QUEEN);
+    const Bitboard CHECKERS =
+        (Bitboards::pawnAttacks(THEM, KING) & BOARD(US, PieceType::PAWN)) |
+        (Bitboards::knightAttacks(KING) & BOARD(US, PieceType::KNIGHT)) |
+        (Bitboards::kingAttacks(KING) & BOARD(US, PieceType::KING)) |
+        (Bitboards::bishopAttacks(KING, OCCUPIED) & (BOARD(US, PieceType::BISHOP) | QUEENS)) |
+        (Bitboards::rookAttacks(KING, OCCUPIED) & (BOARD(US, PieceType::ROOK) | QUEENS));
+    if (CHECKERS != 0) { return FenError::OPPONENT_IN_CHECK; }
+
+    HashKey hash = setup.hash;
+    if (US == Color::BLACK) { hash ^= Zobrist::getSideToMoveKey(); }
+    hash ^= Zobrist::getCastlingKey(setup.castling_rights);
+    if (en_passant != Square::NONE) { hash ^= Zobrist::getEnPassantKey(en_passant); }
+
+    m_pieces = squares;
+    m_piece_bitboards = setup.boards;
+    m_color_bitboards = setup.colors;
+    m_side_to_move = US;
+    m_castling_rights = setup.castling_rights;
+    m_en_passant_square = en_passant;
+    m_halfmove_clock = setup.halfmove_clock;
+    m_fullmove_number = setup.fullmove_number;
+    m_history_size = 0;
+    m_position_hash = hash;
+    m_pawn_key = setup.pawn_key;
+    m_material_key = setup.material_key;
+    m_psqt = setup.psqt;
+    m_phase = setup.phase;
+
+    assert(m_position_hash == computeHash() && "hash accumulated by setUp is wrong");
+    assert(m_pawn_key == computePawnKey() && "pawn key accumulated by setUp is wrong");
+    assert(m_material_key == computeMaterialKey() && "material key accumulated by setUp is wrong");
+    assert(m_psqt == computePsqt() && "psqt accumulated by setUp is wrong");
+    assert(m_phase == computePhase() && "phase accumulated by setUp is wrong");
+
+    return FenError::NONE;
+}
+
+auto Position::pack(PackedPosition& out) const -> bool
+{
+    if (m_halfmove_clock > std::numeric_limits<uint8_t>::max() ||
+        m_fullmove_number > std::numeric_limits<uint16_t>::max()) {
+        return false;
+    }
+
+    out.occupancy = occupied();
+    out.pieces = {};
+    Bitboard occupancy = out.occupancy;
+    for (std::size_t index = 0; occupancy != 0; ++index) {
+        const Piece PIECE = m_pieces[toIdx(Bitboards::popSquare(occupancy))];
+        out.pieces[index / 2] |=
+            static_cast<uint8_t>(toIdx(PIECE) << (PACKED_PIECE_BITS * (index % 2)));
+    }
+
+    out.state = static_cast<uint8_t>((m_side_to_move == Color::BLACK ? PACKED_BLACK_TO_MOVE : 0) |
+                                     (m_castling_rights << 1));
+    out.en_passant = m_en_passant_square;
+    out.halfmove_clock = static_cast<uint8_t>(m_halfmove_clock);
+    out.result = GameResult::NONE;
+    out.fullmove_number = static_cast<uint16_t>(m_fullmove_number);
+    out.score = Constants::Packed::SCORE_NONE;
+    return true;
 }
 
 auto Position::pieceAt(Square square) const -> Piece
@@ -70,14 +485,341 @@ auto Position::getFullmoveNumber() const -> int { return m_fullmove_number; }
 
 auto Position::hash() const -> HashKey { return m_position_hash; }
 
+auto Position::pawnKey() const -> HashKey { return m_pawn_key; }
+
+auto Position::materialKey() const -> HashKey { return m_material_key; }
+
+auto Position::makeMove(Move move) -> void
+{
+    const Color US = m_side_to_move;
+    const Color THEM = US == Color::WHITE ? Color::BLACK : Color::WHITE;
+    const Square FROM = move.from();
+    const Square TO = move.to();
+    const Piece PIECE = m_pieces[toIdx(FROM)];
+    const int PUSH = US == Color::WHITE ? Constants::Board::LENGTH : -Constants::Board::LENGTH;
+
+    UndoInfo& undo = m_history[m_history_size++ & HISTORY_MASK];
+    undo.hash = m_position_hash;
+    undo.pawn_key = m_pawn_key;
+    undo.material_key = m_material_key;
+    undo.psqt = m_psqt;
+    undo.phase = m_phase;
+    undo.move = move;
+    undo.captured = Piece::NONE;
+    undo.castling_rights = m_castling_rights;
+    undo.en_passant_square = m_en_passant_square;
+    undo.halfmove_clock = static_cast<uint16_t>(m_halfmove_clock);
+
+    HashKey hash = m_position_hash ^ Zobrist::getSideToMoveKey();
+    if (m_en_passant_square != Square::NONE) {
+        hash ^= Zobrist::getEnPassantKey(m_en_passant_square);
+        m_en_passant_square = Square::NONE;
+    }
+    ++m_halfmove_clock;
+
+    if (move.isCastle()) {
+        const auto [ROOK_FROM, ROOK_TO] = castlingRookSquares(move);
+        const Piece ROOK = m_pieces[toIdx(ROOK_FROM)];
+        movePiece(FROM, TO);
+        movePiece(ROOK_FROM, ROOK_TO);
+        hash ^= Zobrist::getPieceSquareKey(PIECE, FROM) ^ Zobrist::getPieceSquareKey(PIECE, TO) ^
+                Zobrist::getPieceSquareKey(ROOK, ROOK_FROM) ^
+                Zobrist::getPieceSquareKey(ROOK, ROOK_TO);
+        m_psqt += PSQT::value(PIECE, TO) - PSQT::value(PIECE, FROM) + PSQT::value(ROOK, ROOK_TO) -
+                  PSQT::value(ROOK, ROOK_FROM);
+        m_pawn_key ^=
+            Zobrist::getPieceSquareKey(PIECE, FROM) ^ Zobrist::getPieceSquareKey(PIECE, TO);
+    }
+    else {
+        if (move.isCapture()) {
+            const Square CAPTURE_SQUARE = move.isEnPassant() ? offsetSquare(TO, -PUSH) : TO;
+            undo.captured = m_pieces[toIdx(CAPTURE_SQUARE)];
+            removePiece(CAPTURE_SQUARE);
+            hash ^= Zobrist::getPieceSquareKey(undo.captured, CAPTURE_SQUARE);
+            m_material_key ^= Zobrist::getMaterialKey(undo.captured, pieceCount(undo.captured));
+            m_psqt -= PSQT::value(undo.captured, CAPTURE_SQUARE);
+            if (getPieceType(undo.captured) == PieceType::PAWN) {
+                m_pawn_key ^= Zobrist::getPieceSquareKey(undo.captured, CAPTURE_SQUARE);
+            }
+            m_phase -= PSQT::phaseWeight(getPieceType(undo.captured));
+            m_halfmove_clock = 0;
+        }
+
+        movePiece(FROM, TO);
+        hash ^= Zobrist::getPieceSquareKey(PIECE, FROM) ^ Zobrist::getPieceSquareKey(PIECE, TO);
+        m_psqt += PSQT::value(PIECE, TO) - PSQT::value(PIECE, FROM);
+        const PieceType TYPE = getPieceType(PIECE);
+        if (TYPE == PieceType::PAWN || TYPE == PieceType::KING) {
+            m_pawn_key ^=
+                Zobrist::getPieceSquareKey(PIECE, FROM) ^ Zobrist::getPieceSquareKey(PIECE, TO);
+        }
+
+        if (TYPE == PieceType::PAWN) {
+            m_halfmove_clock = 0;
+
+            if (move.isPromotion()) {
+                const Piece PROMOTED = makePiece(move.promotionType(), US);
+                removePiece(TO);
+                putPiece(PROMOTED, TO);
+                m_material_key ^= Zobrist::getMaterialKey(PIECE, pieceCount(PIECE)) ^
+                                  Zobrist::getMaterialKey(PROMOTED, pieceCount(PROMOTED) - 1);
+                hash ^= Zobrist::getPieceSquareKey(PIECE, TO) ^
+                        Zobrist::getPieceSquareKey(PROMOTED, TO);
+                m_psqt += PSQT::value(PROMOTED, TO) - PSQT::value(PIECE, TO);
+                m_phase += PSQT::phaseWeight(move.promotionType());
+                m_pawn_key ^= Zobrist::getPieceSquareKey(PIECE, TO);
+            }
+            else if (move.flag() == MoveFlag::DOUBLE_PAWN_PUSH) {
+                // Only record en passant when a capture is possible, so transpositions hash alike
+                const Square EP_SQUARE = offsetSquare(FROM, PUSH);
+                if ((Bitboards::pawnAttacks(US, EP_SQUARE) & pieces(THEM, PieceType::PAWN)) != 0) {
+                    m_en_passant_square = EP_SQUARE;
+                    hash ^= Zobrist::getEnPassantKey(EP_SQUARE);
+                }
+            }
+        }
+    }
+
+    const CastlingRightsBitField RIGHTS =
+        m_castling_rights & CASTLING_MASKS[toIdx(FROM)] & CASTLING_MASKS[toIdx(TO)];
+    if (RIGHTS != m_castling_rights) {
+        hash ^= Zobrist::getCastlingKey(m_castling_rights) ^ Zobrist::getCastlingKey(RIGHTS);
+        m_castling_rights = RIGHTS;
+    }
+
+    if (US == Color::BLACK) { ++m_fullmove_number; }
+    m_side_to_move = THEM;
+    m_position_hash = hash;
+
+    assert(m_position_hash == computeHash() && "incremental hash diverged after makeMove");
+    assert(m_pawn_key == computePawnKey() && "incremental pawn key diverged after makeMove");
+    assert(m_material_key == computeMaterialKey() &&
+           "incremental material key diverged after makeMove");
+    assert(m_psqt == computePsqt() && "incremental psqt diverged after makeMove");
+    assert(m_phase == computePhase() && "incremental phase diverged after makeMove");
+}
+
+auto Position::unmakeMove() -> void
+{
+    assert(m_history_size > 0 && "unmakeMove without a matching makeMove");
+
+    const UndoInfo& undo = m_history[--m_history_size & HISTORY_MASK];
+    const Move MOVE = undo.move;
+    const Color US = m_side_to_move == Color::WHITE ? Color::BLACK : Color::WHITE;
+    const Square FROM = MOVE.from();
+    const Square TO = MOVE.to();
+    const int PUSH = US == Color::WHITE ? Constants::Board::LENGTH : -Constants::Board::LENGTH;
+
+    if (MOVE.isCastle()) {
+        const auto [ROOK_FROM, ROOK_TO] = castlingRookSquares(MOVE);
+        movePiece(TO, FROM);
+        movePiece(ROOK_TO, ROOK_FROM);
+    }
+    else {
+        if (MOVE.isPromotion()) {
+            removePiece(TO);
+            putPiece(makePiece(PieceType::PAWN, US), TO);
+        }
+        movePiece(TO, FROM);
+
+        if (MOVE.isCapture()) {
+            putPiece(undo.captured, MOVE.isEnPassant() ? offsetSquare(TO, -PUSH) : TO);
+        }
+    }
+
+    if (US == Color::BLACK) { --m_fullmove_number; }
+    m_side_to_move = US;
+    m_castling_rights = undo.castling_rights;
+    m_en_passant_square = undo.en_passant_square;
+    m_halfmove_clock = undo.halfmove_clock;
+    m_position_hash = undo.hash;
+    m_pawn_key = undo.pawn_key;
+    m_material_key = undo.material_key;
+    m_psqt = undo.psqt;
+    m_phase = undo.phase;
+
+    assert(m_position_hash == computeHash() && "hash mismatch after unmakeMove");
+    assert(m_psqt == computePsqt() && "psqt mismatch after unmakeMove");
+}
+
+auto Position::lastMove() const -> Move
+{
+    if (m_history_size == 0) { return Move(); }
+    return m_history[(m_history_size - 1) & HISTORY_MASK].move;
+}
+
+auto Position::makeNullMove() -> void
+{
+    UndoInfo& undo = m_history[m_history_size++ & HISTORY_MASK];
+    undo.hash = m_position_hash;
+    undo.pawn_key = m_pawn_key;
+    undo.material_key = m_material_key;
+    undo.psqt = m_psqt;
+    undo.phase = m_phase;
+    undo.move = Move();
+    undo.captured = Piece::NONE;
+    undo.castling_rights = m_castling_rights;
+    undo.en_passant_square = m_en_passant_square;
+    undo.halfmove_clock = static_cast<uint16_t>(m_halfmove_clock);
+
+    m_position_hash ^= Zobrist::getSideToMoveKey();
+    if (m_en_passant_square != Square::NONE) {
+        m_position_hash ^= Zobrist::getEnPassantKey(m_en_passant_square);
+        m_en_passant_square = Square::NONE;
+    }
+    ++m_halfmove_clock;
+    m_side_to_move = m_side_to_move == Color::WHITE ? Color::BLACK : Color::WHITE;
+
+    assert(m_position_hash == computeHash() && "incremental hash diverged after makeNullMove");
+}
+
+auto Position::unmakeNullMove() -> void
+{
+    assert(m_history_size > 0 && "unmakeNullMove without a matching makeNullMove");
+
+    const UndoInfo& undo = m_history[--m_history_size & HISTORY_MASK];
+    m_side_to_move = m_side_to_move == Color::WHITE ? Color::BLACK : Color::WHITE;
+    m_en_passant_square = undo.en_passant_square;
+    m_halfmove_clock = undo.halfmove_clock;
+    m_position_hash = undo.hash;
+}
+
+auto Position::attackersTo(Square square, Bitboard occupied) const -> Bitboard
+{
+    const Bitboard QUEENS = pieces(PieceType::QUEEN);
+
+    return (Bitboards::pawnAttacks(Color::BLACK, square) & pieces(Color::WHITE, PieceType::PAWN)) |
+           (Bitboards::pawnAttacks(Color::WHITE, square) & pieces(Color::BLACK, PieceType::PAWN)) |
+           (Bitboards::knightAttacks(square) & pieces(PieceType::KNIGHT)) |
+           (Bitboards::kingAttacks(square) & pieces(PieceType::KING)) |
+           (Bitboards::bishopAttacks(square, occupied) & (pieces(PieceType::BISHOP) | QUEENS)) |
+           (Bitboards::rookAttacks(square, occupied) & (pieces(PieceType::ROOK) | QUEENS));
+}
+
+auto Position::checkers() const -> Bitboard
+{
+    const Color THEM = m_side_to_move == Color::WHITE ? Color::BLACK : Color::WHITE;
+    return attackersTo(kingSquare(m_side_to_move), occupied()) & pieces(THEM);
+}
+
+auto Position::see(Move move, int threshold) const -> bool
+{
+    if (move.isCastle()) { return threshold <= 0; }
+
+    const Square FROM = move.from();
+    const Square TO = move.to();
+    const PieceType MOVER =
+        move.isPromotion() ? move.promotionType() : getPieceType(m_pieces[toIdx(FROM)]);
+    const PieceType VICTIM =
+        move.isEnPassant() ? PieceType::PAWN : getPieceType(m_pieces[toIdx(TO)]);
+    const int PROMOTION_GAIN =
+        move.isPromotion() ? Eval::pieceValue(MOVER) - Eval::pieceValue(PieceType::PAWN) : 0;
+
+    // `swap` is the balance the side to move must beat: first the capture itself must reach
+    // the threshold, then it must survive losing the moved piece
+    int swap = Eval::pieceValue(VICTIM) + PROMOTION_GAIN - threshold;
+    if (swap < 0) { return false; }
+    swap = Eval::pieceValue(MOVER) - swap;
+    if (swap <= 0) { return true; }
+
+    Bitboard occupancy = occupied() ^ squareBB(FROM) ^ squareBB(TO);
+    if (move.isEnPassant()) {
+        occupancy ^= squareBB(offsetSquare(TO, m_side_to_move == Color::WHITE
+                                                   ? -Constants::Board::LENGTH
+                                                   : Constants::Board::LENGTH));
+    }
+
+    // Only a piece leaving one of the lines through TO can uncover a slider behind it
+    const Bitboard DIAGONAL_LINES =
+        Bitboards::diagonals[getFile(TO) - getRank(TO) + Constants::Board::DIAGONAL_CENTER] |
+        Bitboards::anti_diagonals[(2 * Constants::Board::DIAGONAL_CENTER) - getFile(TO) -
+                                  getRank(TO)];
+    const Bitboard ORTHOGONAL_LINES = Bitboards::files[getFile(TO)] | Bitboards::ranks[getRank(TO)];
+    const Bitboard QUEENS = pieces(PieceType::QUEEN);
+    const Bitboard DIAGONAL_SLIDERS = pieces(PieceType::BISHOP) | QUEENS;
+    const Bitboard ORTHOGONAL_SLIDERS = pieces(PieceType::ROOK) | QUEENS;
+
+    Bitboard attackers = attackersTo(TO, occupancy);
+    Color side = m_side_to_move;
+    bool result = true;
+
+    while (true) {
+        side = side == Color::WHITE ? Color::BLACK : Color::WHITE;
+        attackers &= occupancy;
+        const Bitboard OWN_ATTACKERS = attackers & pieces(side);
+        if (OWN_ATTACKERS == 0) { break; }
+        result = !result;
+
+        // Least valuable attacker recaptures
+        PieceType type = PieceType::PAWN;
+        Bitboard candidates = 0;
+        for (; type <= PieceType::KING; type = fromIdx<PieceType>(toIdx(type) + 1)) {
+            candidates = OWN_ATTACKERS & pieces(side, type);
+            if (candidates != 0) { break; }
+        }
+
+        // The king can only recapture if nothing is left to take it back
+        if (type == PieceType::KING) {
+            const Color OTHER = side == Color::WHITE ? Color::BLACK : Color::WHITE;
+            return (attackers & pieces(OTHER)) != 0 ? !result : result;
+        }
+
+        swap = Eval::pieceValue(type) - swap;
+        if (swap < static_cast<int>(result)) { break; }
+
+        const Bitboard REMOVED = candidates & (0 - candidates);
+        occupancy ^= REMOVED;
+        if ((REMOVED & DIAGONAL_LINES) != 0) {
+            attackers |= Bitboards::bishopAttacks(TO, occupancy) & DIAGONAL_SLIDERS;
+        }
+        else if ((REMOVED & ORTHOGONAL_LINES) != 0) {
+            attackers |= Bitboards::rookAttacks(TO, occupancy) & ORTHOGONAL_SLIDERS;
+        }
+    }
+
+    return result;
+}
+
+auto Position::inCheck() const -> bool { return checkers() != 0; }
+
+auto Position::isDraw() const -> bool
+{
+    if (m_halfmove_clock >= Constants::Game::FIFTY_MOVE_PLIES) { return true; }
+
+    // Only positions after the last irreversible move can repeat. A null move is not a real
+    // move either, so positions before it do not count.
+    const std::size_t REACH = std::min({static_cast<std::size_t>(m_halfmove_clock),
+                                        m_history_size, HISTORY_MASK + 1});
+    for (std::size_t back = 1; back <= REACH; ++back) {
+        const UndoInfo& undo = m_history[(m_history_size - back) & HISTORY_MASK];
+        if (undo.move.isNone()) { return false; }
+        if (back % 2 == 0 && undo.hash == m_position_hash) { return true; }
+    }
+    return false;
+}
+
 auto Position::toFen() const -> std::string
 {
-    std::ostringstream oss;
+    std::string fen;
+    toFen(fen);
+    return fen;
+}
 
-    oss << buildFenPiecePlacement();
-    oss << buildFenGameState();
+auto Position::toFen(char* out, std::size_t capacity) const -> std::size_t
+{
+    std::array<char, Constants::Game::MAX_FEN_LENGTH> buffer;
+    const std::size_t LENGTH = writeFen(buffer.data());
+    if (LENGTH >= capacity) { return 0; }
 
-    return oss.str();
+    std::memcpy(out, buffer.data(), LENGTH);
+    out[LENGTH] = '\0';
+    return LENGTH;
+}
+
+auto Position::toFen(std::string& out) const -> void
+{
+    std::array<char, Constants::Game::MAX_FEN_LENGTH> buffer;
+    out.assign(buffer.data(), writeFen(buffer.data()));
 }
 
 auto Position::print() const -> void
@@ -131,6 +873,33 @@ auto Position::operator==(const Position& other) const -> bool
 
 auto Position::operator!=(const Position& other) const -> bool { return !(*this == other); }
 
+auto Position::putPiece(Piece piece, Square square) -> void
+{
+    const Bitboard BIT = squareBB(square);
+    m_pieces[toIdx(square)] = piece;
+    m_piece_bitboards[colorSlot(piece)][typeSlot(piece)] |= BIT;
+    m_color_bitboards[colorSlot(piece)] |= BIT;
+}
+
+auto Position::removePiece(Square square) -> void
+{
+    const Bitboard BIT = squareBB(square);
+    const Piece PIECE = m_pieces[toIdx(square)];
+    m_pieces[toIdx(square)] = Piece::NONE;
+    m_piece_bitboards[colorSlot(PIECE)][typeSlot(PIECE)] ^= BIT;
+    m_color_bitboards[colorSlot(PIECE)] ^= BIT;
+}
+
+auto Position::movePiece(Square from, Square to) -> void
+{
+    const Bitboard FROM_TO = squareBB(from) | squareBB(to);
+    const Piece PIECE = m_pieces[toIdx(from)];
+    m_pieces[toIdx(from)] = Piece::NONE;
+    m_pieces[toIdx(to)] = PIECE;
+    m_piece_bitboards[colorSlot(PIECE)][typeSlot(PIECE)] ^= FROM_TO;
+    m_color_bitboards[colorSlot(PIECE)] ^= FROM_TO;
+}
+
 auto Position::parseFenPiecePlacement(std::istringstream& iss) -> void
 {
     std::string token;
@@ -198,6 +967,15 @@ auto Position::parseFenGameState(std::istringstream& iss) -> void
         catch (const std::invalid_argument&) {
             m_en_passant_square = Square::NONE;
         }
+
+        // As in `setUp`, a square no pawn can capture on is not recorded
+        const Color US = m_side_to_move;
+        const Color THEM = US == Color::WHITE ? Color::BLACK : Color::WHITE;
+        if (m_en_passant_square != Square::NONE &&
+            (Bitboards::pawnAttacks(THEM, m_en_passant_square) & pieces(US, PieceType::PAWN)) ==
+                0) {
+            m_en_passant_square = Square::NONE;
+        }
     }
 
     // 4. Halfmove clock
@@ -221,79 +999,82 @@ auto Position::parseFenGameState(std::istringstream& iss) -> void
     }
 }
 
-auto Position::buildFenPiecePlacement() const -> std::string
+auto Position::writeFen(char* buffer) const -> std::size_t
 {
-    std::ostringstream oss;
+    char* cursor = buffer;
 
-    // Use reverse rank (r_rank) to silence `-altera-id-dependent-backward-branch`
+    // 1. Piece placement, from the eighth rank down
     for (int r_rank = 0; r_rank < Constants::Board::LENGTH; ++r_rank) {
         const int RANK = Constants::Board::MAX_RANK - r_rank;
+        const Piece* const ROW = &m_pieces[toIdx(makeSquare(0, RANK))];
 
-        int empty_count = 0;
-        UNROLL_LOOP
+        char empty_count = 0;
         for (int file = 0; file < Constants::Board::LENGTH; ++file) {
-            const Square SQR = makeSquare(file, RANK);
-            const Piece PIECE = pieceAt(SQR);
-
+            const Piece PIECE = ROW[file];
             if (PIECE == Piece::NONE) {
                 ++empty_count;
                 continue;
             }
             if (empty_count > 0) {
-                oss << empty_count;
+                *cursor++ = static_cast<char>('0' + empty_count);
                 empty_count = 0;
             }
-            oss << pieceToChar(PIECE);
+            *cursor++ = FEN_LETTERS[toIdx(PIECE)];
         }
 
-        if (empty_count > 0) { oss << empty_count; }
-
-        if (RANK > 0) { oss << '/'; }
+        if (empty_count > 0) { *cursor++ = static_cast<char>('0' + empty_count); }
+        if (RANK > 0) { *cursor++ = '/'; }
     }
 
-    return oss.str();
-}
-
-auto Position::buildFenGameState() const -> std::string
-{
-    std::ostringstream oss;
+    // 2. Active color
+    *cursor++ = ' ';
+    *cursor++ = m_side_to_move == Color::WHITE ? 'w' : 'b';
 
-    // 1. Active color
-    oss << ' ' << (getSideToMove() == Color::WHITE ? 'w' : 'b');
+    // 3. Castling availability
+    *cursor++ = ' ';
+    if (m_castling_rights == 0) { *cursor++ = '-'; }
+    for (const CastlingRook& castling : CASTLING_ROOKS) {
+        if ((m_castling_rights & toIdx(castling.right)) != 0) {
+            *cursor++ = castling.letter;
+        }
+    }
 
-    // 2. Castling availability
-    oss << ' ';
-    if (getCastlingRights() == 0) { oss << '-'; }
+    // 4. En passant target square
+    *cursor++ = ' ';
+    if (m_en_passant_square == Square::NONE) { *cursor++ = '-'; }
     else {
-        if (hasCastlingRight(CastlingRight::WHITE_KINGSIDE)) { oss << 'K'; }
-        if (hasCastlingRight(CastlingRight::WHITE_QUEENSIDE)) { oss << 'Q'; }
-        if (hasCastlingRight(CastlingRight::BLACK_KINGSIDE)) { oss << 'k'; }
-        if (hasCastlingRight(CastlingRight::BLACK_QUEENSIDE)) { oss << 'q'; }
+        *cursor++ = static_cast<char>('a' + getFile(m_en_passant_square));
+        *cursor++ = static_cast<char>('1' + getRank(m_en_passant_square));
     }
 
-    // 3. En passant target square
-    oss << ' ' << squareToString(getEnPassantSquare());
-
-    // 4. Halfmove clock
-    oss << ' ' << getHalfmoveClock();
+    // 5. and 6. Halfmove clock and fullmove number; ten digits each leave room to spare
+    char* const END = buffer + Constants::Game::MAX_FEN_LENGTH;
+    *cursor++ = ' ';
+    cursor = std::to_chars(cursor, END, m_halfmove_clock).ptr;
+    *cursor++ = ' ';
+    cursor = std::to_chars(cursor, END, m_fullmove_number).ptr;
 
-    // 5. Fullmove number
-    oss << ' ' << getFullmoveNumber();
+    return static_cast<std::size_t>(cursor - buffer);
+}
 
-    return oss.str();
+auto Position::refreshState() -> void
+{
+    m_position_hash = computeHash();
+    m_pawn_key = computePawnKey();
+    m_material_key = computeMaterialKey();
+    m_psqt = computePsqt();
+    m_phase = computePhase();
 }
 
-auto Position::computeHash() const -> HashKey
+MULTIVERSION auto Position::computeHash() const -> HashKey
 {
     HashKey hash = 0;
 
     // 1. Pieces
-    UNROLL_LOOP
-    for (int square = 0; square < Constants::Board::SQUARE_COUNT; ++square) {
-        const Piece PIECE = m_pieces.at(square);
-        if (PIECE != Piece::NONE) {
-            hash ^= Zobrist::getPieceSquareKey(PIECE, fromIdx<Square>(square));
-        }
+    Bitboard occupancy = occupied();
+    while (occupancy != 0) {
+        const Square SQUARE = Bitboards::popSquare(occupancy);
+        hash ^= Zobrist::getPieceSquareKey(m_pieces[toIdx(SQUARE)], SQUARE);
     }
 
     // 2. Side to move
@@ -310,4 +1091,66 @@ auto Position::computeHash() const -> HashKey
     return hash;
 }
 
-} // namespace Chess
\ No newline at end of file
+auto Position::computePawnKey() const -> HashKey
+{
+    HashKey key = 0;
+
+    Bitboard pawns_and_kings = pieces(PieceType::PAWN) | pieces(PieceType::KING);
+    while (pawns_and_kings != 0) {
+        const Square SQUARE = Bitboards::popSquare(pawns_and_kings);
+        key ^= Zobrist::getPieceSquareKey(m_pieces[toIdx(SQUARE)], SQUARE);
+    }
+
+    return key;
+}
+
+auto Position::computeMaterialKey() const -> HashKey
+{
+    HashKey key = 0;
+
+    for (uint8_t color = 0; color < Constants::Board::COLOR_COUNT; ++color) {
+        // Kings included, so no material key is zero like an empty table slot
+        for (uint8_t type = toIdx(PieceType::PAWN); type <= toIdx(PieceType::KING); ++type) {
+            const Piece PIECE = makePiece(fromIdx<PieceType>(type), fromIdx<Color>(color));
+            const int COUNT = pieceCount(PIECE);
+            for (int count = 0; count < COUNT; ++count) {
+                key ^= Zobrist::getMaterialKey(PIECE, count);
+            }
+        }
+    }
+
+    return key;
+}
+
+auto Position::pieceCount(Piece piece) const -> int
+{
+    return Bitboards::popCount(m_piece_bitboards[colorSlot(piece)][typeSlot(piece)]);
+}
+
+auto Position::computePsqt() const -> PSQT::Score
+{
+    PSQT::Score score{0, 0};
+
+    Bitboard occupancy = occupied();
+    while (occupancy != 0) {
+        const Square SQUARE = Bitboards::popSquare(occupancy);
+        score += PSQT::value(m_pieces[toIdx(SQUARE)], SQUARE);
+    }
+
+    return score;
+}
+
+auto Position::computePhase() const -> int
+{
+    int phase = 0;
+
+    UNROLL_LOOP
+    for (uint8_t type = toIdx(PieceType::KNIGHT); type < toIdx(PieceType::KING); ++type) {
+        const auto PIECE_TYPE = fromIdx<PieceType>(type);
+        phase += PSQT::phaseWeight(PIECE_TYPE) * Bitboards::popCount(pieces(PIECE_TYPE));
+    }
+
+    return phase;
+}
+
+} // namespace Chess
@@ -0,0 +1,123 @@
+#include "san.h"
+
+#include "bitboard.h"
+#include "movegen.h"
+#include "types.h"
+
+namespace Chess::San {
+
+using namespace Util;
+
+namespace {
+
+// Notation without the check mark and, for parsing leniency, without '=' before a promotion
+auto formatBody(const Position& pos, const MoveList& legal, Move move, bool promotion_sign)
+    -> std::string
+{
+    if (move.isCastle()) { return move.flag() == MoveFlag::KING_CASTLE ? "O-O" : "O-O-O"; }
+
+    const Piece PIECE = pos.pieceAt(move.from());
+    const PieceType TYPE = getPieceType(PIECE);
+    const std::string FROM = squareToString(move.from());
+    std::string san;
+
+    if (TYPE == PieceType::PAWN) {
+        if (move.isCapture()) { san += FROM[0]; }
+    }
+    else {
+        san += pieceToChar(makePiece(TYPE, Color::WHITE));
+
+        // Name the origin file, else its rank, else both, when another piece of the same kind
+        // can also reach the destination
+        bool ambiguous = false;
+        bool same_file = false;
+        bool same_rank = false;
+        for (const Move OTHER : legal) {
+            if (OTHER.to() != move.to() || OTHER.from() == move.from() ||
+                pos.pieceAt(OTHER.from()) != PIECE) {
+                continue;
+            }
+            ambiguous = true;
+            same_file = same_file || getFile(OTHER.from()) == getFile(move.from());
+            same_rank = same_rank || getRank(OTHER.from()) == getRank(move.from());
+        }
+        if (ambiguous && (!same_file || same_rank)) { san += FROM[0]; }
+        if (ambiguous && same_file) { san += FROM[1]; }
+    }
+
+    if (move.isCapture()) { san += 'x'; }
+    san += squareToString(move.to());
+
+    if (move.isPromotion()) {
+        if (promotion_sign) { san += '='; }
+        san += pieceToChar(makePiece(move.promotionType(), Color::WHITE));
+    }
+    return san;
+}
+
+// Whether `text` names `move` by more of its origin square than needed, as "Ngf3" does when
+// no other knight reaches f3
+auto namesOrigin(const Position& pos, Move move, std::string_view text) -> bool
+{
+    const PieceType TYPE = getPieceType(pos.pieceAt(move.from()));
+    if (move.isCastle() || TYPE == PieceType::PAWN) { return false; }
+
+    const char LETTER = pieceToChar(makePiece(TYPE, Color::WHITE));
+    const std::string FROM = squareToString(move.from());
+    const std::string TARGET = (move.isCapture() ? "x" : "") + squareToString(move.to());
+    for (const std::string& origin : {FROM.substr(0, 1), FROM.substr(1), FROM}) {
+        if (text == LETTER + origin + TARGET) { return true; }
+    }
+    return false;
+}
+
+auto isAnnotation(char chr) -> bool
+{
+    return chr == '+' || chr == '#' || chr == '!' || chr == '?';
+}
+
+} // namespace
+
+auto format(const Position& pos, Move move) -> std::string
+{
+    std::string san = formatBody(pos, MoveGen::generateLegal(pos), move, true);
+
+    Position after = pos;
+    after.makeMove(move);
+    if (after.inCheck()) { san += MoveGen::generateLegal(after).empty() ? '#' : '+'; }
+    return san;
+}
+
+auto parse(const Position& pos, std::string_view san) -> Move
+{
+    while (!san.empty() && isAnnotation(san.back())) { san.remove_suffix(1); }
+    constexpr std::string_view EN_PASSANT_SUFFIX = "e.p.";
+    if (san.size() > EN_PASSANT_SUFFIX.size() &&
+        san.substr(san.size() - EN_PASSANT_SUFFIX.size()) == EN_PASSANT_SUFFIX) {
+        san.remove_suffix(EN_PASSANT_SUFFIX.size());
+        while (!san.empty() && san.back() == ' ') { san.remove_suffix(1); }
+    }
+
+    std::string text;
+    for (const char CHR : san) {
+        if (CHR == '=') { continue; }
+        text += CHR == '0' ? 'O' : CHR;
+    }
+    if (text.empty()) { return Move(); }
+
+    const MoveList LEGAL = MoveGen::generateLegal(pos);
+    for (const Move MOVE : LEGAL) {
+        if (formatBody(pos, LEGAL, MOVE, false) == text) { return MOVE; }
+    }
+
+    // A redundant origin is fine as long as it still picks out a single move
+    Move named = Move();
+    for (const Move MOVE : LEGAL) {
+        if (!namesOrigin(pos, MOVE, text)) { continue; }
+        if (!named.isNone()) { return Move(); }
+        named = MOVE;
+    }
+    return named;
+}
+
+} // namespace Chess::San
@@ -0,0 +1,574 @@
+#include "search.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+#include <utility>
+
+#include "bitboard.h"
+#include "eval.h"
+#include "nnue.h"
+
+namespace Chess::Search {
+
+using namespace Util;
+
+namespace {
+
+constexpr int MAX_PLY = Constants::Search::MAX_PLY;
+constexpr int INFINITE_SCORE = Constants::Search::INFINITE_SCORE;
+constexpr int MATE_SCORE = Constants::Search::MATE_SCORE;
+constexpr int BITBASE_WIN = Constants::Search::BITBASE_WIN;
+constexpr int BITBASE_BOUND = Constants::Search::BITBASE_BOUND;
+
+// The shared stop flag and the clock are only read every this many nodes
+constexpr uint64_t STOP_CHECK_MASK = 4095;
+
+constexpr int NULL_MOVE_MIN_DEPTH = 3;
+constexpr int NULL_MOVE_BASE_REDUCTION = 3;
+constexpr int NULL_MOVE_DEPTH_DIVISOR = 6;
+
+constexpr int LMR_MIN_DEPTH = 3;
+constexpr int LMR_MIN_MOVE_INDEX = 3;
+constexpr int LMR_TABLE_SIZE = 64;
+constexpr double LMR_BASE = 0.75;
+constexpr double LMR_DIVISOR = 2.25;
+
+// History scores saturate at this magnitude
+constexpr int HISTORY_MAX = 16384;
+constexpr int MAX_HISTORY_BONUS = 1200;
+constexpr int MAX_QUIETS_TRACKED = 64;
+
+// Lazy SMP depth staggering: helper i skips iterations in runs of SKIP_SIZE[i] depths, offset by
+// SKIP_PHASE[i], so at any time the helpers spread over several depths
+constexpr int SKIP_PATTERNS = 20;
+constexpr std::array<int, SKIP_PATTERNS> SKIP_SIZE = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                                      3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+constexpr std::array<int, SKIP_PATTERNS> SKIP_PHASE = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3,
+                                                       4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+using ReductionTable = std::array<std::array<int, LMR_TABLE_SIZE>, LMR_TABLE_SIZE>;
+
+const ReductionTable REDUCTIONS = [] {
+    ReductionTable table{};
+    for (int depth = 1; depth < LMR_TABLE_SIZE; ++depth) {
+        for (int index = 1; index < LMR_TABLE_SIZE; ++index) {
+            table[depth][index] =
+                static_cast<int>(LMR_BASE + (std::log(depth) * std::log(index) / LMR_DIVISOR));
+        }
+    }
+    return table;
+}();
+
+auto reduction(int depth, std::size_t index) -> int
+{
+    return REDUCTIONS[std::min(depth, LMR_TABLE_SIZE - 1)]
+                     [std::min<std::size_t>(index, LMR_TABLE_SIZE - 1)];
+}
+
+// Mate and bitbase scores are stored relative to the node so they stay valid at any ply
+auto scoreToTT(int score, int ply) -> int
+{
+    if (score >= BITBASE_BOUND) { return score + ply; }
+    if (score <= -BITBASE_BOUND) { return score - ply; }
+    return score;
+}
+
+auto scoreFromTT(int score, int ply) -> int
+{
+    if (score >= BITBASE_BOUND) { return score - ply; }
+    if (score <= -BITBASE_BOUND) { return score + ply; }
+    return score;
+}
+
+auto hasNonPawnMaterial(const Position& pos, Color color) -> bool
+{
+    return (pos.pieces(color) &
+            ~(pos.pieces(color, PieceType::PAWN) | pos.pieces(color, PieceType::KING))) != 0;
+}
+
+} // namespace
+
+Searcher::Searcher(TranspositionTable& table, std::size_t id)
+    : m_table(table), m_id(id), m_timed(false), m_clock(false), m_best_move_nodes(0), m_nodes(0),
+      m_seldepth(0), m_completed_depth(0), m_stop(false), m_ponderhit(false), m_pondering(false)
+{
+}
+
+auto Searcher::stop() -> void { m_stop.store(true, std::memory_order_relaxed); }
+
+auto Searcher::ponderhit() -> void { m_ponderhit.store(true, std::memory_order_relaxed); }
+
+auto Searcher::clearSignals() -> void
+{
+    m_stop.store(false, std::memory_order_relaxed);
+    m_ponderhit.store(false, std::memory_order_relaxed);
+}
+
+auto Searcher::nodes() const -> uint64_t { return m_nodes.load(std::memory_order_relaxed); }
+
+auto Searcher::clear() -> void
+{
+    m_history = {};
+    m_counter_moves = {};
+    m_killers = {};
+}
+
+// Only this thread writes the counter, so a plain load and store avoids a locked increment
+auto Searcher::countNode() -> void
+{
+    m_nodes.store(m_nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+auto Searcher::setNetwork(const NNUE::Network* network) -> void { m_network = network; }
+
+auto Searcher::setBitbases(const Bitbases::Set* bitbases) -> void { m_bitbases = bitbases; }
+
+auto Searcher::setReporter(Reporter reporter) -> void { m_reporter = std::move(reporter); }
+
+auto Searcher::makeMove(Move move) -> void
+{
+    m_accumulators.push(m_pos, move);
+    m_pos.makeMove(move);
+}
+
+auto Searcher::unmakeMove() -> void
+{
+    m_pos.unmakeMove();
+    m_accumulators.pop();
+}
+
+// Network output is clamped so it can never be mistaken for a mate or bitbase score
+auto Searcher::evaluate() -> int
+{
+    if (m_network == nullptr) { return Eval::evaluate(m_pos, m_pawns, m_material); }
+    return std::clamp(NNUE::evaluate(*m_network, m_pos, m_accumulators), -BITBASE_BOUND + 1,
+                      BITBASE_BOUND - 1);
+}
+
+auto Searcher::skipsDepth(int depth) const -> bool
+{
+    if (m_id == 0) { return false; }
+    const std::size_t PATTERN = (m_id - 1) % SKIP_PATTERNS;
+    return ((depth + SKIP_PHASE[PATTERN]) / SKIP_SIZE[PATTERN]) % 2 != 0;
+}
+
+auto Searcher::updateHistory(Move move, int bonus) -> void
+{
+    int& entry = m_history[toIdx(m_pos.getSideToMove())][toIdx(move.from())][toIdx(move.to())];
+    entry += bonus - (entry * std::abs(bonus) / HISTORY_MAX);
+}
+
+// Remembers a quiet move that cut off as a killer for this ply and as the reply to the
+// opponent's last move
+auto Searcher::updateQuietStats(int ply, Move move) -> void
+{
+    Killers& killers = m_killers[ply];
+    if (killers[0] != move) {
+        killers[1] = killers[0];
+        killers[0] = move;
+    }
+
+    const Move PREVIOUS = m_pos.lastMove();
+    if (!PREVIOUS.isNone()) {
+        m_counter_moves[toIdx(m_pos.pieceAt(PREVIOUS.to()))][toIdx(PREVIOUS.to())] = move;
+    }
+}
+
+auto Searcher::search(const Position& root, const Limits& limits) -> Result
+{
+    m_pos = root;
+    m_accumulators.reset();
+    m_limits = limits;
+    m_clock = limits.movetime.count() == 0 && limits.time.count() > 0;
+    m_timed = m_clock || limits.movetime.count() != 0;
+    if (m_clock) { m_time.init(limits.time, limits.increment, limits.moves_to_go); }
+    startClock();
+    m_pondering = limits.ponder;
+    m_nodes.store(0, std::memory_order_relaxed);
+    m_completed_depth = 0;
+    m_probe_bitbases = m_bitbases != nullptr && m_bitbases->probe(root) == Bitbases::Wdl::UNKNOWN;
+
+    // Keep what earlier searches learned, at reduced weight
+    for (auto& from_table : m_history) {
+        for (auto& to_table : from_table) {
+            for (int& entry : to_table) { entry /= 2; }
+        }
+    }
+
+    Result result;
+    const int MAX_DEPTH = std::clamp(limits.depth, 1, MAX_PLY - 1);
+
+    for (int depth = 1; depth <= MAX_DEPTH; ++depth) {
+        if (m_completed_depth > 0 && skipsDepth(depth)) { continue; }
+
+        m_seldepth = 0;
+        const uint64_t ITERATION_START = nodes();
+        const int SCORE = pvs(-INFINITE_SCORE, INFINITE_SCORE, depth, 0, false);
+
+        // A partial iteration is unreliable; keep the previous one
+        if (m_completed_depth > 0 && m_stop.load(std::memory_order_relaxed)) { break; }
+
+        m_completed_depth = depth;
+        result.score = SCORE;
+        result.depth = depth;
+        result.seldepth = m_seldepth;
+        result.pv = m_pv[0];
+        result.best_move = m_pv[0].empty() ? Move() : m_pv[0][0];
+
+        // No legal moves at the root: mate or stalemate, nothing deeper to find
+        if (m_pv[0].empty()) { break; }
+
+        if (m_reporter) {
+            result.nodes = nodes();
+            m_reporter(result);
+        }
+
+        // Past the soft limit another iteration would most likely be cut off by the hard one
+        if (m_clock) {
+            const uint64_t ITERATION_NODES = nodes() - ITERATION_START;
+            const double SHARE = ITERATION_NODES == 0 ? 1.0
+                                                      : static_cast<double>(m_best_move_nodes) /
+                                                            static_cast<double>(ITERATION_NODES);
+            m_time.update(result.best_move, SCORE, SHARE);
+            if (!m_pondering && std::chrono::steady_clock::now() - m_start >= m_time.softLimit()) {
+                break;
+            }
+        }
+    }
+
+    // Cleared on the way out rather than on entry, so a stop or ponderhit that races ahead of
+    // the start of the search still applies to it
+    clearSignals();
+    result.nodes = nodes();
+    return result;
+}
+
+auto Searcher::shouldStop() -> bool
+{
+    // Depth 1 always completes so there is a move to play
+    if (m_completed_depth == 0) { return false; }
+
+    const uint64_t NODES = nodes();
+    if (!m_pondering && m_limits.nodes != 0 && NODES >= m_limits.nodes) {
+        m_stop.store(true, std::memory_order_relaxed);
+    }
+    if ((NODES & STOP_CHECK_MASK) != 0) { return false; }
+
+    if (m_pondering) {
+        if (m_ponderhit.load(std::memory_order_relaxed)) {
+            m_pondering = false;
+            startClock();
+            m_limits.nodes += m_limits.nodes != 0 ? NODES : 0;
+        }
+    }
+    else if (m_timed && std::chrono::steady_clock::now() >= m_deadline) {
+        m_stop.store(true, std::memory_order_relaxed);
+    }
+    return m_stop.load(std::memory_order_relaxed);
+}
+
+// Time limits count from the start of the search, or from the ponderhit
+auto Searcher::startClock() -> void
+{
+    m_start = std::chrono::steady_clock::now();
+    m_deadline = m_start + (m_clock ? m_time.hardLimit() : m_limits.movetime);
+}
+
+auto Searcher::updatePv(int ply, Move move) -> void
+{
+    MoveList& line = m_pv[ply];
+    line.clear();
+    line.push(move);
+    for (const Move CHILD : m_pv[ply + 1]) { line.push(CHILD); }
+}
+
+auto Searcher::pvs(int alpha, int beta, int depth, int ply, bool allow_null) -> int
+{
+    if (depth <= 0) { return quiescence(alpha, beta, ply); }
+
+    m_pv[ply].clear();
+    countNode();
+    m_seldepth = std::max(m_seldepth, ply);
+    if (shouldStop()) { return 0; }
+
+    const bool PV_NODE = beta - alpha > 1;
+    const bool ROOT = ply == 0;
+
+    if (!ROOT) {
+        // Insufficient material is one probe of the material table, hit on almost every node
+        if (m_pos.isDraw() || m_material.probe(m_pos).draw) { return 0; }
+        if (ply >= MAX_PLY - 1) { return evaluate(); }
+
+        // A won bitbase position scores below any mate, so the search still prefers one it sees
+        if (m_probe_bitbases) {
+            switch (m_bitbases->probe(m_pos)) {
+                case Bitbases::Wdl::DRAW: return 0;
+                case Bitbases::Wdl::WIN: return BITBASE_WIN - ply;
+                case Bitbases::Wdl::LOSS: return -BITBASE_WIN + ply;
+                case Bitbases::Wdl::UNKNOWN: break;
+            }
+        }
+
+        // Mate distance pruning: no line from here beats a shorter mate already found
+        alpha = std::max(alpha, -MATE_SCORE + ply);
+        beta = std::min(beta, MATE_SCORE - ply - 1);
+        if (alpha >= beta) { return alpha; }
+    }
+
+    const HashKey KEY = m_pos.hash();
+    TTData entry{};
+    const bool TT_HIT = m_table.probe(KEY, entry);
+    const Move TT_MOVE = TT_HIT ? entry.move : Move();
+
+    if (TT_HIT && !PV_NODE && entry.depth >= depth) {
+        const int TT_SCORE = scoreFromTT(entry.score, ply);
+        if (entry.bound == Bound::EXACT || (entry.bound == Bound::LOWER && TT_SCORE >= beta) ||
+            (entry.bound == Bound::UPPER && TT_SCORE <= alpha)) {
+            return TT_SCORE;
+        }
+    }
+
+    const bool IN_CHECK = m_pos.inCheck();
+    const int STATIC_EVAL = TT_HIT ? entry.eval : evaluate();
+
+    // Null move: if passing still fails high, a real move will too. Skipped without pieces,
+    // where zugzwang makes passing unreasonably good.
+    if (!PV_NODE && !IN_CHECK && allow_null && depth >= NULL_MOVE_MIN_DEPTH &&
+        STATIC_EVAL >= beta && hasNonPawnMaterial(m_pos, m_pos.getSideToMove())) {
+        const int R = NULL_MOVE_BASE_REDUCTION + (depth / NULL_MOVE_DEPTH_DIVISOR);
+        m_accumulators.pushNull();
+        m_pos.makeNullMove();
+        const int SCORE = -pvs(-beta, -beta + 1, depth - 1 - R, ply + 1, false);
+        m_pos.unmakeNullMove();
+        m_accumulators.pop();
+
+        if (m_stop.load(std::memory_order_relaxed)) { return 0; }
+        if (SCORE >= beta) { return SCORE >= BITBASE_BOUND ? beta : SCORE; }
+    }
+
+    const Move PREVIOUS = m_pos.lastMove();
+    const Move COUNTER_MOVE =
+        PREVIOUS.isNone()
+            ? Move()
+            : m_counter_moves[toIdx(m_pos.pieceAt(PREVIOUS.to()))][toIdx(PREVIOUS.to())];
+    m_killers[ply + 1] = Killers{};
+
+    MovePicker picker(m_pos, TT_MOVE, m_killers[ply], COUNTER_MOVE, m_history);
+    const int ALPHA_ORIGINAL = alpha;
+    int best_score = -INFINITE_SCORE;
+    Move best_move{};
+    std::array<Move, MAX_QUIETS_TRACKED> quiets_tried{};
+    std::size_t quiet_count = 0;
+    std::size_t move_count = 0;
+
+    while (true) {
+        const Move MOVE = picker.next();
+        if (MOVE.isNone()) { break; }
+        const std::size_t INDEX = move_count++;
+        const uint64_t NODES_BEFORE = ROOT ? nodes() : 0;
+
+        makeMove(MOVE);
+        int score = 0;
+
+        if (INDEX == 0) {
+            score = -pvs(-beta, -alpha, depth - 1, ply + 1, true);
+        }
+        else {
+            // Late quiet moves are searched shallower first and re-searched if they surprise
+            int r = 0;
+            if (depth >= LMR_MIN_DEPTH && INDEX >= LMR_MIN_MOVE_INDEX && !MOVE.isTactical() &&
+                !IN_CHECK && !m_pos.inCheck()) {
+                r = std::clamp(reduction(depth, INDEX) - static_cast<int>(PV_NODE), 0, depth - 2);
+            }
+
+            score = -pvs(-alpha - 1, -alpha, depth - 1 - r, ply + 1, true);
+            if (score > alpha && r > 0) {
+                score = -pvs(-alpha - 1, -alpha, depth - 1, ply + 1, true);
+            }
+            if (score > alpha && score < beta) {
+                score = -pvs(-beta, -alpha, depth - 1, ply + 1, true);
+            }
+        }
+
+        unmakeMove();
+        if (m_stop.load(std::memory_order_relaxed) && m_completed_depth > 0) { return 0; }
+
+        if (score > best_score) {
+            best_score = score;
+            if (score > alpha) {
+                best_move = MOVE;
+                alpha = score;
+                updatePv(ply, MOVE);
+                if (ROOT) { m_best_move_nodes = nodes() - NODES_BEFORE; }
+                if (alpha >= beta) { break; }
+            }
+        }
+        if (!MOVE.isTactical() && quiet_count < quiets_tried.size()) {
+            quiets_tried[quiet_count++] = MOVE;
+        }
+    }
+
+    // No legal moves: checkmate or stalemate
+    if (move_count == 0) { return IN_CHECK ? -MATE_SCORE + ply : 0; }
+
+    // Reward the quiet move that cut off and penalise the quiet moves tried before it
+    if (best_score >= beta && !best_move.isTactical()) {
+        const int BONUS = std::min(depth * depth, MAX_HISTORY_BONUS);
+        updateQuietStats(ply, best_move);
+        updateHistory(best_move, BONUS);
+        for (std::size_t i = 0; i < quiet_count; ++i) { updateHistory(quiets_tried[i], -BONUS); }
+    }
+
+    Bound bound = Bound::UPPER;
+    if (best_score >= beta) { bound = Bound::LOWER; }
+    else if (alpha > ALPHA_ORIGINAL) { bound = Bound::EXACT; }
+    m_table.store(KEY, best_move, scoreToTT(best_score, ply), STATIC_EVAL, depth, bound);
+
+    return best_score;
+}
+
+auto Searcher::quiescence(int alpha, int beta, int ply) -> int
+{
+    m_pv[ply].clear();
+    countNode();
+    m_seldepth = std::max(m_seldepth, ply);
+    if (shouldStop()) { return 0; }
+
+    if (m_pos.isDraw() || m_material.probe(m_pos).draw) { return 0; }
+    if (ply >= MAX_PLY - 1) { return evaluate(); }
+
+    const bool IN_CHECK = m_pos.inCheck();
+    int best_score = -INFINITE_SCORE;
+
+    // Stand pat: the side to move may decline every capture, unless it is in check
+    if (!IN_CHECK) {
+        best_score = evaluate();
+        if (best_score >= beta) { return best_score; }
+        alpha = std::max(alpha, best_score);
+    }
+
+    TTData entry{};
+    const Move TT_MOVE = m_table.probe(m_pos.hash(), entry) ? entry.move : Move();
+
+    MovePicker picker(m_pos, TT_MOVE, m_history);
+    bool any_move = false;
+    while (true) {
+        const Move MOVE = picker.next();
+        if (MOVE.isNone()) { break; }
+        any_move = true;
+
+        // A capture that loses material cannot raise a stand-pat score
+        if (!IN_CHECK && !m_pos.see(MOVE)) { continue; }
+
+        makeMove(MOVE);
+        const int SCORE = -quiescence(-beta, -alpha, ply + 1);
+        unmakeMove();
+        if (m_stop.load(std::memory_order_relaxed) && m_completed_depth > 0) { return 0; }
+
+        if (SCORE > best_score) {
+            best_score = SCORE;
+            if (SCORE > alpha) {
+                alpha = SCORE;
+                updatePv(ply, MOVE);
+                if (alpha >= beta) { break; }
+            }
+        }
+    }
+
+    if (IN_CHECK && !any_move) { return -MATE_SCORE + ply; }
+    return best_score;
+}
+
+ThreadPool::ThreadPool(TranspositionTable& table, std::size_t threads) : m_table(table)
+{
+    resize(threads);
+}
+
+auto ThreadPool::resize(std::size_t threads) -> void
+{
+    m_searchers.clear();
+    for (std::size_t id = 0; id < std::max<std::size_t>(threads, 1); ++id) {
+        m_searchers.push_back(std::make_unique<Searcher>(m_table, id));
+        m_searchers.back()->setNetwork(m_network);
+        m_searchers.back()->setBitbases(m_bitbases);
+    }
+    attachReporter();
+}
+
+auto ThreadPool::size() const -> std::size_t { return m_searchers.size(); }
+
+auto ThreadPool::setNetwork(const NNUE::Network* network) -> void
+{
+    m_network = network;
+    for (const auto& searcher : m_searchers) { searcher->setNetwork(network); }
+}
+
+auto ThreadPool::setBitbases(const Bitbases::Set* bitbases) -> void
+{
+    m_bitbases = bitbases;
+    for (const auto& searcher : m_searchers) { searcher->setBitbases(bitbases); }
+}
+
+auto ThreadPool::setReporter(Reporter reporter) -> void
+{
+    m_reporter = std::move(reporter);
+    attachReporter();
+}
+
+auto ThreadPool::attachReporter() -> void
+{
+    if (!m_reporter) {
+        m_searchers.front()->setReporter(nullptr);
+        return;
+    }
+    m_searchers.front()->setReporter([this](const Result& result) {
+        Result total = result;
+        total.nodes = 0;
+        for (const auto& searcher : m_searchers) { total.nodes += searcher->nodes(); }
+        m_reporter(total);
+    });
+}
+
+auto ThreadPool::stop() -> void
+{
+    for (const auto& searcher : m_searchers) { searcher->stop(); }
+}
+
+// Only the main thread has limits to switch to
+auto ThreadPool::ponderhit() -> void { m_searchers.front()->ponderhit(); }
+
+auto ThreadPool::clearSignals() -> void
+{
+    for (const auto& searcher : m_searchers) { searcher->clearSignals(); }
+}
+
+auto ThreadPool::search(const Position& root, const Limits& limits) -> Result
+{
+    m_table.newSearch();
+
+    // Helpers search until the main thread is done; only it honours the limits
+    Limits helper_limits;
+    helper_limits.depth = Constants::Search::MAX_PLY - 1;
+
+    std::vector<std::thread> helpers;
+    helpers.reserve(m_searchers.size() - 1);
+    for (std::size_t id = 1; id < m_searchers.size(); ++id) {
+        helpers.emplace_back([this, id, &root, &helper_limits] {
+            static_cast<void>(m_searchers[id]->search(root, helper_limits));
+        });
+    }
+
+    Result result = m_searchers.front()->search(root, limits);
+
+    for (std::size_t id = 1; id < m_searchers.size(); ++id) { m_searchers[id]->stop(); }
+    for (std::thread& helper : helpers) { helper.join(); }
+
+    result.nodes = 0;
+    for (const auto& searcher : m_searchers) { result.nodes += searcher->nodes(); }
+    return result;
+}
+
+} // namespace Chess::Search
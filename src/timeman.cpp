@@ -0,0 +1,98 @@
+#include "timeman.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "constants.h"
+
+namespace Chess::Time {
+
+namespace {
+
+// Kept back on every move for the GUI and the pipe
+constexpr int64_t MOVE_OVERHEAD_MS = 10;
+
+// Sudden death is planned as this many more moves, and a long time control never as more
+constexpr int DEFAULT_MOVES_TO_GO = 40;
+constexpr int MAX_MOVES_TO_GO = 50;
+constexpr double INCREMENT_SHARE = 0.75;
+
+// Caps as fractions of the usable clock: the soft limit of one move, and the hard limit
+// relative to the soft one and to the clock
+constexpr double MAX_OPTIMUM_SHARE = 0.5;
+constexpr double HARD_TO_SOFT = 5.0;
+constexpr double MAX_HARD_SHARE = 0.8;
+
+// A new best move stretches the soft limit by the first factor; each iteration it survives
+// takes off STABILITY_STEP down to the floor
+constexpr double UNSTABLE_SCALE = 1.4;
+constexpr double STABILITY_STEP = 0.1;
+constexpr double STABLE_SCALE = 0.7;
+
+// Centipawns of score lost since the previous iteration per unit of extra time, and the range
+constexpr double SCORE_DROP_UNIT = 150.0;
+constexpr double MIN_SCORE_SCALE = 0.9;
+constexpr double MAX_SCORE_SCALE = 1.6;
+
+// One move taking nearly all the nodes is an easy decision: the factor is this minus its share
+constexpr double NODE_SHARE_BASE = 1.6;
+
+} // namespace
+
+auto Manager::init(std::chrono::milliseconds time, std::chrono::milliseconds increment,
+                   int moves_to_go) -> void
+{
+    const int64_t USABLE = std::max<int64_t>(1, time.count() - MOVE_OVERHEAD_MS);
+    const int64_t MOVES =
+        moves_to_go > 0 ? std::min(moves_to_go, MAX_MOVES_TO_GO) : DEFAULT_MOVES_TO_GO;
+
+    const auto OPTIMUM = static_cast<int64_t>(
+        std::min((static_cast<double>(USABLE) / static_cast<double>(MOVES)) +
+                     (INCREMENT_SHARE * static_cast<double>(increment.count())),
+                 MAX_OPTIMUM_SHARE * static_cast<double>(USABLE)));
+    const auto MAXIMUM = static_cast<int64_t>(
+        std::min(HARD_TO_SOFT * static_cast<double>(OPTIMUM),
+                 MAX_HARD_SHARE * static_cast<double>(USABLE)));
+
+    m_optimum = std::chrono::milliseconds(std::max<int64_t>(1, OPTIMUM));
+    m_maximum = std::chrono::milliseconds(std::max<int64_t>(m_optimum.count(), MAXIMUM));
+    m_scale = 1.0;
+    m_best_move = Move();
+    m_stable_iterations = 0;
+    m_previous_score = 0;
+    m_first_iteration = true;
+}
+
+auto Manager::update(Move best_move, int score, double best_move_share) -> void
+{
+    if (best_move == m_best_move) { ++m_stable_iterations; }
+    else {
+        m_best_move = best_move;
+        m_stable_iterations = 0;
+    }
+    const double STABILITY = std::max(
+        STABLE_SCALE, UNSTABLE_SCALE - (STABILITY_STEP * static_cast<double>(m_stable_iterations)));
+
+    // Mate scores jump by thousands; the distance to mate says nothing about the clock
+    double falling = 1.0;
+    if (!m_first_iteration && !Constants::Search::isMateScore(score) &&
+        !Constants::Search::isMateScore(m_previous_score)) {
+        const double DROP = static_cast<double>(m_previous_score - score);
+        falling = std::clamp(1.0 + (DROP / SCORE_DROP_UNIT), MIN_SCORE_SCALE, MAX_SCORE_SCALE);
+    }
+    m_previous_score = score;
+    m_first_iteration = false;
+
+    const double EFFORT = NODE_SHARE_BASE - std::clamp(best_move_share, 0.0, 1.0);
+    m_scale = STABILITY * falling * EFFORT;
+}
+
+auto Manager::softLimit() const -> std::chrono::milliseconds
+{
+    const auto SCALED = static_cast<int64_t>(static_cast<double>(m_optimum.count()) * m_scale);
+    return std::chrono::milliseconds(std::clamp<int64_t>(SCALED, 1, m_maximum.count()));
+}
+
+auto Manager::hardLimit() const -> std::chrono::milliseconds { return m_maximum; }
+
+} // namespace Chess::Time
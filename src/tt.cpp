@@ -0,0 +1,213 @@
+#include "tt.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "compiler_macros.h"
+
+namespace Chess {
+
+namespace {
+
+// Entry data layout: move (16) | score (16) | eval (16) | depth (8) | bound (2) | generation (6)
+constexpr unsigned int SCORE_SHIFT = 16;
+constexpr unsigned int EVAL_SHIFT = 32;
+constexpr unsigned int DEPTH_SHIFT = 48;
+constexpr unsigned int BOUND_SHIFT = 56;
+constexpr unsigned int GENERATION_SHIFT = 58;
+
+constexpr uint64_t WORD_MASK = 0xFFFF;
+constexpr uint64_t BYTE_MASK = 0xFF;
+constexpr uint64_t BOUND_MASK = 0x3;
+constexpr uint8_t GENERATION_MASK = 0x3F;
+
+constexpr std::size_t BYTES_PER_MEGABYTE = 1ULL << 20U;
+
+// An entry of the current search survives a deeper one this many searches old
+constexpr int AGE_WEIGHT = 8;
+// Same-position results are kept over slightly deeper old ones unless they are exact
+constexpr int SAME_KEY_DEPTH_MARGIN = 4;
+
+constexpr auto pack(Move move, int score, int eval, int depth, Bound bound, uint8_t generation)
+    -> uint64_t
+{
+    return static_cast<uint64_t>(move.raw()) |
+           ((static_cast<uint64_t>(static_cast<uint16_t>(score)) & WORD_MASK) << SCORE_SHIFT) |
+           ((static_cast<uint64_t>(static_cast<uint16_t>(eval)) & WORD_MASK) << EVAL_SHIFT) |
+           ((static_cast<uint64_t>(static_cast<uint8_t>(depth)) & BYTE_MASK) << DEPTH_SHIFT) |
+           (static_cast<uint64_t>(bound) << BOUND_SHIFT) |
+           (static_cast<uint64_t>(generation) << GENERATION_SHIFT);
+}
+
+constexpr auto moveOf(uint64_t data) -> Move
+{
+    return Move::fromRaw(static_cast<uint16_t>(data & WORD_MASK));
+}
+constexpr auto depthOf(uint64_t data) -> int
+{
+    return static_cast<int8_t>((data >> DEPTH_SHIFT) & BYTE_MASK);
+}
+constexpr auto boundOf(uint64_t data) -> Bound
+{
+    return static_cast<Bound>((data >> BOUND_SHIFT) & BOUND_MASK);
+}
+constexpr auto generationOf(uint64_t data) -> uint8_t
+{
+    return static_cast<uint8_t>(data >> GENERATION_SHIFT);
+}
+
+} // namespace
+
+TranspositionTable::TranspositionTable() : TranspositionTable(Constants::TT::DEFAULT_SIZE_MB) {}
+
+TranspositionTable::TranspositionTable(std::size_t megabytes)
+    : m_buckets(nullptr), m_bucket_count(0), m_generation(0)
+{
+    resize(megabytes);
+}
+
+TranspositionTable::~TranspositionTable() { release(); }
+
+auto TranspositionTable::release() -> void
+{
+    std::free(m_buckets); // NOLINT(cppcoreguidelines-no-malloc)
+    m_buckets = nullptr;
+    m_bucket_count = 0;
+}
+
+auto TranspositionTable::resize(std::size_t megabytes) -> void
+{
+    release();
+
+    std::size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= megabytes * BYTES_PER_MEGABYTE) { count *= 2; }
+    const std::size_t BYTES = count * sizeof(Bucket);
+
+    // Large-page alignment lets the kernel back the table with transparent huge pages, which
+    // removes most TLB misses from random probes. Both sizes are powers of two, so `BYTES` is
+    // always a multiple of the alignment as `aligned_alloc` requires.
+    const std::size_t ALIGNMENT = BYTES >= Constants::TT::LARGE_PAGE_SIZE
+                                      ? Constants::TT::LARGE_PAGE_SIZE
+                                      : Constants::TT::CACHE_LINE_SIZE;
+    void* memory = std::aligned_alloc(ALIGNMENT, BYTES); // NOLINT(cppcoreguidelines-no-malloc)
+    if (memory == nullptr) { throw std::bad_alloc(); }
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (ALIGNMENT == Constants::TT::LARGE_PAGE_SIZE) { madvise(memory, BYTES, MADV_HUGEPAGE); }
+#endif
+
+    m_buckets = static_cast<Bucket*>(memory);
+    m_bucket_count = count;
+    std::uninitialized_default_construct_n(m_buckets, m_bucket_count);
+    clear();
+}
+
+auto TranspositionTable::clear() -> void
+{
+    for (std::size_t i = 0; i < m_bucket_count; ++i) {
+        for (Entry& entry : m_buckets[i].entries) {
+            entry.check.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    m_generation = 0;
+}
+
+auto TranspositionTable::newSearch() -> void
+{
+    m_generation = static_cast<uint8_t>((m_generation + 1) & GENERATION_MASK);
+}
+
+auto TranspositionTable::bucket(HashKey key) const -> Bucket&
+{
+    return m_buckets[key & (m_bucket_count - 1)];
+}
+
+auto TranspositionTable::prefetch(HashKey key) const -> void { PREFETCH(&bucket(key)); }
+
+auto TranspositionTable::probe(HashKey key, TTData& data) const -> bool
+{
+    UNROLL_LOOP
+    for (const Entry& entry : bucket(key).entries) {
+        const uint64_t DATA = entry.data.load(std::memory_order_relaxed);
+        const uint64_t CHECK = entry.check.load(std::memory_order_relaxed);
+        if ((CHECK ^ DATA) != key || boundOf(DATA) == Bound::NONE) { continue; }
+
+        data.move = moveOf(DATA);
+        data.score = static_cast<int16_t>((DATA >> SCORE_SHIFT) & WORD_MASK);
+        data.eval = static_cast<int16_t>((DATA >> EVAL_SHIFT) & WORD_MASK);
+        data.depth = depthOf(DATA);
+        data.bound = boundOf(DATA);
+        return true;
+    }
+    return false;
+}
+
+auto TranspositionTable::store(HashKey key, Move move, int score, int eval, int depth, Bound bound)
+    -> void
+{
+    Bucket& target = bucket(key);
+    Entry* replace = &target.entries[0];
+    int worst = std::numeric_limits<int>::max();
+
+    UNROLL_LOOP
+    for (Entry& entry : target.entries) {
+        const uint64_t DATA = entry.data.load(std::memory_order_relaxed);
+        const uint64_t CHECK = entry.check.load(std::memory_order_relaxed);
+
+        if ((CHECK ^ DATA) == key && boundOf(DATA) != Bound::NONE) {
+            // Keep a deeper result for the same position from this search unless the new one
+            // is exact, and keep its move when the new result has none
+            if (bound != Bound::EXACT && generationOf(DATA) == m_generation &&
+                depth + SAME_KEY_DEPTH_MARGIN <= depthOf(DATA)) {
+                return;
+            }
+            if (move.isNone()) { move = moveOf(DATA); }
+            replace = &entry;
+            break;
+        }
+
+        // Prefer evicting empty, shallow and old entries
+        const int AGE = (m_generation - generationOf(DATA)) & GENERATION_MASK;
+        const int VALUE = boundOf(DATA) == Bound::NONE ? std::numeric_limits<int>::min()
+                                                       : depthOf(DATA) - (AGE_WEIGHT * AGE);
+        if (VALUE < worst) {
+            worst = VALUE;
+            replace = &entry;
+        }
+    }
+
+    const uint64_t DATA = pack(move, score, eval, depth, bound, m_generation);
+    replace->check.store(key ^ DATA, std::memory_order_relaxed);
+    replace->data.store(DATA, std::memory_order_relaxed);
+}
+
+auto TranspositionTable::hashfull() const -> int
+{
+    const std::size_t BUCKETS = std::min<std::size_t>(
+        m_bucket_count, Constants::TT::HASHFULL_SAMPLE / Constants::TT::ENTRIES_PER_BUCKET);
+
+    int used = 0;
+    for (std::size_t i = 0; i < BUCKETS; ++i) {
+        for (const Entry& entry : m_buckets[i].entries) {
+            const uint64_t DATA = entry.data.load(std::memory_order_relaxed);
+            if (boundOf(DATA) != Bound::NONE && generationOf(DATA) == m_generation) { ++used; }
+        }
+    }
+    const auto SAMPLED = static_cast<int>(BUCKETS) * Constants::TT::ENTRIES_PER_BUCKET;
+    return used * Constants::TT::HASHFULL_SAMPLE / SAMPLED;
+}
+
+auto TranspositionTable::sizeInBytes() const -> std::size_t
+{
+    return m_bucket_count * sizeof(Bucket);
+}
+
+} // namespace Chess
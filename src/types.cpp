@@ -7,26 +7,6 @@
 
 namespace Chess::Util {
 
-auto getPieceColor(Piece piece) -> Color
-{
-    if (piece == Piece::NONE) { return Color::NONE; }
-    return fromIdx<Color>(toIdx(piece) / Constants::PIECE_COLOR_OFFSET);
-}
-
-auto getPieceType(Piece piece) -> PieceType
-{
-    if (piece == Piece::NONE) { return PieceType::NONE; }
-    return fromIdx<PieceType>(toIdx(piece) % Constants::PIECE_COLOR_OFFSET);
-}
-
-auto makePiece(PieceType type, Color color) -> Piece
-{
-    if (type == PieceType::NONE) { return Piece::NONE; }
-    if (color == Color::NONE) { return Piece::NONE; }
-
-    return fromIdx<Piece>(toIdx(type) + (toIdx(color) * Constants::PIECE_COLOR_OFFSET));
-}
-
 auto squareToString(Square square) -> std::string
 {
     if (square == Square::NONE) { return "-"; }
@@ -52,27 +32,6 @@ auto stringToSquare(const std::string& str) -> Square
     return makeSquare(FILE_CHAR - 'a', RANK_CHAR - '1');
 }
 
-auto getFile(Square square) -> int
-{
-    if (square == Square::NONE) { return Constants::Board::NO_SQUARE; }
-    return toIdx(square) % Constants::Board::LENGTH;
-}
-
-auto getRank(Square square) -> int
-{
-    if (square == Square::NONE) { return Constants::Board::NO_SQUARE; }
-    return toIdx(square) / Constants::Board::LENGTH;
-}
-
-auto makeSquare(int file, int rank) -> Square
-{
-    if (file < 0 || file > Constants::Board::LENGTH - 1 || rank < 0 ||
-        rank > Constants::Board::LENGTH - 1) {
-        return Square::NONE;
-    }
-    return fromIdx<Square>((rank * Constants::Board::LENGTH) + file);
-}
-
 auto pieceToChar(Piece piece) -> char
 {
     switch (piece) {
@@ -0,0 +1,430 @@
+#include "uci.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <utility>
+
+#include "constants.h"
+#include "epd.h"
+#include "move.h"
+#include "movegen.h"
+#include "nnue.h"
+#include "polyglot.h"
+
+namespace Chess::Uci {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::string_view START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Every `go` parameter, so a list of moves after searchmoves ends at the next one
+constexpr std::array<std::string_view, 12> GO_KEYWORDS = {
+    "searchmoves", "ponder", "wtime", "btime",    "winc", "binc",
+    "movestogo",   "depth",  "nodes", "movetime", "mate", "infinite"};
+
+constexpr int MAX_HASH_MB = Constants::TT::MAX_SIZE_MB;
+constexpr int MAX_THREADS = 256;
+
+auto parseNumber(std::string_view text, int64_t& value) -> bool
+{
+    const char* const END = text.data() + text.size();
+    const auto [LAST, STATUS] = std::from_chars(text.data(), END, value);
+    return STATUS == std::errc() && LAST == END;
+}
+
+// The legal move written as `uci`, or a null move
+auto parseMove(const Position& pos, std::string_view uci) -> Move
+{
+    for (const Move MOVE : MoveGen::generateLegal(pos)) {
+        if (MOVE.toUci() == uci) { return MOVE; }
+    }
+    return Move();
+}
+
+// Whether `moves` is `prefix` followed by more space-separated moves, or equal to it
+auto extendsMoves(std::string_view moves, std::string_view prefix) -> bool
+{
+    if (prefix.empty()) { return true; }
+    return moves.substr(0, prefix.size()) == prefix &&
+           (moves.size() == prefix.size() || moves[prefix.size()] == ' ');
+}
+
+} // namespace
+
+Engine::Engine(std::ostream& out)
+    : m_out(out), m_pool(m_table, 1), m_base("startpos"), m_search_thread([this] { searchLoop(); })
+{
+    m_pool.setReporter([this](const Search::Result& result) {
+        send(infoLine(result, std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  Clock::now() - m_search_start)));
+    });
+}
+
+Engine::~Engine()
+{
+    {
+        const std::lock_guard<std::mutex> LOCK(m_mutex);
+        m_quit = true;
+        m_stop_requested = true;
+        if (m_searching) { m_pool.stop(); }
+    }
+    m_changed.notify_all();
+    m_search_thread.join();
+}
+
+auto Engine::loop(std::istream& in) -> void
+{
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!execute(line)) { break; }
+    }
+    stop();
+    waitForSearch();
+}
+
+auto Engine::execute(std::string_view line) -> bool
+{
+    std::string_view args = line;
+    const std::string_view COMMAND = Epd::nextToken(args);
+    args = Epd::trim(args);
+
+    if (COMMAND == "uci") {
+        send("id name DuChess\nid author the DuChess developers\n"
+             "option name Hash type spin default " +
+             std::to_string(Constants::TT::DEFAULT_SIZE_MB) + " min 1 max " +
+             std::to_string(MAX_HASH_MB) + "\noption name Threads type spin default 1 min 1 max " +
+             std::to_string(MAX_THREADS) +
+             "\noption name Ponder type check default false"
+             "\noption name OwnBook type check default false"
+             "\noption name BookFile type string default <empty>"
+             "\noption name BitbasePath type string default <empty>"
+             "\noption name EvalFile type string default <empty>\nuciok");
+    }
+    else if (COMMAND == "isready") { send("readyok"); }
+    else if (COMMAND == "ucinewgame") {
+        whenIdle([this] { m_table.clear(); });
+    }
+    else if (COMMAND == "setoption") { setOption(args); }
+    else if (COMMAND == "position") { position(args); }
+    else if (COMMAND == "go") { go(args); }
+    else if (COMMAND == "stop") { stop(); }
+    else if (COMMAND == "ponderhit") { ponderhit(); }
+    else if (COMMAND == "d") { send("Fen: " + m_pos.toFen()); }
+    else if (COMMAND == "quit") { return false; }
+    else if (!COMMAND.empty()) { send("info string unknown command " + std::string(COMMAND)); }
+    return true;
+}
+
+auto Engine::position(std::string_view args) -> void
+{
+    const std::size_t MOVES_AT = args.find("moves");
+    std::string_view base = Epd::trim(args.substr(0, MOVES_AT));
+    const std::string_view MOVES = MOVES_AT == std::string_view::npos
+                                       ? std::string_view()
+                                       : Epd::trim(args.substr(MOVES_AT + 5));
+
+    // A GUI repeats the whole game each move; replay only the moves added since last time
+    std::string_view pending = MOVES;
+    if (base == m_base && extendsMoves(MOVES, m_moves)) { pending.remove_prefix(m_moves.size()); }
+    else {
+        const std::string_view KIND = Epd::nextToken(base);
+        std::string_view fen = START_FEN;
+        if (KIND == "fen") { fen = Epd::trim(base); }
+        else if (KIND != "startpos" || !Epd::trim(base).empty()) {
+            send("info string position needs startpos or fen");
+            return;
+        }
+
+        const FenError ERROR = m_pos.fromFen(fen);
+        if (ERROR != FenError::NONE) {
+            send("info string invalid fen: " + std::string(fenErrorToString(ERROR)));
+            m_base.clear();
+            m_moves.clear();
+            return;
+        }
+        m_base = Epd::trim(args.substr(0, MOVES_AT));
+        m_moves.clear();
+    }
+
+    for (std::string_view token = Epd::nextToken(pending); !token.empty();
+         token = Epd::nextToken(pending)) {
+        const Move MOVE = parseMove(m_pos, token);
+        if (MOVE.isNone()) {
+            send("info string illegal move " + std::string(token));
+            break;
+        }
+        m_pos.makeMove(MOVE);
+        if (!m_moves.empty()) { m_moves += ' '; }
+        m_moves += token;
+    }
+}
+
+auto Engine::go(std::string_view args) -> void
+{
+    Search::Limits limits;
+    bool infinite = false;
+    const bool WHITE = m_pos.getSideToMove() == Color::WHITE;
+
+    for (std::string_view token = Epd::nextToken(args); !token.empty();
+         token = Epd::nextToken(args)) {
+        if (token == "infinite") {
+            infinite = true;
+            continue;
+        }
+        if (token == "ponder") {
+            limits.ponder = true;
+            continue;
+        }
+        // Not supported: the move list is skipped and the search considers every move
+        if (token == "searchmoves") {
+            std::string_view rest = args;
+            for (std::string_view next = Epd::nextToken(rest);
+                 !next.empty() &&
+                 std::find(GO_KEYWORDS.begin(), GO_KEYWORDS.end(), next) == GO_KEYWORDS.end();
+                 next = Epd::nextToken(rest)) {
+                args = rest;
+            }
+            continue;
+        }
+        if (std::find(GO_KEYWORDS.begin(), GO_KEYWORDS.end(), token) == GO_KEYWORDS.end()) {
+            send("info string unknown go parameter " + std::string(token));
+            continue;
+        }
+
+        int64_t value = 0;
+        const bool NUMBER = parseNumber(Epd::nextToken(args), value);
+        if (!NUMBER || value < 0) {
+            send("info string invalid value for " + std::string(token));
+            continue;
+        }
+        if (token == "depth") { limits.depth = static_cast<int>(value); }
+        else if (token == "nodes") { limits.nodes = static_cast<uint64_t>(value); }
+        else if (token == "movetime") { limits.movetime = std::chrono::milliseconds(value); }
+        // A flagging clock can read zero; that still means moving at once, not no clock
+        else if (token == (WHITE ? "wtime" : "btime")) {
+            limits.time = std::chrono::milliseconds(std::max<int64_t>(1, value));
+        }
+        else if (token == (WHITE ? "winc" : "binc")) {
+            limits.increment = std::chrono::milliseconds(value);
+        }
+        else if (token == "movestogo") { limits.moves_to_go = static_cast<int>(value); }
+        // mate is not supported; a normal search finds short mates anyway
+    }
+
+    // Waiting here would keep stop and quit from being read, so a second go is refused
+    {
+        const std::lock_guard<std::mutex> LOCK(m_mutex);
+        if (m_busy) {
+            send("info string search already running");
+            return;
+        }
+    }
+
+    // A book move is played at once, unless the GUI wants a search it ends itself
+    if (m_own_book && !infinite && !limits.ponder) {
+        const Move BOOK_MOVE = m_book.pick(m_pos, m_random());
+        if (!BOOK_MOVE.isNone()) {
+            send("bestmove " + BOOK_MOVE.toUci());
+            return;
+        }
+    }
+    {
+        const std::lock_guard<std::mutex> LOCK(m_mutex);
+        m_root = m_pos;
+        m_limits = limits;
+        m_infinite = infinite;
+        m_pending = true;
+        m_busy = true;
+        m_stop_requested = false;
+        m_ponderhit_received = false;
+    }
+    m_changed.notify_all();
+}
+
+auto Engine::setOption(std::string_view args) -> void
+{
+    // setoption name <id> value <x>
+    const std::size_t VALUE_AT = args.find(" value ");
+    const std::string_view NAME =
+        Epd::trim(args.substr(0, VALUE_AT).substr(args.rfind("name", 0) == 0 ? 4 : 0));
+    const std::string_view VALUE = VALUE_AT == std::string_view::npos
+                                       ? std::string_view()
+                                       : Epd::trim(args.substr(VALUE_AT + 7));
+    int64_t value = 0;
+    const bool NUMBER = parseNumber(VALUE, value);
+
+    if (NAME == "Hash" && NUMBER) {
+        const auto MEGABYTES = static_cast<std::size_t>(std::clamp<int64_t>(value, 1, MAX_HASH_MB));
+        whenIdle([this, MEGABYTES] { m_table.resize(MEGABYTES); });
+    }
+    else if (NAME == "Threads" && NUMBER) {
+        const auto THREADS = static_cast<std::size_t>(std::clamp<int64_t>(value, 1, MAX_THREADS));
+        whenIdle([this, THREADS] { m_pool.resize(THREADS); });
+    }
+    else if (NAME == "OwnBook") { m_own_book = VALUE == "true"; }
+    else if (NAME == "BookFile") {
+        if (VALUE.empty() || VALUE == "<empty>") { m_book.close(); }
+        else if (!m_book.open(std::string(VALUE))) {
+            send("info string cannot open book " + std::string(VALUE));
+        }
+    }
+    else if (NAME == "BitbasePath") {
+        whenIdle([this, PATH = std::string(VALUE)] {
+            m_bitbases.clear();
+            if (!PATH.empty() && PATH != "<empty>") {
+                send("info string loaded " + std::to_string(m_bitbases.load(PATH)) + " bitbases");
+            }
+            m_pool.setBitbases(m_bitbases.size() > 0 ? &m_bitbases : nullptr);
+        });
+    }
+    // Without a network the search uses the hand-written evaluation
+    else if (NAME == "EvalFile") {
+        whenIdle([this, PATH = std::string(VALUE)] {
+            if (PATH.empty() || PATH == "<empty>") {
+                m_pool.setNetwork(nullptr);
+                m_network.reset();
+                return;
+            }
+            auto network = std::make_unique<NNUE::Network>();
+            if (!NNUE::load(PATH, *network)) {
+                send("info string cannot load network " + PATH);
+                return;
+            }
+            m_network = std::move(network);
+            m_pool.setNetwork(m_network.get());
+            send("info string loaded network " + PATH);
+        });
+    }
+    else if (NAME != "Ponder") {
+        send("info string unsupported option " + std::string(NAME));
+    }
+}
+
+auto Engine::stop() -> void
+{
+    {
+        const std::lock_guard<std::mutex> LOCK(m_mutex);
+        if (!m_busy) { return; }
+        m_stop_requested = true;
+        if (m_searching) { m_pool.stop(); }
+    }
+    m_changed.notify_all();
+}
+
+auto Engine::ponderhit() -> void
+{
+    {
+        const std::lock_guard<std::mutex> LOCK(m_mutex);
+        if (!m_busy) { return; }
+        m_ponderhit_received = true;
+        if (m_searching) { m_pool.ponderhit(); }
+    }
+    m_changed.notify_all();
+}
+
+auto Engine::waitForSearch() -> void
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_changed.wait(lock, [this] { return !m_busy; });
+}
+
+// Nothing the search reads may change under it, so such changes wait for the search thread
+// to go idle; the input thread never blocks on a search it may be the one to stop
+auto Engine::whenIdle(std::function<void()> action) -> void
+{
+    {
+        const std::lock_guard<std::mutex> LOCK(m_mutex);
+        if (m_busy) {
+            m_deferred.push_back(std::move(action));
+            return;
+        }
+    }
+    // Only the input thread starts searches, so none can start while this runs
+    action();
+}
+
+auto Engine::searchLoop() -> void
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_changed.wait(lock, [this] { return m_pending || m_quit; });
+        if (!m_pending) { return; }
+        m_pending = false;
+
+        // Signals that came in before the pool started are passed on now
+        m_searching = true;
+        if (m_stop_requested) { m_pool.stop(); }
+        if (m_ponderhit_received) { m_pool.ponderhit(); }
+        lock.unlock();
+
+        m_search_start = Clock::now();
+        const Search::Result RESULT = m_pool.search(m_root, m_limits);
+        const auto ELAPSED =
+            std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - m_search_start);
+
+        lock.lock();
+        m_searching = false;
+        m_pool.clearSignals();
+
+        // No best move may be sent during an infinite or pondering search until the GUI ends it
+        m_changed.wait(lock, [this] {
+            return m_stop_requested || m_quit ||
+                   (!m_infinite && (!m_limits.ponder || m_ponderhit_received));
+        });
+        report(RESULT, ELAPSED);
+
+        // Applied before the next go can be accepted, in the order they were sent
+        while (!m_deferred.empty()) {
+            std::vector<std::function<void()>> deferred;
+            deferred.swap(m_deferred);
+            lock.unlock();
+            for (const auto& action : deferred) { action(); }
+            lock.lock();
+        }
+        m_busy = false;
+        m_changed.notify_all();
+    }
+}
+
+// The summary of one search, or of its last completed iteration so far
+auto Engine::infoLine(const Search::Result& result, std::chrono::milliseconds elapsed) const
+    -> std::string
+{
+    std::ostringstream info;
+    info << "info depth " << result.depth << " seldepth " << result.seldepth << " score ";
+    if (Constants::Search::isMateScore(result.score)) {
+        const int PLIES = Constants::Search::MATE_SCORE - std::abs(result.score);
+        info << "mate " << (result.score > 0 ? (PLIES + 1) / 2 : -(PLIES / 2));
+    }
+    else {
+        info << "cp " << result.score;
+    }
+    const auto MILLISECONDS = std::max<int64_t>(1, elapsed.count());
+    info << " nodes " << result.nodes << " nps "
+         << (result.nodes * 1000 / static_cast<uint64_t>(MILLISECONDS)) << " time "
+         << elapsed.count() << " hashfull " << m_table.hashfull() << " pv";
+    for (const Move MOVE : result.pv) { info << ' ' << MOVE.toUci(); }
+    return info.str();
+}
+
+auto Engine::report(const Search::Result& result, std::chrono::milliseconds elapsed) -> void
+{
+    std::string lines = infoLine(result, elapsed) + "\nbestmove " + result.best_move.toUci();
+    if (result.pv.size() > 1) { lines += " ponder " + result.pv[1].toUci(); }
+    send(lines);
+}
+
+auto Engine::send(std::string_view line) -> void
+{
+    const std::lock_guard<std::mutex> LOCK(m_output);
+    m_out << line << std::endl;
+}
+
+} // namespace Chess::Uci
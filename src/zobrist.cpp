@@ -15,6 +15,9 @@ std::array<std::array<HashKey, Constants::Board::SQUARE_COUNT>, Constants::Zobri
 HashKey Zobrist::side_to_move_key;
 std::array<HashKey, Constants::Zobrist::CASTLING_COMBINATIONS> Zobrist::castling_keys;
 std::array<HashKey, Constants::Board::SQUARE_COUNT_WITH_EMPTY> Zobrist::en_passant_keys;
+std::array<std::array<HashKey, Constants::Zobrist::MAX_PIECES_PER_TYPE>,
+           Constants::Zobrist::PIECE_COUNT>
+    Zobrist::material_keys;
 
 auto Zobrist::init() -> void
 {
@@ -34,6 +37,12 @@ auto Zobrist::init() -> void
     for (auto& keys : castling_keys) { keys = rng(); }
     UNROLL_PARTIAL
     for (auto& keys : en_passant_keys) { keys = rng(); }
+
+    // Drawn last so the keys above stay the same
+    for (auto& piece : material_keys) {
+        UNROLL_PARTIAL
+        for (auto& count : piece) { count = rng(); }
+    }
 }
 
 auto Zobrist::getPieceSquareKey(Piece piece, Square square) -> HashKey
@@ -58,4 +67,11 @@ auto Zobrist::getEnPassantKey(Square square) -> HashKey
     return en_passant_keys.at(toIdx(square));
 }
 
+auto Zobrist::getMaterialKey(Piece piece, int count) -> HashKey
+{
+    // Pieces past the most a game can produce, as in a hand-made FEN, leave the key alone
+    if (piece == Piece::NONE || count >= Constants::Zobrist::MAX_PIECES_PER_TYPE) { return 0; }
+    return material_keys.at(toIdx(piece)).at(count);
+}
+
 } // namespace Chess
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bitbase.h"
+#include "bitboard.h"
+#include "constants.h"
+#include "position.h"
+#include "search.h"
+#include "tt.h"
+#include "zobrist.h"
+
+using namespace Chess;
+using Bitbases::Wdl;
+
+class BitbaseTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        Bitboards::init();
+        Zobrist::init();
+    }
+
+    static auto signature(const std::string& name) -> Bitbases::Signature
+    {
+        Bitbases::Signature result;
+        EXPECT_TRUE(Bitbases::parseSignature(name, result)) << name;
+        return result;
+    }
+
+    // KQK and KRK, then KPK which promotes into them; generated once for the whole suite
+    static auto tables() -> const Bitbases::Set&
+    {
+        static const std::unique_ptr<Bitbases::Set> SET = [] {
+            auto set = std::make_unique<Bitbases::Set>();
+            for (const char* name : {"KQK", "KRK", "KPK"}) {
+                auto table = std::make_unique<Bitbases::Table>();
+                EXPECT_TRUE(Bitbases::generate(signature(name), *set, 2, *table)) << name;
+                set->add(std::move(table));
+            }
+            return set;
+        }();
+        return *SET;
+    }
+
+    static auto probe(const std::string& fen) -> Wdl
+    {
+        return tables().probe(Position(fen));
+    }
+};
+
+TEST_F(BitbaseTest, Signatures)
+{
+    EXPECT_EQ(Bitbases::signatureName(signature("KPKR")), "KPKR");
+    EXPECT_EQ(signature("KPRK"), signature("KRPK"));
+    EXPECT_EQ(Bitbases::signatureName(Bitbases::canonical(signature("KPKR"))), "KRKP");
+    EXPECT_EQ(Bitbases::signatureName(Bitbases::canonical(signature("KKQ"))), "KQK");
+
+    Bitbases::Signature unused;
+    EXPECT_FALSE(Bitbases::parseSignature("KRRRK", unused));
+    EXPECT_FALSE(Bitbases::parseSignature("KXK", unused));
+    EXPECT_FALSE(Bitbases::parseSignature("RK", unused));
+
+    // Captures and promotions, without the trivially drawn KK and KNK
+    std::vector<std::string> names;
+    for (const auto& dependency : Bitbases::dependencies(signature("KRKP"))) {
+        names.push_back(Bitbases::signatureName(dependency));
+    }
+    EXPECT_EQ(names, (std::vector<std::string>{"KPK", "KRK", "KQKR", "KQK", "KRKR", "KRKB",
+                                               "KRKN"}));
+    EXPECT_TRUE(Bitbases::dependencies(signature("KQK")).empty());
+}
+
+TEST_F(BitbaseTest, PawnlessResults)
+{
+    EXPECT_EQ(probe("8/8/8/4k3/8/8/8/R3K3 w - - 0 1"), Wdl::WIN);
+    EXPECT_EQ(probe("8/8/8/4k3/8/8/8/R3K3 b - - 0 1"), Wdl::LOSS);
+    // The king takes the rook
+    EXPECT_EQ(probe("8/8/8/8/8/8/k7/R6K b - - 0 1"), Wdl::DRAW);
+    EXPECT_EQ(probe("k7/2Q5/1K6/8/8/8/8/8 b - - 0 1"), Wdl::DRAW);
+    EXPECT_EQ(probe("k7/1Q6/1K6/8/8/8/8/8 b - - 0 1"), Wdl::LOSS);
+    // The same material for Black is found through the flipped table
+    EXPECT_EQ(probe("8/8/8/4k3/8/8/q7/4K3 b - - 0 1"), Wdl::WIN);
+}
+
+TEST_F(BitbaseTest, KingAndPawnResults)
+{
+    EXPECT_EQ(probe("k7/8/8/8/8/8/P7/7K w - - 0 1"), Wdl::DRAW);
+    EXPECT_EQ(probe("3k4/8/3K4/8/3P4/8/8/8 b - - 0 1"), Wdl::LOSS);
+    // Outside the square of the pawn unless Black moves first
+    EXPECT_EQ(probe("8/5k2/8/8/P7/8/8/7K w - - 0 1"), Wdl::WIN);
+    EXPECT_EQ(probe("8/5k2/8/8/P7/8/8/7K b - - 0 1"), Wdl::DRAW);
+    EXPECT_EQ(probe("8/8/8/3p4/8/3k4/8/3K4 w - - 0 1"), Wdl::LOSS);
+}
+
+TEST_F(BitbaseTest, EnPassantReplies)
+{
+    // The promotion tables are stand-ins drawn throughout, which the position below never
+    // reaches; KPK is real
+    Bitbases::Set known;
+    for (const auto& dependency : Bitbases::dependencies(signature("KPKP"))) {
+        auto table = std::make_unique<Bitbases::Table>();
+        if (dependency == signature("KPK")) {
+            ASSERT_TRUE(Bitbases::generate(dependency, tables(), 2, *table));
+        }
+        else {
+            table->assign(dependency,
+                          std::vector<uint8_t>((Bitbases::tableSize(dependency) + 3) / 4, 0));
+        }
+        known.add(std::move(table));
+    }
+    auto kpkp = std::make_unique<Bitbases::Table>();
+    ASSERT_TRUE(Bitbases::generate(signature("KPKP"), known, 2, *kpkp));
+    known.add(std::move(kpkp));
+
+    // 1. e4 would be the only win, were it not for 1... dxe3 e.p. into a drawn KPK
+    EXPECT_EQ(known.probe(Position("8/8/8/8/3p4/3K4/4P3/4k3 w - - 0 1")), Wdl::DRAW);
+}
+
+TEST_F(BitbaseTest, UncoveredPositions)
+{
+    // Too many pieces, and material without a table
+    EXPECT_EQ(probe("8/8/8/4k3/8/8/3P4/R3KB2 w - - 0 1"), Wdl::UNKNOWN);
+    EXPECT_EQ(probe("8/8/8/4k3/8/8/3P4/R3K3 w - - 0 1"), Wdl::UNKNOWN);
+    EXPECT_EQ(probe("4k3/8/8/8/8/8/8/R3K3 w Q - 0 1"), Wdl::UNKNOWN);
+    EXPECT_EQ(probe("8/8/8/8/8/8/8/2k1K2N w - - 0 1"), Wdl::DRAW);
+    EXPECT_EQ(Bitbases::Set().probe(Position("8/8/8/4k3/8/8/8/R3K3 w - - 0 1")), Wdl::UNKNOWN);
+}
+
+TEST_F(BitbaseTest, SaveAndMap)
+{
+    const auto PATH = std::filesystem::temp_directory_path() / "duchess_bitbase_test.bb";
+    const Bitbases::Table* krk = tables().find(signature("KRK"));
+    ASSERT_NE(krk, nullptr);
+    ASSERT_TRUE(krk->save(PATH.string()));
+
+    Bitbases::Table mapped;
+    ASSERT_TRUE(mapped.open(PATH.string()));
+    EXPECT_EQ(mapped.signature(), krk->signature());
+    ASSERT_EQ(mapped.size(), krk->size());
+    for (std::size_t index = 0; index < mapped.size(); ++index) {
+        ASSERT_EQ(mapped.value(index), krk->value(index)) << index;
+    }
+
+    // A truncated file is rejected
+    std::filesystem::resize_file(PATH, std::filesystem::file_size(PATH) - 1);
+    EXPECT_FALSE(mapped.open(PATH.string()));
+    std::filesystem::remove(PATH);
+    EXPECT_FALSE(mapped.open(PATH.string()));
+}
+
+TEST_F(BitbaseTest, SearchProbesBelowRoot)
+{
+    TranspositionTable table(1);
+    Search::Searcher searcher(table);
+    searcher.setBitbases(&tables());
+    Search::Limits limits;
+    limits.depth = 4;
+
+    // Taking the rook leaves a won KPK ending
+    const auto RESULT = searcher.search(Position("k7/8/6P1/8/8/8/8/6Kr w - - 0 1"), limits);
+    EXPECT_EQ(RESULT.best_move, Move(Square::G1, Square::H1, MoveFlag::CAPTURE));
+    EXPECT_GE(RESULT.score, Constants::Search::BITBASE_BOUND);
+    EXPECT_LT(RESULT.score, Constants::Search::MATE_BOUND);
+}
@@ -1,3 +1,5 @@
+#include <random>
+
 #include <gtest/gtest.h>
 
 #include "bitboard.h"
@@ -61,6 +63,20 @@ TEST_F(BitboardTest, LsbMsb)
     EXPECT_EQ(Bitboards::msb(MULTIPLE), Square::H8);
 }
 
+TEST_F(BitboardTest, LsbMsbAllSquares)
+{
+    UNROLL_LOOP
+    for (unsigned int sq = 0; sq < Constants::Board::SQUARE_COUNT; ++sq) {
+        const Bitboard BIT = 1ULL << sq;
+        EXPECT_EQ(Bitboards::lsb(BIT), fromIdx<Square>(sq));
+        EXPECT_EQ(Bitboards::msb(BIT), fromIdx<Square>(sq));
+
+        // Lower and higher noise must not disturb the opposite scan
+        EXPECT_EQ(Bitboards::lsb(BIT | (~0ULL << sq)), fromIdx<Square>(sq));
+        EXPECT_EQ(Bitboards::msb(BIT | (BIT - 1)), fromIdx<Square>(sq));
+    }
+}
+
 TEST_F(BitboardTest, PopCount)
 {
     constexpr unsigned int TEST_H8 = 63;
@@ -81,6 +97,37 @@ TEST_F(BitboardTest, PopCount)
     EXPECT_EQ(Bitboards::popCount(~0ULL), 64);
 }
 
+// Whichever kernels the build selected must agree with plain loops
+TEST_F(BitboardTest, BitScansMatchReference)
+{
+    constexpr std::uint64_t SEED = 0xB175CA4EULL;
+    constexpr int SAMPLES = 4096;
+
+    // NOLINTNEXTLINE(cert-msc51-cpp,cert-msc32-c) - For reproducible testing env
+    std::mt19937_64 rng(SEED);
+
+    EXPECT_STRNE(Bitboards::kernels(), "");
+    for (int i = 0; i < SAMPLES; ++i) {
+        // Alternate dense and sparse boards so both ends of the count range are covered
+        const Bitboard BOARD = (i % 2 == 0) ? rng() : rng() & rng() & rng();
+        if (BOARD == 0) { continue; }
+
+        int count = 0;
+        int lowest = -1;
+        int highest = -1;
+        for (int sq = 0; sq < Constants::Board::SQUARE_COUNT; ++sq) {
+            if (((BOARD >> sq) & 1ULL) == 0) { continue; }
+            ++count;
+            if (lowest < 0) { lowest = sq; }
+            highest = sq;
+        }
+
+        ASSERT_EQ(Bitboards::popCount(BOARD), count);
+        ASSERT_EQ(Bitboards::lsb(BOARD), fromIdx<Square>(lowest));
+        ASSERT_EQ(Bitboards::msb(BOARD), fromIdx<Square>(highest));
+    }
+}
+
 TEST_F(BitboardTest, PopLsb)
 {
     // Test with single bit
@@ -156,4 +203,131 @@ TEST_F(BitboardTest, ShiftOperations)
     EXPECT_EQ(northWestOne(BITB), squareBB(Square::D5));
     EXPECT_EQ(southEastOne(BITB), squareBB(Square::F3));
     EXPECT_EQ(southWestOne(BITB), squareBB(Square::D3));
-}
\ No newline at end of file
+}
+
+namespace {
+
+// Slow ray walk used as the reference for the slider lookup tables
+auto referenceAttacks(Square square, Bitboard occupied, bool rook) -> Bitboard
+{
+    constexpr std::array<std::array<int, 2>, 4> ROOK_DIRS = {{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+    constexpr std::array<std::array<int, 2>, 4> BISHOP_DIRS = {
+        {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}};
+
+    Bitboard attacks = 0;
+    for (const auto& dir : rook ? ROOK_DIRS : BISHOP_DIRS) {
+        Square target = makeSquare(getFile(square) + dir[0], getRank(square) + dir[1]);
+        while (target != Square::NONE) {
+            setBit(attacks, target);
+            if (testBit(occupied, target)) { break; }
+            target = makeSquare(getFile(target) + dir[0], getRank(target) + dir[1]);
+        }
+    }
+    return attacks;
+}
+
+} // namespace
+
+TEST_F(BitboardTest, SliderAttacksEmptyBoard)
+{
+    // Rook on an empty board sees its whole file and rank
+    EXPECT_EQ(Bitboards::rookAttacks(Square::D4, 0),
+              (Bitboards::files.at(3) | Bitboards::ranks.at(3)) & ~squareBB(Square::D4));
+
+    // Bishop on a1 sees the long diagonal
+    EXPECT_EQ(Bitboards::bishopAttacks(Square::A1, 0),
+              Bitboards::diagonals.at(7) & ~squareBB(Square::A1));
+
+    EXPECT_EQ(Bitboards::popCount(Bitboards::queenAttacks(Square::D4, 0)), 27);
+}
+
+TEST_F(BitboardTest, SliderAttacksBlockers)
+{
+    // Blockers are included in the attack set, squares behind them are not
+    const Bitboard OCCUPIED = squareBB(Square::D6) | squareBB(Square::F4) | squareBB(Square::B2);
+
+    const Bitboard ROOK = Bitboards::rookAttacks(Square::D4, OCCUPIED);
+    EXPECT_TRUE(testBit(ROOK, Square::D6));
+    EXPECT_FALSE(testBit(ROOK, Square::D7));
+    EXPECT_TRUE(testBit(ROOK, Square::F4));
+    EXPECT_FALSE(testBit(ROOK, Square::G4));
+    EXPECT_TRUE(testBit(ROOK, Square::D1));
+
+    const Bitboard BISHOP = Bitboards::bishopAttacks(Square::D4, OCCUPIED);
+    EXPECT_TRUE(testBit(BISHOP, Square::B2));
+    EXPECT_FALSE(testBit(BISHOP, Square::A1));
+    EXPECT_TRUE(testBit(BISHOP, Square::H8));
+}
+
+TEST_F(BitboardTest, SliderAttacksMatchReference)
+{
+    constexpr std::uint64_t SEED = 0x5EEDF00DULL;
+    constexpr int SAMPLES_PER_SQUARE = 256;
+
+    // NOLINTNEXTLINE(cert-msc51-cpp,cert-msc32-c) - For reproducible testing env
+    std::mt19937_64 rng(SEED);
+
+    for (int sq = 0; sq < Constants::Board::SQUARE_COUNT; ++sq) {
+        const auto SQUARE = fromIdx<Square>(sq);
+        for (int i = 0; i < SAMPLES_PER_SQUARE; ++i) {
+            const Bitboard OCCUPIED = rng() & rng();
+
+            ASSERT_EQ(Bitboards::bishopAttacks(SQUARE, OCCUPIED),
+                      referenceAttacks(SQUARE, OCCUPIED, false));
+            ASSERT_EQ(Bitboards::rookAttacks(SQUARE, OCCUPIED),
+                      referenceAttacks(SQUARE, OCCUPIED, true));
+
+#if defined(USE_PEXT)
+            ASSERT_EQ(Bitboards::bishopAttacks<Bitboards::SliderBackend::MAGIC>(SQUARE, OCCUPIED),
+                      Bitboards::bishopAttacks<Bitboards::SliderBackend::PEXT>(SQUARE, OCCUPIED));
+            ASSERT_EQ(Bitboards::rookAttacks<Bitboards::SliderBackend::MAGIC>(SQUARE, OCCUPIED),
+                      Bitboards::rookAttacks<Bitboards::SliderBackend::PEXT>(SQUARE, OCCUPIED));
+#endif
+        }
+    }
+}
+
+// Tables and bit scans must be usable in constant expressions
+static_assert(Bitboards::lsb(0x0000000000000100ULL) == Square::A2);
+static_assert(Bitboards::msb(0x8000000000000001ULL) == Square::H8);
+static_assert(Bitboards::popCount(Bitboards::files[0]) == 8);
+static_assert(Bitboards::knightAttacks(Square::A1) ==
+              (squareBB(Square::B3) | squareBB(Square::C2)));
+
+TEST_F(BitboardTest, LeaperAttacks)
+{
+    // Knight: 8 targets in the centre, 2 in a corner
+    EXPECT_EQ(Bitboards::popCount(Bitboards::knightAttacks(Square::D4)), 8);
+    EXPECT_EQ(Bitboards::popCount(Bitboards::knightAttacks(Square::H8)), 2);
+    EXPECT_TRUE(testBit(Bitboards::knightAttacks(Square::G1), Square::F3));
+    EXPECT_FALSE(testBit(Bitboards::knightAttacks(Square::G1), Square::A2));
+
+    // King: 8 targets in the centre, 3 in a corner
+    EXPECT_EQ(Bitboards::popCount(Bitboards::kingAttacks(Square::E4)), 8);
+    EXPECT_EQ(Bitboards::kingAttacks(Square::A1),
+              squareBB(Square::A2) | squareBB(Square::B1) | squareBB(Square::B2));
+
+    // Pawns capture diagonally forward and never wrap around the board edge
+    EXPECT_EQ(Bitboards::pawnAttacks(Color::WHITE, Square::E4),
+              squareBB(Square::D5) | squareBB(Square::F5));
+    EXPECT_EQ(Bitboards::pawnAttacks(Color::BLACK, Square::E4),
+              squareBB(Square::D3) | squareBB(Square::F3));
+    EXPECT_EQ(Bitboards::pawnAttacks(Color::WHITE, Square::H2), squareBB(Square::G3));
+    EXPECT_EQ(Bitboards::pawnAttacks(Color::BLACK, Square::A7), squareBB(Square::B6));
+    EXPECT_EQ(Bitboards::pawnAttacks(Color::WHITE, Square::C8), 0ULL);
+}
+
+TEST_F(BitboardTest, BetweenAndLine)
+{
+    EXPECT_EQ(Bitboards::between(Square::A1, Square::A4),
+              squareBB(Square::A2) | squareBB(Square::A3));
+    EXPECT_EQ(Bitboards::between(Square::H8, Square::E5),
+              squareBB(Square::G7) | squareBB(Square::F6));
+    EXPECT_EQ(Bitboards::between(Square::E4, Square::E5), 0ULL);
+    EXPECT_EQ(Bitboards::between(Square::A1, Square::B3), 0ULL);
+
+    EXPECT_EQ(Bitboards::line(Square::C3, Square::F6), Bitboards::diagonals.at(7));
+    EXPECT_EQ(Bitboards::line(Square::B2, Square::B7), Bitboards::files.at(1));
+    EXPECT_EQ(Bitboards::line(Square::A8, Square::B7), Bitboards::anti_diagonals.at(7));
+    EXPECT_EQ(Bitboards::line(Square::A1, Square::B3), 0ULL);
+}
@@ -0,0 +1,186 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bitboard.h"
+#include "constants.h"
+#include "dataset.h"
+#include "move.h"
+#include "movegen.h"
+#include "packed.h"
+#include "position.h"
+#include "zobrist.h"
+
+using namespace Chess;
+using namespace Util;
+
+class DatasetTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        Bitboards::init();
+        Zobrist::init();
+    }
+
+    // The samples and every position one and two moves from them
+    static auto walk() -> std::vector<Position>
+    {
+        const std::vector<std::string> FENS = {
+            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+            "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+            "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+            "8/8/4k3/8/2p5/8/B2P4/4K3 b - - 99 1234",
+        };
+
+        std::vector<Position> positions;
+        for (const auto& fen : FENS) {
+            Position pos(fen);
+            positions.push_back(pos);
+            for (const Move FIRST : MoveGen::generateLegal(pos)) {
+                pos.makeMove(FIRST);
+                positions.push_back(pos);
+                for (const Move SECOND : MoveGen::generateLegal(pos)) {
+                    pos.makeMove(SECOND);
+                    positions.push_back(pos);
+                    pos.unmakeMove();
+                }
+                pos.unmakeMove();
+            }
+        }
+        return positions;
+    }
+
+    static auto packed(const std::string& fen) -> PackedPosition
+    {
+        PackedPosition record{};
+        EXPECT_TRUE(Position(fen).pack(record)) << fen;
+        return record;
+    }
+};
+
+TEST_F(DatasetTest, PackRoundTrip)
+{
+    Position loaded;
+    for (const Position& pos : walk()) {
+        PackedPosition record{};
+        ASSERT_TRUE(pos.pack(record));
+        EXPECT_EQ(record.score, Constants::Packed::SCORE_NONE);
+        EXPECT_EQ(record.result, GameResult::NONE);
+
+        ASSERT_EQ(loaded.fromPacked(record), FenError::NONE) << pos.toFen();
+        EXPECT_EQ(loaded.toFen(), pos.toFen());
+        EXPECT_EQ(loaded.hash(), pos.hash());
+        EXPECT_EQ(loaded.pawnKey(), pos.pawnKey());
+        EXPECT_EQ(loaded.materialKey(), pos.materialKey());
+    }
+}
+
+TEST_F(DatasetTest, PackRejectsLargeCounters)
+{
+    PackedPosition record{};
+    EXPECT_TRUE(Position("4k3/8/8/8/8/8/8/4K3 w - - 255 65535").pack(record));
+    EXPECT_FALSE(Position("4k3/8/8/8/8/8/8/4K3 w - - 256 1").pack(record));
+    EXPECT_FALSE(Position("4k3/8/8/8/8/8/8/4K3 w - - 0 65536").pack(record));
+}
+
+TEST_F(DatasetTest, FromPackedRejectsInvalid)
+{
+    const std::string START = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    Position pos;
+
+    // Piece values 7, 8 and 15 do not exist; a1 is the first square, in the low nibble
+    PackedPosition record = packed(START);
+    record.pieces[0] = (record.pieces[0] & 0xF0U) | 7U;
+    EXPECT_EQ(pos.fromPacked(record), FenError::PIECE_PLACEMENT);
+
+    record = packed(START);
+    record.occupancy |= Bitboards::ranks[3];
+    EXPECT_EQ(pos.fromPacked(record), FenError::PIECE_PLACEMENT);
+
+    // The black king, second in square order and so in the high nibble, replaced by a rook
+    record = packed("4k3/8/8/8/8/8/8/4K3 w - - 0 1");
+    record.pieces[0] = static_cast<uint8_t>((record.pieces[0] & 0x0FU) |
+                                            (toIdx(Piece::BLACK_ROOK) << 4U));
+    EXPECT_EQ(pos.fromPacked(record), FenError::KING_COUNT);
+
+    record = packed("4k3/8/8/8/8/8/8/4K3 w - - 0 1");
+    record.state |= toIdx(CastlingRight::WHITE_KINGSIDE) << 1U;
+    EXPECT_EQ(pos.fromPacked(record), FenError::CASTLING);
+
+    record = packed(START);
+    record.en_passant = Square::E3;
+    EXPECT_EQ(pos.fromPacked(record), FenError::EN_PASSANT);
+    record.en_passant = fromIdx<Square>(toIdx(Square::NONE) + 1);
+    EXPECT_EQ(pos.fromPacked(record), FenError::EN_PASSANT);
+
+    // A failed load leaves the position alone
+    EXPECT_EQ(pos.toFen(), START);
+}
+
+TEST_F(DatasetTest, FileRoundTrip)
+{
+    const auto PATH = std::filesystem::temp_directory_path() / "duchess_dataset_test.bin";
+    const std::vector<Position> POSITIONS = walk();
+
+    DatasetWriter writer;
+    ASSERT_TRUE(writer.open(PATH.string()));
+    for (std::size_t i = 0; i < POSITIONS.size(); ++i) {
+        PackedPosition record{};
+        ASSERT_TRUE(POSITIONS[i].pack(record));
+        record.score = static_cast<int16_t>(i);
+        record.result = i % 2 == 0 ? GameResult::WHITE_WIN : GameResult::DRAW;
+        ASSERT_TRUE(writer.write(record));
+    }
+
+    // One corrupt record, which the reader skips
+    PackedPosition corrupt{};
+    ASSERT_TRUE(writer.write(corrupt));
+    ASSERT_TRUE(writer.close());
+    EXPECT_EQ(std::filesystem::file_size(PATH),
+              (POSITIONS.size() + 2) * Constants::Packed::RECORD_SIZE);
+
+    Dataset dataset;
+    ASSERT_TRUE(dataset.open(PATH.string(), Dataset::Access::RANDOM));
+    ASSERT_EQ(dataset.size(), POSITIONS.size() + 1);
+    EXPECT_EQ(dataset[3].score, 3);
+    EXPECT_EQ(std::memcmp(&dataset[POSITIONS.size()], &corrupt, sizeof(corrupt)), 0);
+
+    Position pos;
+    DatasetReader reader(dataset);
+    std::size_t index = 0;
+    while (reader.next(pos)) {
+        ASSERT_LT(index, POSITIONS.size());
+        EXPECT_EQ(pos.toFen(), POSITIONS[index].toFen());
+        EXPECT_EQ(reader.record().score, static_cast<int16_t>(index));
+        ++index;
+    }
+    EXPECT_EQ(index, POSITIONS.size());
+    EXPECT_EQ(reader.skipped(), 1U);
+
+    // A sub-range starts at its first record
+    DatasetReader range(dataset, 5, 7);
+    ASSERT_TRUE(range.next(pos));
+    EXPECT_EQ(pos.toFen(), POSITIONS[5].toFen());
+    ASSERT_TRUE(range.next(pos));
+    EXPECT_FALSE(range.next(pos));
+
+    // A partial record or a wrong magic is rejected
+    dataset.close();
+    std::filesystem::resize_file(PATH, std::filesystem::file_size(PATH) - 1);
+    EXPECT_FALSE(dataset.open(PATH.string()));
+    std::filesystem::resize_file(PATH, Constants::Packed::RECORD_SIZE);
+    ASSERT_TRUE(dataset.open(PATH.string()));
+    EXPECT_EQ(dataset.size(), 0U);
+    {
+        std::fstream file(PATH, std::ios::binary | std::ios::in | std::ios::out);
+        file.write("XXXX", 4);
+    }
+    EXPECT_FALSE(dataset.open(PATH.string()));
+
+    std::filesystem::remove(PATH);
+    EXPECT_FALSE(dataset.open(PATH.string()));
+}
@@ -0,0 +1,32 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "epd.h"
+
+using namespace Chess;
+
+TEST(EpdTest, ParsesLines)
+{
+    std::string fen;
+    std::vector<Epd::Operation> operations;
+
+    ASSERT_TRUE(Epd::parse("2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - bm Qg6; "
+                           "id \"WAC.001\";",
+                           fen, operations));
+    EXPECT_EQ(fen, "2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - 0 1");
+    ASSERT_EQ(operations.size(), 2U);
+    EXPECT_EQ(Epd::find(operations, "bm"), "Qg6");
+    EXPECT_EQ(Epd::find(operations, "id"), "WAC.001");
+    EXPECT_EQ(Epd::find(operations, "am"), "");
+
+    // Counters from FEN fields or from hmvc and fmvn
+    ASSERT_TRUE(Epd::parse("8/8/8/8/8/8/8/K1k5 b - - 12 40 am Kb1 Kb2;", fen, operations));
+    EXPECT_EQ(fen, "8/8/8/8/8/8/8/K1k5 b - - 12 40");
+    EXPECT_EQ(Epd::find(operations, "am"), "Kb1 Kb2");
+    ASSERT_TRUE(Epd::parse("8/8/8/8/8/8/8/K1k5 b - - hmvc 3; fmvn 9;", fen, operations));
+    EXPECT_EQ(fen, "8/8/8/8/8/8/8/K1k5 b - - 3 9");
+
+    EXPECT_FALSE(Epd::parse("8/8/8/8/8/8/8/K1k5 b -", fen, operations));
+}
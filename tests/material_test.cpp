@@ -0,0 +1,167 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "bitboard.h"
+#include "constants.h"
+#include "endgame.h"
+#include "eval.h"
+#include "material.h"
+#include "move.h"
+#include "position.h"
+#include "search.h"
+#include "tt.h"
+#include "zobrist.h"
+
+using namespace Chess;
+using namespace Util;
+
+class MaterialTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        Bitboards::init();
+        Zobrist::init();
+    }
+
+    static auto entryFor(const std::string& fen) -> Material::Entry
+    {
+        Material::Entry entry{};
+        Material::evaluate(Position(fen), entry);
+        return entry;
+    }
+};
+
+TEST_F(MaterialTest, MaterialKeyTracksCounts)
+{
+    Position pos("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    const HashKey KEY = pos.materialKey();
+
+    // Quiet moves keep it, captures change it
+    pos.makeMove(Move(Square::C3, Square::B1));
+    EXPECT_EQ(pos.materialKey(), KEY);
+    pos.unmakeMove();
+    pos.makeMove(Move(Square::E5, Square::F7, MoveFlag::CAPTURE));
+    EXPECT_NE(pos.materialKey(), KEY);
+    pos.unmakeMove();
+    EXPECT_EQ(pos.materialKey(), KEY);
+
+    // Only the counts matter, not where the pieces stand
+    EXPECT_EQ(Position("4k3/8/8/3n4/8/8/2P5/4K3 w - - 0 1").materialKey(),
+              Position("8/2k5/6n1/8/8/5P2/8/K7 b - - 0 1").materialKey());
+    EXPECT_NE(Position("4k3/8/8/3n4/8/8/2P5/4K3 w - - 0 1").materialKey(),
+              Position("4k3/8/8/3b4/8/8/2P5/4K3 w - - 0 1").materialKey());
+
+    // A promotion trades a pawn for the new piece
+    Position promoting("3r3k/2P5/8/8/8/8/8/4K3 w - - 0 1");
+    promoting.makeMove(Move(Square::C7, Square::D8, MoveFlag::QUEEN_PROMOTION_CAPTURE));
+    EXPECT_EQ(promoting.materialKey(), Position("3Q3k/8/8/8/8/8/8/4K3 b - - 0 1").materialKey());
+
+    // More of a kind than the key has room for still loads; the surplus leaves the key alone
+    Position crowded;
+    ASSERT_NO_THROW(crowded = Position("NNNNNNNN/NNN4k/8/8/8/8/8/4K3 w - - 0 1"));
+    EXPECT_EQ(crowded.materialKey(),
+              Position("NNNNNNNN/NN5k/8/8/8/8/8/4K3 w - - 0 1").materialKey());
+}
+
+TEST_F(MaterialTest, InsufficientMaterialIsDraw)
+{
+    EXPECT_TRUE(entryFor("4k3/8/8/8/8/8/8/4K3 w - - 0 1").draw);
+    EXPECT_TRUE(entryFor("4k3/8/8/8/8/8/8/4KN2 w - - 0 1").draw);
+    EXPECT_TRUE(entryFor("4kb2/8/8/8/8/8/8/4K3 b - - 0 1").draw);
+    EXPECT_FALSE(entryFor("4k3/8/8/8/8/8/8/4KR2 w - - 0 1").draw);
+    EXPECT_FALSE(entryFor("4k3/8/8/8/8/8/4P3/4K3 w - - 0 1").draw);
+
+    // Two knights, or a minor piece each, cannot force mate but can still be mated into
+    const auto KNIGHTS = entryFor("4k3/8/8/8/8/8/8/3NKN2 w - - 0 1");
+    EXPECT_FALSE(KNIGHTS.draw);
+    EXPECT_EQ(KNIGHTS.scale[toIdx(Color::WHITE)], 0);
+    const auto MINORS = entryFor("4kb2/8/8/8/8/8/8/4KN2 w - - 0 1");
+    EXPECT_FALSE(MINORS.draw);
+    EXPECT_EQ(MINORS.scale[toIdx(Color::WHITE)], 0);
+    EXPECT_EQ(MINORS.scale[toIdx(Color::BLACK)], 0);
+    EXPECT_EQ(Eval::evaluate(Position("4kb2/8/8/8/8/8/8/4KN2 w - - 0 1")), 0);
+}
+
+TEST_F(MaterialTest, EndgameSelection)
+{
+    const auto KRK = entryFor("4k3/8/8/8/8/8/8/4KR2 w - - 0 1");
+    EXPECT_EQ(KRK.endgame, &Endgames::kxk);
+    EXPECT_EQ(KRK.strong_side, Color::WHITE);
+
+    const auto KQK = entryFor("4k3/4q3/8/8/8/8/8/4K3 w - - 0 1");
+    EXPECT_EQ(KQK.endgame, &Endgames::kxk);
+    EXPECT_EQ(KQK.strong_side, Color::BLACK);
+
+    EXPECT_EQ(entryFor("4k3/8/8/8/8/8/8/2B1KN2 w - - 0 1").endgame, &Endgames::kbnk);
+    EXPECT_EQ(entryFor("4k3/8/8/8/8/8/4P3/4K3 w - - 0 1").endgame, &Endgames::kpk);
+    EXPECT_EQ(entryFor("4k3/8/8/8/8/8/3PP3/4K3 w - - 0 1").endgame, nullptr);
+    EXPECT_EQ(entryFor("4k3/p7/8/8/8/8/8/4KR2 w - - 0 1").endgame, nullptr);
+}
+
+TEST_F(MaterialTest, MatingEndgamesDriveKingToCorner)
+{
+    // KRK: a king on the edge, close to the attacker, scores more than one in the centre
+    const int CENTRE = Eval::evaluate(Position("8/8/8/4k3/8/8/8/R3K3 w - - 0 1"));
+    const int EDGE = Eval::evaluate(Position("4k3/8/4K3/8/8/8/8/R7 w - - 0 1"));
+    EXPECT_GE(CENTRE, Constants::Eval::KNOWN_WIN);
+    EXPECT_GT(EDGE, CENTRE);
+    EXPECT_EQ(Eval::evaluate(Position("8/8/8/4k3/8/8/8/R3K3 b - - 0 1")), -CENTRE);
+
+    // KBNK: with a light-squared bishop only a8 and h1 are mating corners
+    const int RIGHT = Eval::evaluate(Position("k7/8/1K6/8/8/8/8/5BN1 w - - 0 1"));
+    const int WRONG = Eval::evaluate(Position("7k/8/6K1/8/8/8/8/5BN1 w - - 0 1"));
+    EXPECT_GE(WRONG, Constants::Eval::KNOWN_WIN);
+    EXPECT_GT(RIGHT, WRONG);
+}
+
+TEST_F(MaterialTest, KingAndPawnRules)
+{
+    constexpr int KNOWN_WIN = Constants::Eval::KNOWN_WIN;
+
+    // The black king is outside the square of the pawn, unless it moves first
+    EXPECT_GE(Eval::evaluate(Position("8/5k2/8/8/P7/8/8/7K w - - 0 1")), KNOWN_WIN);
+    EXPECT_LT(Eval::evaluate(Position("8/5k2/8/8/P7/8/8/7K b - - 0 1")), 0);
+    EXPECT_GT(Eval::evaluate(Position("8/5k2/8/8/P7/8/8/7K b - - 0 1")), -KNOWN_WIN);
+
+    // A king on a key square wins whoever is to move, and so does the mirrored position
+    EXPECT_LE(Eval::evaluate(Position("3k4/8/3K4/8/3P4/8/8/8 b - - 0 1")), -KNOWN_WIN);
+    EXPECT_LE(Eval::evaluate(Position("8/8/8/3p4/8/3k4/8/3K4 w - - 0 1")), -KNOWN_WIN);
+
+    // A rook pawn is a draw once the defending king reaches the corner
+    EXPECT_EQ(Eval::evaluate(Position("k7/8/8/P7/8/8/8/4K3 w - - 0 1")), 0);
+
+    // An undefended pawn next to the king to move is lost
+    EXPECT_EQ(Eval::evaluate(Position("8/8/8/8/3k4/4P3/8/K7 b - - 0 1")), 0);
+}
+
+TEST_F(MaterialTest, TableCachesByMaterialKey)
+{
+    Material::Table table(64);
+    Position pos("4k3/8/8/8/8/8/4P3/4K3 w - - 0 1");
+
+    EXPECT_EQ(table.probe(pos).endgame, &Endgames::kpk);
+    pos.makeMove(Move(Square::E2, Square::E4, MoveFlag::DOUBLE_PAWN_PUSH));
+    EXPECT_EQ(table.probe(pos).endgame, &Endgames::kpk);
+    EXPECT_EQ(table.probes(), 2U);
+    EXPECT_EQ(table.hits(), 1U);
+
+    // A bare-kings position is a draw on the very first probe of a fresh table
+    Material::Table fresh(64);
+    EXPECT_TRUE(fresh.probe(Position("4k3/8/8/8/8/8/8/4K3 w - - 0 1")).draw);
+}
+
+TEST_F(MaterialTest, SearchRecognisesEndgames)
+{
+    TranspositionTable table(1);
+    Search::Searcher searcher(table);
+    Search::Limits limits;
+    limits.depth = 6;
+
+    const auto DRAW = searcher.search(Position("4k3/8/8/8/8/8/8/3NK3 w - - 0 1"), limits);
+    EXPECT_FALSE(DRAW.best_move.isNone());
+    EXPECT_EQ(DRAW.score, 0);
+
+    const auto WIN = searcher.search(Position("8/8/8/4k3/8/8/8/R3K3 w - - 0 1"), limits);
+    EXPECT_GE(WIN.score, Constants::Eval::KNOWN_WIN);
+}
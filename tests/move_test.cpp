@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include "move.h"
+#include "types.h"
+
+using namespace Chess;
+
+TEST(MoveTest, Encoding)
+{
+    const Move MOVE(Square::E2, Square::E4, MoveFlag::DOUBLE_PAWN_PUSH);
+
+    EXPECT_EQ(MOVE.from(), Square::E2);
+    EXPECT_EQ(MOVE.to(), Square::E4);
+    EXPECT_EQ(MOVE.flag(), MoveFlag::DOUBLE_PAWN_PUSH);
+    EXPECT_FALSE(MOVE.isCapture());
+    EXPECT_FALSE(MOVE.isPromotion());
+    EXPECT_FALSE(MOVE.isNone());
+    EXPECT_EQ(Move::fromRaw(MOVE.raw()), MOVE);
+
+    // The default move is the null move
+    EXPECT_TRUE(Move().isNone());
+    EXPECT_EQ(sizeof(Move), 2U);
+}
+
+TEST(MoveTest, Flags)
+{
+    EXPECT_TRUE(Move(Square::D4, Square::E5, MoveFlag::CAPTURE).isCapture());
+    EXPECT_TRUE(Move(Square::D5, Square::E6, MoveFlag::EN_PASSANT).isCapture());
+    EXPECT_TRUE(Move(Square::D5, Square::E6, MoveFlag::EN_PASSANT).isEnPassant());
+    EXPECT_TRUE(Move(Square::E1, Square::G1, MoveFlag::KING_CASTLE).isCastle());
+    EXPECT_TRUE(Move(Square::E1, Square::C1, MoveFlag::QUEEN_CASTLE).isCastle());
+    EXPECT_FALSE(Move(Square::E1, Square::C1, MoveFlag::QUEEN_CASTLE).isTactical());
+
+    const Move PROMO(Square::B7, Square::A8, MoveFlag::KNIGHT_PROMOTION_CAPTURE);
+    EXPECT_TRUE(PROMO.isCapture());
+    EXPECT_TRUE(PROMO.isPromotion());
+    EXPECT_EQ(PROMO.promotionType(), PieceType::KNIGHT);
+    EXPECT_EQ(Move(Square::B7, Square::B8, MoveFlag::QUEEN_PROMOTION).promotionType(),
+              PieceType::QUEEN);
+    EXPECT_EQ(Move(Square::B7, Square::B8, MoveFlag::ROOK_PROMOTION).promotionType(),
+              PieceType::ROOK);
+    EXPECT_EQ(Move(Square::B7, Square::B8, MoveFlag::BISHOP_PROMOTION).promotionType(),
+              PieceType::BISHOP);
+}
+
+TEST(MoveTest, UciString)
+{
+    EXPECT_EQ(Move(Square::G1, Square::F3).toUci(), "g1f3");
+    EXPECT_EQ(Move(Square::A7, Square::A8, MoveFlag::QUEEN_PROMOTION).toUci(), "a7a8q");
+    EXPECT_EQ(Move(Square::H2, Square::G1, MoveFlag::KNIGHT_PROMOTION_CAPTURE).toUci(), "h2g1n");
+    EXPECT_EQ(Move().toUci(), "0000");
+}
+
+TEST(MoveTest, MoveList)
+{
+    MoveList list;
+    EXPECT_TRUE(list.empty());
+
+    list.push(Move(Square::E2, Square::E4, MoveFlag::DOUBLE_PAWN_PUSH));
+    list.push(Move(Square::G1, Square::F3));
+
+    EXPECT_EQ(list.size(), 2U);
+    EXPECT_EQ(list[1], Move(Square::G1, Square::F3));
+    EXPECT_TRUE(list.contains(Move(Square::G1, Square::F3)));
+    EXPECT_FALSE(list.contains(Move(Square::B1, Square::C3)));
+
+    list.clear();
+    EXPECT_TRUE(list.empty());
+}
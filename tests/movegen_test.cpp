@@ -0,0 +1,246 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bitboard.h"
+#include "move.h"
+#include "movegen.h"
+#include "position.h"
+#include "zobrist.h"
+
+using namespace Chess;
+using namespace MoveGen;
+using namespace Util;
+
+namespace {
+
+const std::string KIWIPETE = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+template <GenType TYPE> auto countMoves(const Position& pos) -> std::size_t
+{
+    MoveList list;
+    generate<TYPE>(pos, list);
+    return list.size();
+}
+
+} // namespace
+
+class MoveGenTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        Bitboards::init();
+        Zobrist::init();
+    }
+};
+
+TEST_F(MoveGenTest, StartingPosition)
+{
+    const Position POS;
+
+    EXPECT_EQ(countMoves<GenType::NON_EVASIONS>(POS), 20U);
+    EXPECT_EQ(countMoves<GenType::QUIETS>(POS), 20U);
+    EXPECT_EQ(countMoves<GenType::CAPTURES>(POS), 0U);
+
+    MoveList list;
+    generate<GenType::NON_EVASIONS>(POS, list);
+    EXPECT_TRUE(list.contains(Move(Square::E2, Square::E4, MoveFlag::DOUBLE_PAWN_PUSH)));
+    EXPECT_TRUE(list.contains(Move(Square::G1, Square::F3)));
+}
+
+TEST_F(MoveGenTest, CapturesAndQuietsPartitionAllMoves)
+{
+    const Position POS(KIWIPETE);
+
+    MoveList captures;
+    MoveList quiets;
+    MoveList all;
+    generate<GenType::CAPTURES>(POS, captures);
+    generate<GenType::QUIETS>(POS, quiets);
+    generate<GenType::NON_EVASIONS>(POS, all);
+
+    EXPECT_EQ(all.size(), 48U);
+    EXPECT_EQ(captures.size(), 8U);
+    EXPECT_EQ(captures.size() + quiets.size(), all.size());
+
+    for (const Move MOVE : captures) {
+        EXPECT_TRUE(MOVE.isCapture());
+        EXPECT_TRUE(all.contains(MOVE));
+    }
+    for (const Move MOVE : quiets) {
+        EXPECT_FALSE(MOVE.isCapture());
+        EXPECT_TRUE(all.contains(MOVE));
+    }
+
+    // Both castling moves are available
+    EXPECT_TRUE(quiets.contains(Move(Square::E1, Square::G1, MoveFlag::KING_CASTLE)));
+    EXPECT_TRUE(quiets.contains(Move(Square::E1, Square::C1, MoveFlag::QUEEN_CASTLE)));
+}
+
+TEST_F(MoveGenTest, Promotions)
+{
+    // b7 can push to b8 or capture on a8 / c8
+    const Position POS("r1n1k3/1P6/8/8/8/8/8/4K3 w - - 0 1");
+
+    MoveList captures;
+    MoveList quiets;
+    generate<GenType::CAPTURES>(POS, captures);
+    generate<GenType::QUIETS>(POS, quiets);
+
+    // Queen push plus four promotions on each capture square
+    EXPECT_TRUE(captures.contains(Move(Square::B7, Square::B8, MoveFlag::QUEEN_PROMOTION)));
+    EXPECT_TRUE(
+        captures.contains(Move(Square::B7, Square::A8, MoveFlag::KNIGHT_PROMOTION_CAPTURE)));
+    EXPECT_EQ(captures.size(), 9U);
+
+    // Under-promotion pushes are quiets
+    EXPECT_TRUE(quiets.contains(Move(Square::B7, Square::B8, MoveFlag::KNIGHT_PROMOTION)));
+    EXPECT_FALSE(quiets.contains(Move(Square::B7, Square::B8, MoveFlag::QUEEN_PROMOTION)));
+}
+
+TEST_F(MoveGenTest, EnPassant)
+{
+    const Position POS("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
+
+    MoveList captures;
+    generate<GenType::CAPTURES>(POS, captures);
+    EXPECT_TRUE(captures.contains(Move(Square::E5, Square::F6, MoveFlag::EN_PASSANT)));
+    EXPECT_FALSE(captures.contains(Move(Square::E5, Square::D6, MoveFlag::EN_PASSANT)));
+}
+
+TEST_F(MoveGenTest, CastlingBlockedByAttack)
+{
+    // The black bishop on a6 covers f1, so only queenside castling is possible
+    const Position POS("r3k2r/8/b7/8/8/8/8/R3K2R w KQkq - 0 1");
+
+    MoveList quiets;
+    generate<GenType::QUIETS>(POS, quiets);
+    EXPECT_FALSE(quiets.contains(Move(Square::E1, Square::G1, MoveFlag::KING_CASTLE)));
+    EXPECT_TRUE(quiets.contains(Move(Square::E1, Square::C1, MoveFlag::QUEEN_CASTLE)));
+}
+
+TEST_F(MoveGenTest, Evasions)
+{
+    // Rook check along the e-file
+    const Position POS("4r1k1/8/8/8/8/8/3B4/4K3 w - - 0 1");
+
+    MoveList evasions;
+    generate<GenType::EVASIONS>(POS, evasions);
+
+    // King: d1, f1, f2 (e2 stays on the file, d2 is own bishop); bishop interposes on e3
+    EXPECT_EQ(evasions.size(), 4U);
+    EXPECT_TRUE(evasions.contains(Move(Square::D2, Square::E3)));
+    EXPECT_FALSE(evasions.contains(Move(Square::E1, Square::E2)));
+
+    // Rook and knight double check leaves only king moves
+    const Position DOUBLE("4r1k1/8/8/8/8/5n2/8/4K3 w - - 0 1");
+    MoveList double_evasions;
+    generate<GenType::EVASIONS>(DOUBLE, double_evasions);
+    for (const Move MOVE : double_evasions) { EXPECT_EQ(MOVE.from(), Square::E1); }
+}
+
+TEST_F(MoveGenTest, LegalMoveCounts)
+{
+    // Depth-1 perft counts of the standard test positions
+    const std::vector<std::pair<std::string, std::size_t>> CASES = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 20},
+        {KIWIPETE, 48},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 14},
+        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 6},
+        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 44},
+        {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 46},
+    };
+
+    for (const auto& [fen, expected] : CASES) {
+        const Position POS(fen);
+        EXPECT_EQ(generateLegal(POS).size(), expected) << fen;
+    }
+}
+
+TEST_F(MoveGenTest, LegalPins)
+{
+    // The e2 rook is pinned by the e8 rook and may only move along the e-file
+    const Position POS("4r1k1/8/8/8/8/8/4R3/4K3 w - - 0 1");
+    const MoveList LEGAL = generateLegal(POS);
+
+    for (const Move MOVE : LEGAL) {
+        if (MOVE.from() == Square::E2) { EXPECT_EQ(getFile(MOVE.to()), 4); }
+    }
+    EXPECT_TRUE(LEGAL.contains(Move(Square::E2, Square::E8, MoveFlag::CAPTURE)));
+    EXPECT_FALSE(LEGAL.contains(Move(Square::E2, Square::D2)));
+
+    // A pinned knight has no moves at all
+    const Position KNIGHT("4r1k1/8/8/8/8/8/4N3/4K3 w - - 0 1");
+    for (const Move MOVE : generateLegal(KNIGHT)) { EXPECT_NE(MOVE.from(), Square::E2); }
+}
+
+TEST_F(MoveGenTest, LegalEnPassantDiscoveredCheck)
+{
+    // exd6 would remove both pawns from the fifth rank and expose the king to the h5 rook
+    const Position POS("8/8/8/K2pP2r/8/8/8/7k w - d6 0 1");
+    EXPECT_FALSE(generateLegal(POS).contains(Move(Square::E5, Square::D6, MoveFlag::EN_PASSANT)));
+
+    // Without the rook the capture is fine
+    const Position FREE("8/8/8/K2pP3/8/8/8/7k w - d6 0 1");
+    EXPECT_TRUE(generateLegal(FREE).contains(Move(Square::E5, Square::D6, MoveFlag::EN_PASSANT)));
+}
+
+TEST_F(MoveGenTest, LegalIsSubsetOfPseudoLegal)
+{
+    const Position POS(KIWIPETE);
+
+    MoveList pseudo;
+    generatePseudoLegal(POS, pseudo);
+    const MoveList LEGAL = generateLegal(POS);
+
+    EXPECT_LE(LEGAL.size(), pseudo.size());
+    for (const Move MOVE : LEGAL) { EXPECT_TRUE(pseudo.contains(MOVE)); }
+}
+
+TEST_F(MoveGenTest, PseudoLegalityMatchesGenerator)
+{
+    // Moves collected from unrelated positions are mostly nonsense here and must be rejected
+    const std::vector<std::string> FENS = {
+        KIWIPETE,
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+        "4k3/8/8/8/1b6/8/3P4/4K3 w - - 0 1",
+        "4k3/4r3/8/8/8/8/3N4/4K3 w - - 0 1",
+        "8/8/8/8/k2Pp2Q/8/8/3K4 b - d3 0 1",
+    };
+
+    std::vector<Position> positions;
+    MoveList candidates;
+    for (const auto& fen : FENS) {
+        Position root(fen);
+        positions.push_back(root);
+        for (const Move MOVE : generateLegal(root)) {
+            root.makeMove(MOVE);
+            positions.push_back(root);
+            root.unmakeMove();
+        }
+    }
+
+    for (const Position& pos : positions) {
+        MoveList pseudo;
+        generatePseudoLegal(pos, pseudo);
+        for (const Move MOVE : pseudo) {
+            EXPECT_TRUE(isPseudoLegal(pos, MOVE)) << pos.toFen() << ' ' << MOVE.toUci();
+        }
+
+        const MoveList LEGAL = generateLegal(pos);
+        for (const Position& other : positions) {
+            MoveList foreign;
+            generatePseudoLegal(other, foreign);
+            for (const Move MOVE : foreign) {
+                const bool ACCEPTED = isPseudoLegal(pos, MOVE) && isLegal(pos, MOVE);
+                ASSERT_EQ(ACCEPTED, LEGAL.contains(MOVE)) << pos.toFen() << ' ' << MOVE.toUci();
+            }
+        }
+    }
+}
@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bitboard.h"
+#include "move.h"
+#include "movegen.h"
+#include "movepick.h"
+#include "position.h"
+#include "zobrist.h"
+
+using namespace Chess;
+using namespace Search;
+
+namespace {
+
+auto drain(MovePicker& picker) -> std::vector<Move>
+{
+    std::vector<Move> moves;
+    for (Move move = picker.next(); !move.isNone(); move = picker.next()) { moves.push_back(move); }
+    return moves;
+}
+
+// Every legal move exactly once, whatever hints the picker is given
+auto expectSameMoves(const std::vector<Move>& picked, const MoveList& expected,
+                     const std::string& context) -> void
+{
+    EXPECT_EQ(picked.size(), expected.size()) << context;
+    for (const Move MOVE : expected) {
+        EXPECT_EQ(std::count(picked.begin(), picked.end(), MOVE), 1) << context << MOVE.toUci();
+    }
+}
+
+} // namespace
+
+class MovePickerTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        Bitboards::init();
+        Zobrist::init();
+    }
+
+    HistoryTable history{};
+};
+
+TEST_F(MovePickerTest, YieldsEveryLegalMoveOnce)
+{
+    const std::vector<std::string> FENS = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    };
+
+    for (const auto& fen : FENS) {
+        Position root(fen);
+        const MoveList ROOT_MOVES = MoveGen::generateLegal(root);
+
+        // Hints are drawn from the parent, so many of them are invalid in the child
+        for (std::size_t i = 0; i < ROOT_MOVES.size(); ++i) {
+            root.makeMove(ROOT_MOVES[i]);
+            const MoveList LEGAL = MoveGen::generateLegal(root);
+            const Move TT_MOVE = LEGAL.empty() ? Move() : LEGAL[i % LEGAL.size()];
+            const Killers KILLERS = {ROOT_MOVES[(i + 1) % ROOT_MOVES.size()],
+                                     LEGAL.empty() ? Move() : LEGAL[(i * 7) % LEGAL.size()]};
+            const Move COUNTER = ROOT_MOVES[(i * 3) % ROOT_MOVES.size()];
+
+            MovePicker picker(root, TT_MOVE, KILLERS, COUNTER, history);
+            const std::vector<Move> PICKED = drain(picker);
+            expectSameMoves(PICKED, LEGAL, root.toFen() + ' ');
+            if (!TT_MOVE.isNone()) { EXPECT_EQ(PICKED.front(), TT_MOVE); }
+
+            root.unmakeMove();
+        }
+    }
+}
+
+TEST_F(MovePickerTest, QuiescenceYieldsTacticalMovesOrEvasions)
+{
+    const Position QUIET("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    MovePicker captures(QUIET, Move(), history);
+    const std::vector<Move> PICKED = drain(captures);
+
+    MoveList tactical;
+    for (const Move MOVE : MoveGen::generateLegal(QUIET)) {
+        if (MOVE.isCapture() || MOVE.flag() == MoveFlag::QUEEN_PROMOTION) { tactical.push(MOVE); }
+    }
+    expectSameMoves(PICKED, tactical, "captures ");
+
+    const Position CHECKED("4k3/8/8/8/1b6/8/8/1N2K3 w - - 0 1");
+    MovePicker evasions(CHECKED, Move(), history);
+    expectSameMoves(drain(evasions), MoveGen::generateLegal(CHECKED), "evasions ");
+}
+
+TEST_F(MovePickerTest, StageOrder)
+{
+    // Qxd4 wins a queen, Nxf4 trades evenly, Qxb7 gives up the queen for a defended pawn
+    const Position POS("2b1k3/1p6/8/8/3q1n2/3N4/1Q6/4K3 w - - 0 1");
+    const Move TT_MOVE(Square::E1, Square::F1);
+    const Killers KILLERS = {Move(Square::B2, Square::A3), Move()};
+    const Move COUNTER(Square::E1, Square::D1);
+
+    history[0][Util::toIdx(Square::E1)][Util::toIdx(Square::D2)] = 500;
+
+    MovePicker picker(POS, TT_MOVE, KILLERS, COUNTER, history);
+    const std::vector<Move> PICKED = drain(picker);
+    ASSERT_GE(PICKED.size(), 6U);
+
+    EXPECT_EQ(PICKED[0], TT_MOVE);
+    EXPECT_EQ(PICKED[1].toUci(), "b2d4");
+    EXPECT_EQ(PICKED[2].toUci(), "d3f4");
+    EXPECT_EQ(PICKED[3], KILLERS[0]);
+    EXPECT_EQ(PICKED[4], COUNTER);
+    EXPECT_EQ(PICKED[5].toUci(), "e1d2");
+    EXPECT_EQ(PICKED.back().toUci(), "b2b7");
+}
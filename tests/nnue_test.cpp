@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bitboard.h"
+#include "constants.h"
+#include "move.h"
+#include "movegen.h"
+#include "nnue.h"
+#include "position.h"
+#include "search.h"
+#include "tt.h"
+#include "zobrist.h"
+
+using namespace Chess;
+
+namespace {
+
+constexpr uint64_t SEED = 0x5EEDULL;
+
+const std::vector<std::string> FENS = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+};
+
+// Same position with colours swapped and the board flipped vertically
+auto mirrorFen(const std::string& fen) -> std::string
+{
+    std::istringstream iss(fen);
+    std::string placement;
+    std::string side;
+    std::string castling;
+    std::string en_passant;
+    iss >> placement >> side >> castling >> en_passant;
+
+    std::vector<std::string> ranks;
+    std::istringstream rank_stream(placement);
+    for (std::string rank; std::getline(rank_stream, rank, '/');) { ranks.push_back(rank); }
+    std::reverse(ranks.begin(), ranks.end());
+
+    const auto SWAP_CASE = [](std::string text) {
+        for (char& chr : text) {
+            chr = static_cast<char>(std::isupper(static_cast<unsigned char>(chr))
+                                        ? std::tolower(static_cast<unsigned char>(chr))
+                                        : std::toupper(static_cast<unsigned char>(chr)));
+        }
+        return text;
+    };
+
+    std::string mirrored;
+    for (const auto& rank : ranks) { mirrored += (mirrored.empty() ? "" : "/") + SWAP_CASE(rank); }
+    mirrored += side == "w" ? " b " : " w ";
+    mirrored += castling == "-" ? "-" : SWAP_CASE(castling);
+    if (en_passant == "-") { mirrored += " -"; }
+    else {
+        mirrored += ' ';
+        mirrored += en_passant[0];
+        mirrored += static_cast<char>('1' + '8' - en_passant[1]);
+    }
+    return mirrored + " 0 1";
+}
+
+} // namespace
+
+class NnueTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite()
+    {
+        Bitboards::init();
+        Zobrist::init();
+        network = std::make_unique<NNUE::Network>();
+        NNUE::randomize(*network, SEED);
+    }
+
+    static void TearDownTestSuite() { network.reset(); }
+
+    // Walks the tree comparing the lazily updated stack against a from-scratch evaluation.
+    // Nodes one ply above the leaves are skipped so the leaves catch up over two moves.
+    static auto checkTree(Position& pos, NNUE::AccumulatorStack& stack, int depth) -> void
+    {
+        if (depth != 1) {
+            ASSERT_EQ(NNUE::evaluate(*network, pos, stack), NNUE::evaluate(*network, pos))
+                << pos.toFen();
+        }
+        if (depth == 0) { return; }
+
+        for (const Move MOVE : MoveGen::generateLegal(pos)) {
+            stack.push(pos, MOVE);
+            pos.makeMove(MOVE);
+            checkTree(pos, stack, depth - 1);
+            pos.unmakeMove();
+            stack.pop();
+        }
+    }
+
+    static inline std::unique_ptr<NNUE::Network> network;
+};
+
+TEST_F(NnueTest, IncrementalMatchesRefresh)
+{
+    // Castling, promotions with and without capture, en passant and king moves all occur
+    auto stack = std::make_unique<NNUE::AccumulatorStack>();
+    for (const auto& fen : FENS) {
+        Position pos(fen);
+        stack->reset();
+        checkTree(pos, *stack, 3);
+    }
+}
+
+TEST_F(NnueTest, NullMoveKeepsAccumulator)
+{
+    auto stack = std::make_unique<NNUE::AccumulatorStack>();
+    Position pos(FENS[1]);
+    stack->reset();
+    const int BEFORE = NNUE::evaluate(*network, pos, *stack);
+
+    stack->pushNull();
+    pos.makeNullMove();
+    EXPECT_EQ(NNUE::evaluate(*network, pos, *stack), NNUE::evaluate(*network, pos));
+    pos.unmakeNullMove();
+    stack->pop();
+
+    EXPECT_EQ(NNUE::evaluate(*network, pos, *stack), BEFORE);
+}
+
+TEST_F(NnueTest, MirroredPositionsEvaluateAlike)
+{
+    for (const auto& fen : FENS) {
+        EXPECT_EQ(NNUE::evaluate(*network, Position(fen)),
+                  NNUE::evaluate(*network, Position(mirrorFen(fen))))
+            << fen;
+    }
+}
+
+TEST_F(NnueTest, SaveLoadRoundTrip)
+{
+    const auto PATH = std::filesystem::temp_directory_path() / "duchess_nnue_test.bin";
+    ASSERT_TRUE(NNUE::save(PATH.string(), *network));
+
+    auto loaded = std::make_unique<NNUE::Network>();
+    ASSERT_TRUE(NNUE::load(PATH.string(), *loaded));
+    for (const auto& fen : FENS) {
+        const Position POS(fen);
+        EXPECT_EQ(NNUE::evaluate(*loaded, POS), NNUE::evaluate(*network, POS)) << fen;
+    }
+
+    // A file of the right size but the wrong magic is rejected
+    {
+        std::fstream file(PATH, std::ios::binary | std::ios::in | std::ios::out);
+        file.write("XXXX", 4);
+    }
+    EXPECT_FALSE(NNUE::load(PATH.string(), *loaded));
+
+    // So is a truncated one
+    std::filesystem::resize_file(PATH, std::filesystem::file_size(PATH) / 2);
+    EXPECT_FALSE(NNUE::load(PATH.string(), *loaded));
+
+    std::filesystem::remove(PATH);
+    EXPECT_FALSE(NNUE::load(PATH.string(), *loaded));
+}
+
+TEST_F(NnueTest, SearchWithNetwork)
+{
+    TranspositionTable table(1);
+    Search::Searcher searcher(table);
+    searcher.setNetwork(network.get());
+
+    Search::Limits limits;
+    limits.depth = 4;
+    const auto MATE = searcher.search(Position("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1"), limits);
+    EXPECT_EQ(MATE.best_move.toUci(), "a1a8");
+    EXPECT_EQ(MATE.score, Constants::Search::MATE_SCORE - 1);
+
+    // Whatever the random network thinks, scores stay out of the mate range
+    const auto RESULT =
+        searcher.search(Position("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"), limits);
+    EXPECT_FALSE(RESULT.best_move.isNone());
+    EXPECT_FALSE(Constants::Search::isMateScore(RESULT.score));
+}
@@ -0,0 +1,108 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "bitboard.h"
+#include "eval.h"
+#include "material.h"
+#include "move.h"
+#include "pawns.h"
+#include "position.h"
+#include "zobrist.h"
+
+using namespace Chess;
+using namespace Util;
+
+class PawnsTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        Bitboards::init();
+        Zobrist::init();
+    }
+};
+
+TEST_F(PawnsTest, PawnKeyIgnoresOtherPieces)
+{
+    Position pos("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    const HashKey KEY = pos.pawnKey();
+
+    // A knight move changes the full hash but not the pawn key
+    pos.makeMove(Move(Square::C3, Square::B1));
+    EXPECT_EQ(pos.pawnKey(), KEY);
+    pos.unmakeMove();
+
+    // Pawn pushes and king moves do change it
+    pos.makeMove(Move(Square::A2, Square::A3));
+    EXPECT_NE(pos.pawnKey(), KEY);
+    pos.unmakeMove();
+    pos.makeMove(Move(Square::E1, Square::D1));
+    EXPECT_NE(pos.pawnKey(), KEY);
+    pos.unmakeMove();
+
+    EXPECT_EQ(pos.pawnKey(), KEY);
+}
+
+TEST_F(PawnsTest, PassedPawns)
+{
+    // a5 and f3 are passed; the d4 and c5 pawns guard each other's path, and the h-pawns
+    // block each other
+    const Position POS("4k3/7p/7P/P1p5/3P4/5p2/8/4K3 w - - 0 1");
+    Pawns::Entry entry{};
+    Pawns::evaluate(POS, entry);
+
+    EXPECT_EQ(entry.key, POS.pawnKey());
+    EXPECT_EQ(entry.passed[toIdx(Color::WHITE)], squareBB(Square::A5));
+    EXPECT_EQ(entry.passed[toIdx(Color::BLACK)], squareBB(Square::F3));
+}
+
+TEST_F(PawnsTest, DoubledAndIsolatedPawns)
+{
+    // Identical kings and a pawn each side on the same files, except White's c-pawns are
+    // doubled and isolated; both are worse than a healthy pair
+    const Position HEALTHY("4k3/1pp5/8/8/8/8/1PP5/4K3 w - - 0 1");
+    const Position DOUBLED("4k3/1pp5/8/8/8/2P5/2P5/4K3 w - - 0 1");
+    Pawns::Entry healthy{};
+    Pawns::Entry doubled{};
+    Pawns::evaluate(HEALTHY, healthy);
+    Pawns::evaluate(DOUBLED, doubled);
+
+    EXPECT_EQ(healthy.score, (PSQT::Score{0, 0}));
+    EXPECT_LT(doubled.score.mg, 0);
+    EXPECT_LT(doubled.score.eg, 0);
+}
+
+TEST_F(PawnsTest, MirroredStructureNegatesScore)
+{
+    const Position POS("r4rk1/1pp2ppp/p1np1n2/4p3/4P3/P1NP1N1P/1PP2PP1/R4RK1 w - - 0 10");
+    const Position MIRRORED("r4rk1/1pp2pp1/p1np1n1p/4p3/4P3/P1NP1N2/1PP2PPP/R4RK1 b - - 0 10");
+    Pawns::Entry entry{};
+    Pawns::Entry mirrored{};
+    Pawns::evaluate(POS, entry);
+    Pawns::evaluate(MIRRORED, mirrored);
+
+    EXPECT_EQ(entry.score, -mirrored.score);
+    EXPECT_EQ(Eval::evaluate(POS), Eval::evaluate(MIRRORED));
+}
+
+TEST_F(PawnsTest, TableCachesByPawnKey)
+{
+    Pawns::Table table(64);
+    Material::Table material(64);
+    Position pos("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    const int UNCACHED = Eval::evaluate(pos);
+
+    EXPECT_EQ(Eval::evaluate(pos, table, material), UNCACHED);
+    EXPECT_EQ(table.hits(), 0U);
+
+    // Piece moves keep the pawn key, so the entry is reused
+    pos.makeMove(Move(Square::C3, Square::B1));
+    EXPECT_EQ(Eval::evaluate(pos, table, material), Eval::evaluate(pos));
+    pos.unmakeMove();
+    EXPECT_EQ(Eval::evaluate(pos, table, material), UNCACHED);
+    EXPECT_EQ(table.probes(), 3U);
+    EXPECT_EQ(table.hits(), 2U);
+
+    table.clear();
+    EXPECT_EQ(table.probes(), 0U);
+}
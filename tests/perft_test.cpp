@@ -0,0 +1,67 @@
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bitboard.h"
+#include "perft.h"
+#include "position.h"
+#include "zobrist.h"
+
+using namespace Chess;
+
+class PerftTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        Bitboards::init();
+        Zobrist::init();
+    }
+};
+
+TEST_F(PerftTest, KnownCounts)
+{
+    const std::vector<std::tuple<std::string, int, std::uint64_t>> CASES = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 4, 197281},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624},
+        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333},
+        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379},
+    };
+
+    for (const auto& [fen, depth, expected] : CASES) {
+        Position pos(fen);
+        EXPECT_EQ(Perft::count(pos, depth), expected) << fen;
+        EXPECT_EQ(pos.toFen(), fen);
+    }
+}
+
+TEST_F(PerftTest, CachedCountsMatchUncached)
+{
+    Perft::Table table(1);
+    const std::string FEN = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    Position pos(FEN);
+
+    EXPECT_EQ(Perft::count(pos, 1, &table), 48);
+    EXPECT_EQ(Perft::count(pos, 2, &table), 2039);
+    EXPECT_EQ(Perft::count(pos, 3, &table), 97862);
+
+    // A second pass is served from the cache and must agree
+    EXPECT_EQ(Perft::count(pos, 3, &table), 97862);
+    EXPECT_EQ(pos.toFen(), FEN);
+}
+
+TEST_F(PerftTest, TableSeparatesDepths)
+{
+    Perft::Table table(1);
+    const HashKey KEY = 0x0123456789ABCDEFULL;
+    std::uint64_t nodes = 0;
+
+    EXPECT_FALSE(table.probe(KEY, 3, nodes));
+    table.store(KEY, 3, 8902);
+    ASSERT_TRUE(table.probe(KEY, 3, nodes));
+    EXPECT_EQ(nodes, 8902);
+    EXPECT_FALSE(table.probe(KEY, 4, nodes));
+    EXPECT_FALSE(table.probe(KEY ^ 1, 3, nodes));
+}
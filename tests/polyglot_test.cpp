@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bitboard.h"
+#include "move.h"
+#include "movegen.h"
+#include "polyglot.h"
+#include "position.h"
+#include "zobrist.h"
+
+using namespace Chess;
+using namespace Util;
+
+namespace {
+
+struct Record {
+    HashKey key;
+    uint16_t move;
+    uint16_t weight;
+};
+
+// Polyglot move field: to | from << 6 | promotion << 12
+constexpr auto encode(Square from, Square to) -> uint16_t
+{
+    return static_cast<uint16_t>(toIdx(to) | (toIdx(from) << 6));
+}
+
+auto playUci(Position& pos, const std::string& uci) -> void
+{
+    for (const Move MOVE : MoveGen::generateLegal(pos)) {
+        if (MOVE.toUci() == uci) {
+            pos.makeMove(MOVE);
+            return;
+        }
+    }
+    FAIL() << "illegal move " << uci;
+}
+
+auto writeBook(const std::filesystem::path& path, std::vector<Record> records) -> void
+{
+    std::sort(records.begin(), records.end(),
+              [](const Record& lhs, const Record& rhs) { return lhs.key < rhs.key; });
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    for (const Record& record : records) {
+        std::array<unsigned char, 16> bytes{};
+        for (std::size_t i = 0; i < 8; ++i) {
+            bytes[i] = static_cast<unsigned char>(record.key >> (56 - (8 * i)));
+        }
+        bytes[8] = static_cast<unsigned char>(record.move >> 8);
+        bytes[9] = static_cast<unsigned char>(record.move);
+        bytes[10] = static_cast<unsigned char>(record.weight >> 8);
+        bytes[11] = static_cast<unsigned char>(record.weight);
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+}
+
+} // namespace
+
+class PolyglotTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        Bitboards::init();
+        Zobrist::init();
+    }
+};
+
+// Reference keys from the Polyglot book format description
+TEST_F(PolyglotTest, KeysMatchReference)
+{
+    Position pos;
+    EXPECT_EQ(Polyglot::key(pos), 0x463B96181691FC9CULL);
+
+    const std::vector<std::pair<std::string, HashKey>> LINE = {
+        {"e2e4", 0x823C9B50FD114196ULL}, {"d7d5", 0x0756B94461C50FB0ULL},
+        {"e4e5", 0x662FAFB965DB29D4ULL}, {"f7f5", 0x22A48B5A8E47FF78ULL},
+        {"e1e2", 0x652A607CA3F242C1ULL}, {"e8f7", 0x00FDD303C946BDD9ULL}};
+    for (const auto& [MOVE, KEY] : LINE) {
+        playUci(pos, MOVE);
+        EXPECT_EQ(Polyglot::key(pos), KEY) << "after " << MOVE;
+    }
+
+    Position other;
+    for (const std::string MOVE : {"a2a4", "b7b5", "h2h4", "b5b4", "c2c4"}) {
+        playUci(other, MOVE);
+    }
+    EXPECT_EQ(Polyglot::key(other), 0x3C8123EA7B067637ULL);
+    playUci(other, "b4c3");
+    playUci(other, "a1a3");
+    EXPECT_EQ(Polyglot::key(other), 0x5C3F9B829B279560ULL);
+}
+
+TEST_F(PolyglotTest, BookProbe)
+{
+    const auto PATH = std::filesystem::temp_directory_path() / "duchess_polyglot_test.bin";
+    const Position START;
+    const Position CASTLING("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+    const HashKey START_KEY = Polyglot::key(START);
+
+    writeBook(PATH, {{START_KEY, encode(Square::E2, Square::E4), 3},
+                     {START_KEY, encode(Square::D2, Square::D4), 1},
+                     // Not legal in the start position: skipped
+                     {START_KEY, encode(Square::E2, Square::E5), 100},
+                     {START_KEY - 1, encode(Square::A2, Square::A3), 1},
+                     {START_KEY + 1, encode(Square::H2, Square::H3), 1},
+                     // Castling is the king taking its own rook
+                     {Polyglot::key(CASTLING), encode(Square::E1, Square::H1), 1}});
+
+    Polyglot::Book book;
+    EXPECT_FALSE(book.isOpen());
+    EXPECT_TRUE(book.pick(START, 0).isNone());
+    ASSERT_TRUE(book.open(PATH.string()));
+    EXPECT_EQ(book.size(), 6U);
+
+    std::vector<Polyglot::BookMove> moves;
+    book.probe(START, moves);
+    ASSERT_EQ(moves.size(), 2U);
+    EXPECT_EQ(moves[0].move.toUci(), "e2e4");
+    EXPECT_EQ(moves[0].weight, 3);
+    EXPECT_EQ(moves[1].move.toUci(), "d2d4");
+
+    // Weights 3 and 1 split the random range three to one
+    EXPECT_EQ(book.pick(START, 0).toUci(), "e2e4");
+    EXPECT_EQ(book.pick(START, 2).toUci(), "e2e4");
+    EXPECT_EQ(book.pick(START, 3).toUci(), "d2d4");
+
+    const Move CASTLE = book.pick(CASTLING, 0);
+    EXPECT_TRUE(CASTLE.isCastle());
+    EXPECT_EQ(CASTLE.to(), Square::G1);
+
+    EXPECT_TRUE(book.pick(Position("4k3/8/8/8/8/8/8/4K3 w - - 0 1"), 0).isNone());
+
+    // A partial record is rejected
+    book.close();
+    std::filesystem::resize_file(PATH, std::filesystem::file_size(PATH) - 1);
+    EXPECT_FALSE(book.open(PATH.string()));
+    std::filesystem::remove(PATH);
+}
@@ -1,16 +1,30 @@
+#include <array>
+#include <string>
+#include <tuple>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
+#include "bitboard.h"
 #include "compiler_macros.h"
+#include "constants.h"
+#include "move.h"
+#include "movegen.h"
 #include "position.h"
 #include "zobrist.h"
 
 using namespace Chess;
+using namespace Util;
 
 class PositionTest : public ::testing::Test {
 protected:
-    void SetUp() override { Zobrist::init(); }
+    void SetUp() override
+    {
+        Bitboards::init();
+        Zobrist::init();
+    }
 };
 
 TEST_F(PositionTest, FenConversion)
@@ -29,6 +43,39 @@ TEST_F(PositionTest, FenConversion)
     }
 }
 
+TEST_F(PositionTest, FenWritersAgree)
+{
+    const std::vector<std::string> FENS = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+        "8/8/4k3/8/2p5/8/B2P4/4K3 b - - 99 1234567",
+        "1k6/8/8/8/8/8/8/K6R w K - 0 1",
+    };
+
+    std::array<char, Constants::Game::MAX_FEN_LENGTH> buffer{};
+    std::string out;
+    for (const auto& fen : FENS) {
+        const Position POS(fen);
+        EXPECT_EQ(POS.toFen(buffer.data(), buffer.size()), fen.size());
+        EXPECT_EQ(std::string(buffer.data()), fen);
+        POS.toFen(out);
+        EXPECT_EQ(out, fen);
+    }
+
+    // Too small for the text and its terminator
+    const Position START;
+    const std::string START_FEN = START.toFen();
+    EXPECT_EQ(START.toFen(buffer.data(), START_FEN.size()), 0U);
+    EXPECT_EQ(START.toFen(buffer.data(), START_FEN.size() + 1), START_FEN.size());
+
+    // The string keeps its storage
+    out.reserve(Constants::Game::MAX_FEN_LENGTH);
+    const char* const DATA = out.data();
+    START.toFen(out);
+    EXPECT_EQ(out, START_FEN);
+    EXPECT_EQ(out.data(), DATA);
+}
+
 TEST_F(PositionTest, HashUniqueness)
 {
     std::unordered_set<HashKey> hashes;
@@ -124,4 +171,321 @@ TEST_F(PositionTest, DefaultPosition)
 
     // Check hash is non-zero
     EXPECT_NE(0ULL, pos.hash());
-};
\ No newline at end of file
+};
+namespace {
+
+// Plain recursive perft over legal moves; exercises make/unmake at every node
+auto perft(Position& pos, int depth) -> std::uint64_t
+{
+    if (depth == 0) { return 1; }
+
+    std::uint64_t nodes = 0;
+    for (const Move MOVE : MoveGen::generateLegal(pos)) {
+        pos.makeMove(MOVE);
+        nodes += perft(pos, depth - 1);
+        pos.unmakeMove();
+    }
+    return nodes;
+}
+
+} // namespace
+
+TEST_F(PositionTest, MakeUnmakeRestoresPosition)
+{
+    const std::string FEN = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    Position pos(FEN);
+    const Position ORIGINAL(FEN);
+
+    for (const Move MOVE : MoveGen::generateLegal(pos)) {
+        pos.makeMove(MOVE);
+        EXPECT_EQ(pos.lastMove(), MOVE);
+        // The incremental hash must equal a from-scratch hash of the resulting position
+        EXPECT_EQ(pos.hash(), Position(pos.toFen()).hash()) << MOVE.toUci();
+        EXPECT_EQ(pos.pawnKey(), Position(pos.toFen()).pawnKey()) << MOVE.toUci();
+        pos.unmakeMove();
+
+        EXPECT_EQ(pos, ORIGINAL) << MOVE.toUci();
+        EXPECT_EQ(pos.toFen(), FEN) << MOVE.toUci();
+    }
+}
+
+TEST_F(PositionTest, IncrementalEvaluationTerms)
+{
+    // The starting position is symmetric, so White's sums cancel out exactly
+    const Position START;
+    EXPECT_EQ(START.psqt().mg, 0);
+    EXPECT_EQ(START.psqt().eg, 0);
+    EXPECT_EQ(START.phase(), Constants::Eval::MAX_PHASE);
+
+    // Castling, en passant, captures and promotions all touch the sums; two plies deep each
+    // must match a position built from scratch, and unmake must restore the parent's terms
+    const std::vector<std::string> FENS = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    };
+
+    for (const auto& fen : FENS) {
+        Position pos(fen);
+        for (const Move FIRST : MoveGen::generateLegal(pos)) {
+            pos.makeMove(FIRST);
+            for (const Move SECOND : MoveGen::generateLegal(pos)) {
+                pos.makeMove(SECOND);
+                const Position FRESH(pos.toFen());
+                EXPECT_EQ(pos.psqt(), FRESH.psqt()) << FIRST.toUci() << ' ' << SECOND.toUci();
+                EXPECT_EQ(pos.phase(), FRESH.phase()) << FIRST.toUci() << ' ' << SECOND.toUci();
+                pos.unmakeMove();
+            }
+            pos.unmakeMove();
+            EXPECT_EQ(pos.psqt(), Position(fen).psqt()) << FIRST.toUci();
+        }
+    }
+}
+
+TEST_F(PositionTest, MakeMoveUpdatesState)
+{
+    Position pos;
+
+    pos.makeMove(Move(Square::E2, Square::E4, MoveFlag::DOUBLE_PAWN_PUSH));
+    // No black pawn can capture on e3, so no en passant square is recorded
+    EXPECT_EQ(pos.toFen(), "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
+
+    pos.makeMove(Move(Square::G8, Square::F6));
+    pos.makeMove(Move(Square::E4, Square::E5));
+    pos.makeMove(Move(Square::D7, Square::D5, MoveFlag::DOUBLE_PAWN_PUSH));
+    EXPECT_EQ(pos.getEnPassantSquare(), Square::D6);
+    EXPECT_EQ(pos.getFullmoveNumber(), 3);
+
+    pos.makeMove(Move(Square::E5, Square::D6, MoveFlag::EN_PASSANT));
+    EXPECT_EQ(pos.toFen(), "rnbqkb1r/ppp1pppp/3P1n2/8/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 3");
+
+    pos.makeMove(Move(Square::H8, Square::G8));
+    EXPECT_FALSE(pos.hasCastlingRight(CastlingRight::BLACK_KINGSIDE));
+    EXPECT_TRUE(pos.hasCastlingRight(CastlingRight::BLACK_QUEENSIDE));
+    EXPECT_EQ(pos.getHalfmoveClock(), 1);
+
+    // Unwinding returns to the start position exactly
+    for (int i = 0; i < 6; ++i) { pos.unmakeMove(); }
+    EXPECT_EQ(pos, Position());
+    EXPECT_EQ(pos.toFen(), Position().toFen());
+}
+
+TEST_F(PositionTest, CastlingAndPromotion)
+{
+    Position pos("r3k2r/1P6/8/8/8/8/8/R3K2R w KQkq - 0 1");
+
+    pos.makeMove(Move(Square::E1, Square::G1, MoveFlag::KING_CASTLE));
+    EXPECT_EQ(pos.pieceAt(Square::G1), Piece::WHITE_KING);
+    EXPECT_EQ(pos.pieceAt(Square::F1), Piece::WHITE_ROOK);
+    EXPECT_EQ(pos.getCastlingRights(), toIdx(CastlingRight::BLACK_KINGSIDE) |
+                                           toIdx(CastlingRight::BLACK_QUEENSIDE));
+
+    pos.makeMove(Move(Square::E8, Square::G8, MoveFlag::KING_CASTLE));
+    EXPECT_EQ(pos.pieceAt(Square::F8), Piece::BLACK_ROOK);
+
+    pos.makeMove(Move(Square::B7, Square::A8, MoveFlag::QUEEN_PROMOTION_CAPTURE));
+    EXPECT_EQ(pos.toFen(), "Q4rk1/8/8/8/8/8/8/R4RK1 b - - 0 2");
+    EXPECT_EQ(pos.pieceAt(Square::A8), Piece::WHITE_QUEEN);
+    EXPECT_EQ(pos.getPieceBitboard(PieceType::PAWN, Color::WHITE), 0ULL);
+
+    pos.unmakeMove();
+    pos.unmakeMove();
+    pos.unmakeMove();
+    EXPECT_EQ(pos.toFen(), "r3k2r/1P6/8/8/8/8/8/R3K2R w KQkq - 0 1");
+}
+
+TEST_F(PositionTest, NullMove)
+{
+    const std::string FEN = "rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 3";
+    Position pos(FEN);
+
+    pos.makeNullMove();
+    EXPECT_EQ(pos.getSideToMove(), Color::WHITE);
+    EXPECT_EQ(pos.getEnPassantSquare(), Square::NONE);
+    EXPECT_EQ(pos.hash(), Position(pos.toFen()).hash());
+
+    pos.unmakeNullMove();
+    EXPECT_EQ(pos, Position(FEN));
+    EXPECT_EQ(pos.toFen(), FEN);
+}
+
+TEST_F(PositionTest, Checkers)
+{
+    EXPECT_FALSE(Position().inCheck());
+
+    const Position DOUBLE_CHECK("4k3/8/5N2/8/8/8/8/4R1K1 b - - 0 1");
+    EXPECT_TRUE(DOUBLE_CHECK.inCheck());
+    EXPECT_EQ(DOUBLE_CHECK.checkers(), squareBB(Square::F6) | squareBB(Square::E1));
+
+    EXPECT_TRUE(Position("4k3/3P4/8/8/8/8/8/4K3 b - - 0 1").inCheck());
+    EXPECT_FALSE(Position("4k3/4P3/8/8/8/8/8/4K3 b - - 0 1").inCheck());
+}
+
+TEST_F(PositionTest, AttackersTo)
+{
+    const Position POS("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    // The d5 pawn is hit by the e6 pawn and both black knights, and defended by the e4 pawn and
+    // the c3 knight
+    const Bitboard ATTACKERS = POS.attackersTo(Square::D5, POS.occupied());
+    EXPECT_EQ(ATTACKERS, squareBB(Square::E6) | squareBB(Square::F6) | squareBB(Square::B6) |
+                             squareBB(Square::E4) | squareBB(Square::C3));
+
+    // Both colors are included: g2 and the f3 queen hit h3, the h8 rook defends it
+    EXPECT_EQ(POS.attackersTo(Square::H3, POS.occupied()),
+              squareBB(Square::G2) | squareBB(Square::F3) | squareBB(Square::H8));
+}
+
+TEST_F(PositionTest, StaticExchangeEvaluation)
+{
+    // Rook takes an undefended pawn: +100
+    const Position FREE_PAWN("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1");
+    const Move RXE5(Square::E1, Square::E5, MoveFlag::CAPTURE);
+    EXPECT_TRUE(FREE_PAWN.see(RXE5, 100));
+    EXPECT_FALSE(FREE_PAWN.see(RXE5, 101));
+
+    // Knight takes a pawn defended by a pawn, then the x-rayed rooks and queen join: -220
+    const Position XRAY("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1");
+    const Move NXE5(Square::D3, Square::E5, MoveFlag::CAPTURE);
+    EXPECT_FALSE(XRAY.see(NXE5, 0));
+    EXPECT_TRUE(XRAY.see(NXE5, -220));
+    EXPECT_FALSE(XRAY.see(NXE5, -219));
+
+    // A quiet move onto a square attacked by a pawn loses the piece
+    const Position HANGING("4k3/8/3p4/8/8/3N4/8/4K3 w - - 0 1");
+    EXPECT_FALSE(HANGING.see(Move(Square::D3, Square::E5)));
+    EXPECT_TRUE(HANGING.see(Move(Square::D3, Square::F4)));
+
+    // Doubled rooks on both sides: the rooks behind join as x-rays and the pawn costs a rook
+    const Position BATTERY("4k3/3r4/3r4/3p4/8/8/3R4/3RK3 w - - 0 1");
+    const Move RXD5(Square::D2, Square::D5, MoveFlag::CAPTURE);
+    EXPECT_TRUE(BATTERY.see(RXD5, -400));
+    EXPECT_FALSE(BATTERY.see(RXD5, -399));
+
+    // En passant and promotions count the right pieces
+    const Position EN_PASSANT("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+    EXPECT_TRUE(EN_PASSANT.see(Move(Square::E5, Square::D6, MoveFlag::EN_PASSANT), 100));
+    const Position PROMOTION("4k3/1P6/8/8/8/8/8/4K3 w - - 0 1");
+    EXPECT_TRUE(PROMOTION.see(Move(Square::B7, Square::B8, MoveFlag::QUEEN_PROMOTION), 800));
+}
+
+TEST_F(PositionTest, DrawDetection)
+{
+    Position pos;
+    EXPECT_FALSE(pos.isDraw());
+
+    // Knights out and back: the start position recurs after four plies
+    const std::array<Move, 4> SHUFFLE = {
+        Move(Square::G1, Square::F3), Move(Square::G8, Square::F6), Move(Square::F3, Square::G1),
+        Move(Square::F6, Square::G8)};
+    for (const Move MOVE : SHUFFLE) {
+        EXPECT_FALSE(pos.isDraw()) << MOVE.toUci();
+        pos.makeMove(MOVE);
+    }
+    EXPECT_TRUE(pos.isDraw());
+
+    // An irreversible move hides everything before it
+    pos.makeMove(Move(Square::E2, Square::E4, MoveFlag::DOUBLE_PAWN_PUSH));
+    EXPECT_FALSE(pos.isDraw());
+
+    // A null move is not a real move, so it cannot complete a repetition
+    Position passing;
+    passing.makeMove(Move(Square::G1, Square::F3));
+    passing.makeNullMove();
+    passing.makeMove(Move(Square::F3, Square::G1));
+    passing.makeNullMove();
+    EXPECT_FALSE(passing.isDraw());
+
+    EXPECT_TRUE(Position("4k3/8/8/8/8/8/8/4K2R w - - 100 80").isDraw());
+    EXPECT_FALSE(Position("4k3/8/8/8/8/8/8/4K2R w - - 99 80").isDraw());
+}
+
+TEST_F(PositionTest, Perft)
+{
+    const std::vector<std::tuple<std::string, int, std::uint64_t>> CASES = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 3, 8902},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 4, 43238},
+        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9467},
+        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379},
+        {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 3, 89890},
+    };
+
+    for (const auto& [fen, depth, expected] : CASES) {
+        Position pos(fen);
+        EXPECT_EQ(perft(pos, depth), expected) << fen;
+        EXPECT_EQ(pos.toFen(), fen);
+    }
+}
+
+TEST_F(PositionTest, FromFenMatchesConstructor)
+{
+    const std::vector<std::string> FENS = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+    };
+
+    Position pos;
+    for (const auto& fen : FENS) {
+        ASSERT_EQ(pos.fromFen(fen), FenError::NONE) << fen;
+        const Position EXPECTED(fen);
+        EXPECT_EQ(pos, EXPECTED) << fen;
+        EXPECT_EQ(pos.toFen(), fen);
+        EXPECT_EQ(pos.materialKey(), EXPECTED.materialKey());
+        EXPECT_EQ(pos.psqt(), EXPECTED.psqt());
+        EXPECT_TRUE(pos.lastMove().isNone());
+    }
+
+    // Counters may be left out, and surrounding blanks are ignored
+    ASSERT_EQ(pos.fromFen("  4k3/8/8/8/8/8/8/4K2R b K -\n"), FenError::NONE);
+    EXPECT_EQ(pos.toFen(), "4k3/8/8/8/8/8/8/4K2R b K - 0 1");
+
+    // An en passant square no pawn can use is dropped, so the hash matches the one `makeMove`
+    // produces for the same position
+    ASSERT_EQ(pos.fromFen("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1"),
+              FenError::NONE);
+    Position played;
+    played.makeMove(Move(Square::E2, Square::E4, MoveFlag::DOUBLE_PAWN_PUSH));
+    EXPECT_EQ(pos.getEnPassantSquare(), Square::NONE);
+    EXPECT_EQ(pos.hash(), played.hash());
+    EXPECT_EQ(Position("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1").hash(),
+              played.hash());
+
+    // The constructor drops it too for a FEN only it accepts, here one without a white king
+    EXPECT_EQ(Position("4k3/8/8/8/4P3/8/8/8 b - e3 0 1").getEnPassantSquare(), Square::NONE);
+    EXPECT_EQ(Position("4k3/8/8/8/3pP3/8/8/8 b - e3 0 1").getEnPassantSquare(), Square::E3);
+}
+
+TEST_F(PositionTest, FromFenRejectsInvalid)
+{
+    const std::vector<std::pair<std::string, FenError>> CASES = {
+        {"", FenError::PIECE_PLACEMENT},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1", FenError::PIECE_PLACEMENT},
+        {"rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", FenError::PIECE_PLACEMENT},
+        {"rnbqkbnr/ppppxppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", FenError::PIECE_PLACEMENT},
+        {"rnbqkbnr/ppppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", FenError::PIECE_PLACEMENT},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR", FenError::SIDE_TO_MOVE},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1", FenError::SIDE_TO_MOVE},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkk - 0 1", FenError::CASTLING},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBN1 w KQkq - 0 1", FenError::CASTLING},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e3 0 1", FenError::EN_PASSANT},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e6 0 1", FenError::EN_PASSANT},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - x 1", FenError::MOVE_COUNTERS},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 extra", FenError::MOVE_COUNTERS},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQ1BNR w kq - 0 1", FenError::KING_COUNT},
+        {"rnbqkbnr/pppppppp/8/8/8/4K3/PPPPPPPP/RNBQKBNR w kq - 0 1", FenError::KING_COUNT},
+        {"4k3/8/8/8/8/8/PPPPPPPP/QQ2K3 w - - 0 1", FenError::PIECE_COUNT},
+        {"4k2P/8/8/8/8/8/8/4K3 w - - 0 1", FenError::PAWN_RANK},
+        {"4k3/8/8/8/8/8/8/4R1K1 w - - 0 1", FenError::OPPONENT_IN_CHECK},
+    };
+
+    const std::string START = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    Position pos;
+    for (const auto& [fen, error] : CASES) {
+        EXPECT_EQ(pos.fromFen(fen), error) << fen;
+        EXPECT_EQ(pos.toFen(), START) << fen;
+    }
+    EXPECT_FALSE(fenErrorToString(FenError::KING_COUNT).empty());
+}
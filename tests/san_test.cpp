@@ -0,0 +1,103 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bitboard.h"
+#include "move.h"
+#include "movegen.h"
+#include "position.h"
+#include "san.h"
+#include "zobrist.h"
+
+using namespace Chess;
+
+class SanTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        Bitboards::init();
+        Zobrist::init();
+    }
+};
+
+TEST_F(SanTest, FormatsMoves)
+{
+    const Position KIWIPETE("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    EXPECT_EQ(San::format(KIWIPETE, Move(Square::E1, Square::G1, MoveFlag::KING_CASTLE)), "O-O");
+    EXPECT_EQ(San::format(KIWIPETE, Move(Square::E1, Square::C1, MoveFlag::QUEEN_CASTLE)),
+              "O-O-O");
+    EXPECT_EQ(San::format(KIWIPETE, Move(Square::E5, Square::F7, MoveFlag::CAPTURE)), "Nxf7");
+    EXPECT_EQ(San::format(KIWIPETE, Move(Square::D5, Square::E6, MoveFlag::CAPTURE)), "dxe6");
+    EXPECT_EQ(San::format(KIWIPETE, Move(Square::G2, Square::H3, MoveFlag::CAPTURE)), "gxh3");
+    EXPECT_EQ(San::format(KIWIPETE, Move(Square::A2, Square::A4, MoveFlag::DOUBLE_PAWN_PUSH)),
+              "a4");
+
+    // Disambiguation by file, by rank, and by both
+    EXPECT_EQ(San::format(Position("4k3/8/8/8/8/8/8/R4RK1 w - - 0 1"),
+                          Move(Square::A1, Square::D1)),
+              "Rad1");
+    EXPECT_EQ(San::format(Position("R7/7k/8/8/8/8/8/R3K3 w - - 0 1"),
+                          Move(Square::A1, Square::A4)),
+              "R1a4");
+    EXPECT_EQ(San::format(Position("4k3/8/8/8/8/Q7/8/Q1Q1K3 w - - 0 1"),
+                          Move(Square::A1, Square::B2)),
+              "Qa1b2");
+
+    // Promotion, check and mate
+    EXPECT_EQ(San::format(Position("3r3k/2P5/8/8/8/8/8/4K3 w - - 0 1"),
+                          Move(Square::C7, Square::D8, MoveFlag::QUEEN_PROMOTION_CAPTURE)),
+              "cxd8=Q+");
+    EXPECT_EQ(San::format(Position("7k/8/8/8/8/8/R7/1R4K1 w - - 0 1"),
+                          Move(Square::B1, Square::B8)),
+              "Rb8+");
+    EXPECT_EQ(San::format(Position("7k/R7/8/8/8/8/8/1R4K1 w - - 0 1"),
+                          Move(Square::B1, Square::B8)),
+              "Rb8#");
+}
+
+TEST_F(SanTest, ParsesEveryLegalMove)
+{
+    const std::vector<std::string> FENS = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+    };
+
+    for (const auto& fen : FENS) {
+        const Position POS(fen);
+        for (const Move MOVE : MoveGen::generateLegal(POS)) {
+            EXPECT_EQ(San::parse(POS, San::format(POS, MOVE)).raw(), MOVE.raw()) << fen;
+        }
+    }
+}
+
+TEST_F(SanTest, ParsesVariants)
+{
+    const Position KIWIPETE("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    EXPECT_EQ(San::parse(KIWIPETE, "0-0").flag(), MoveFlag::KING_CASTLE);
+    EXPECT_EQ(San::parse(KIWIPETE, "Nxf7!?").to(), Square::F7);
+    EXPECT_EQ(San::parse(Position("8/2P5/8/8/8/8/8/k3K3 w - - 0 1"), "c8Q").flag(),
+              MoveFlag::QUEEN_PROMOTION);
+    EXPECT_EQ(San::parse(Position("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"),
+                         "exf6e.p.")
+                  .flag(),
+              MoveFlag::EN_PASSANT);
+    EXPECT_EQ(San::parse(Position("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"),
+                         "exf6 e.p.")
+                  .flag(),
+              MoveFlag::EN_PASSANT);
+
+    // More of the origin than needed still names the move
+    const Position START;
+    EXPECT_EQ(San::parse(START, "Ngf3"), Move(Square::G1, Square::F3));
+    EXPECT_EQ(San::parse(START, "N1f3"), Move(Square::G1, Square::F3));
+    EXPECT_EQ(San::parse(START, "Ng1f3"), Move(Square::G1, Square::F3));
+    EXPECT_TRUE(San::parse(START, "Nbf3").isNone());
+
+    // Unknown, illegal and ambiguous moves are rejected
+    EXPECT_TRUE(San::parse(KIWIPETE, "").isNone());
+    EXPECT_TRUE(San::parse(KIWIPETE, "e5").isNone());
+    EXPECT_TRUE(San::parse(Position("4k3/8/8/8/8/8/8/R4RK1 w - - 0 1"), "Rd1").isNone());
+    EXPECT_TRUE(San::parse(Position("4k3/8/8/6N1/8/8/8/4K1N1 w - - 0 1"), "Ngf3").isNone());
+}
@@ -0,0 +1,207 @@
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bitboard.h"
+#include "constants.h"
+#include "move.h"
+#include "movegen.h"
+#include "position.h"
+#include "search.h"
+#include "tt.h"
+#include "zobrist.h"
+
+using namespace Chess;
+
+class SearchTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        Bitboards::init();
+        Zobrist::init();
+    }
+
+    auto searchFen(const std::string& fen, int depth) -> Search::Result
+    {
+        Search::Limits limits;
+        limits.depth = depth;
+        Search::Searcher searcher(table);
+        return searcher.search(Position(fen), limits);
+    }
+
+    TranspositionTable table{1};
+};
+
+TEST_F(SearchTest, MateInOne)
+{
+    const auto RESULT = searchFen("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", 3);
+    EXPECT_EQ(RESULT.best_move.toUci(), "a1a8");
+    EXPECT_EQ(RESULT.score, Constants::Search::MATE_SCORE - 1);
+    EXPECT_TRUE(Constants::Search::isMateScore(RESULT.score));
+}
+
+TEST_F(SearchTest, MateInTwo)
+{
+    // Rook roller: either rook seals the seventh rank, the other mates on the eighth
+    const auto RESULT = searchFen("7k/8/8/8/8/8/R7/1R4K1 w - - 0 1", 5);
+    EXPECT_EQ(RESULT.score, Constants::Search::MATE_SCORE - 3);
+    EXPECT_EQ(RESULT.pv.size(), 3U);
+}
+
+TEST_F(SearchTest, WinsHangingQueen)
+{
+    const auto RESULT = searchFen("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1", 4);
+    EXPECT_EQ(RESULT.best_move.toUci(), "d2d5");
+    EXPECT_GT(RESULT.score, 300);
+}
+
+TEST_F(SearchTest, NoLegalMoves)
+{
+    const auto STALEMATE = searchFen("k7/8/1Q6/8/8/8/8/7K b - - 0 1", 4);
+    EXPECT_TRUE(STALEMATE.best_move.isNone());
+    EXPECT_EQ(STALEMATE.score, 0);
+
+    const auto MATED = searchFen("R5k1/5ppp/8/8/8/8/8/6K1 b - - 0 1", 4);
+    EXPECT_TRUE(MATED.best_move.isNone());
+    EXPECT_EQ(MATED.score, -Constants::Search::MATE_SCORE);
+}
+
+TEST_F(SearchTest, ReportsLegalPrincipalVariation)
+{
+    const std::string FEN = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    const auto RESULT = searchFen(FEN, 5);
+
+    EXPECT_EQ(RESULT.depth, 5);
+    EXPECT_GE(RESULT.seldepth, RESULT.depth);
+    EXPECT_GT(RESULT.nodes, 0U);
+    ASSERT_FALSE(RESULT.pv.empty());
+    EXPECT_EQ(RESULT.pv[0], RESULT.best_move);
+
+    Position pos(FEN);
+    for (const Move MOVE : RESULT.pv) {
+        ASSERT_TRUE(MoveGen::generateLegal(pos).contains(MOVE)) << MOVE.toUci();
+        pos.makeMove(MOVE);
+    }
+}
+
+TEST_F(SearchTest, ClearForgetsEarlierSearches)
+{
+    const Position FIRST("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    const Position SECOND(
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10");
+    Search::Limits limits;
+    limits.depth = 6;
+
+    Search::Searcher fresh(table);
+    const auto EXPECTED = fresh.search(SECOND, limits);
+
+    Search::Searcher reused(table);
+    table.clear();
+    static_cast<void>(reused.search(FIRST, limits));
+    table.clear();
+    reused.clear();
+    const auto RESULT = reused.search(SECOND, limits);
+
+    EXPECT_EQ(RESULT.best_move, EXPECTED.best_move);
+    EXPECT_EQ(RESULT.score, EXPECTED.score);
+    EXPECT_EQ(RESULT.nodes, EXPECTED.nodes);
+}
+
+TEST_F(SearchTest, NodeLimit)
+{
+    Search::Limits limits;
+    limits.nodes = 20000;
+    Search::Searcher searcher(table);
+    const auto RESULT = searcher.search(Position(), limits);
+
+    EXPECT_FALSE(RESULT.best_move.isNone());
+    EXPECT_LT(RESULT.nodes, 2 * limits.nodes);
+    EXPECT_LT(RESULT.depth, Constants::Search::MAX_PLY - 1);
+}
+
+TEST_F(SearchTest, TimeLimit)
+{
+    Search::Limits limits;
+    limits.movetime = std::chrono::milliseconds(50);
+    Search::Searcher searcher(table);
+
+    const auto START = std::chrono::steady_clock::now();
+    const auto RESULT = searcher.search(Position(), limits);
+    const auto ELAPSED = std::chrono::steady_clock::now() - START;
+
+    EXPECT_FALSE(RESULT.best_move.isNone());
+    EXPECT_LT(RESULT.depth, Constants::Search::MAX_PLY - 1);
+    EXPECT_LT(ELAPSED, std::chrono::seconds(1));
+}
+
+TEST_F(SearchTest, ClockLimit)
+{
+    // 2 s sudden death allows at most 0.8 s on one move, however unsettled the search
+    Search::Limits limits;
+    limits.time = std::chrono::milliseconds(2000);
+    Search::Searcher searcher(table);
+
+    const auto START = std::chrono::steady_clock::now();
+    const auto RESULT = searcher.search(Position(), limits);
+    const auto ELAPSED = std::chrono::steady_clock::now() - START;
+
+    EXPECT_FALSE(RESULT.best_move.isNone());
+    EXPECT_LT(ELAPSED, std::chrono::milliseconds(900));
+
+    // A movetime overrides the clock
+    limits.movetime = std::chrono::milliseconds(20);
+    const auto FIXED_START = std::chrono::steady_clock::now();
+    static_cast<void>(searcher.search(Position(), limits));
+    EXPECT_LT(std::chrono::steady_clock::now() - FIXED_START, std::chrono::milliseconds(300));
+}
+
+TEST_F(SearchTest, ThreadPoolAgreesOnForcedLines)
+{
+    Search::ThreadPool pool(table, 4);
+    EXPECT_EQ(pool.size(), 4U);
+
+    Search::Limits limits;
+    limits.depth = 6;
+    const auto MATE = pool.search(Position("7k/8/8/8/8/8/R7/1R4K1 w - - 0 1"), limits);
+    EXPECT_EQ(MATE.score, Constants::Search::MATE_SCORE - 3);
+
+    const auto CAPTURE = pool.search(Position("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1"), limits);
+    EXPECT_EQ(CAPTURE.best_move.toUci(), "d2d5");
+    EXPECT_EQ(CAPTURE.depth, 6);
+}
+
+TEST_F(SearchTest, ThreadPoolReportsEachIteration)
+{
+    Search::ThreadPool pool(table, 2);
+    std::vector<Search::Result> reports;
+    pool.setReporter([&](const Search::Result& result) { reports.push_back(result); });
+
+    Search::Limits limits;
+    limits.depth = 4;
+    const auto RESULT = pool.search(Position(), limits);
+    ASSERT_EQ(reports.size(), 4U);
+    for (std::size_t i = 0; i < reports.size(); ++i) {
+        EXPECT_EQ(reports[i].depth, static_cast<int>(i) + 1);
+        EXPECT_FALSE(reports[i].pv.empty());
+    }
+    EXPECT_EQ(reports.back().best_move, RESULT.best_move);
+    EXPECT_LE(reports.back().nodes, RESULT.nodes);
+}
+
+TEST_F(SearchTest, ThreadPoolStopsFromAnotherThread)
+{
+    Search::ThreadPool pool(table, 2);
+    Search::Result result;
+
+    std::thread runner([&] { result = pool.search(Position(), Search::Limits{}); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    pool.stop();
+    runner.join();
+
+    EXPECT_FALSE(result.best_move.isNone());
+    EXPECT_GT(result.depth, 0);
+    EXPECT_GT(result.nodes, 0U);
+}
@@ -0,0 +1,55 @@
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "move.h"
+#include "timeman.h"
+#include "types.h"
+
+using namespace Chess;
+using std::chrono::milliseconds;
+
+TEST(TimeManagerTest, BudgetsFollowTheClock)
+{
+    Time::Manager manager;
+    manager.init(milliseconds(60000), milliseconds(0), 0);
+    const milliseconds SUDDEN_DEATH = manager.softLimit();
+    EXPECT_GT(SUDDEN_DEATH, milliseconds(0));
+    EXPECT_GT(manager.hardLimit(), SUDDEN_DEATH);
+    EXPECT_LT(manager.hardLimit(), milliseconds(60000));
+
+    // An increment and an imminent time control both allow more per move
+    manager.init(milliseconds(60000), milliseconds(1000), 0);
+    EXPECT_GT(manager.softLimit(), SUDDEN_DEATH);
+    manager.init(milliseconds(60000), milliseconds(0), 5);
+    EXPECT_GT(manager.softLimit(), SUDDEN_DEATH);
+
+    // The last move before the control still keeps a reserve, and so does an almost empty clock
+    manager.init(milliseconds(60000), milliseconds(0), 1);
+    EXPECT_LT(manager.hardLimit(), milliseconds(60000));
+    manager.init(milliseconds(5), milliseconds(0), 0);
+    EXPECT_EQ(manager.softLimit(), milliseconds(1));
+    EXPECT_EQ(manager.hardLimit(), milliseconds(1));
+}
+
+TEST(TimeManagerTest, StabilityAndScoreAdjustSoftLimit)
+{
+    const Move FIRST(Square::E2, Square::E4, MoveFlag::DOUBLE_PAWN_PUSH);
+    const Move SECOND(Square::D2, Square::D4, MoveFlag::DOUBLE_PAWN_PUSH);
+
+    // The same move every iteration, with most of the nodes: an easy move
+    Time::Manager easy;
+    easy.init(milliseconds(60000), milliseconds(0), 0);
+    const milliseconds BASE = easy.softLimit();
+    for (int depth = 1; depth <= 10; ++depth) { easy.update(FIRST, 30, 0.95); }
+    EXPECT_LT(easy.softLimit(), BASE);
+
+    // A best move that keeps changing while the score falls
+    Time::Manager hard;
+    hard.init(milliseconds(60000), milliseconds(0), 0);
+    for (int depth = 1; depth <= 10; ++depth) {
+        hard.update(depth % 2 == 0 ? FIRST : SECOND, 100 - (depth * 30), 0.4);
+    }
+    EXPECT_GT(hard.softLimit(), BASE);
+    EXPECT_LE(hard.softLimit(), hard.hardLimit());
+}
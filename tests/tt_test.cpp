@@ -0,0 +1,108 @@
+#include <cstdint>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "bitboard.h"
+#include "move.h"
+#include "position.h"
+#include "tt.h"
+#include "zobrist.h"
+
+using namespace Chess;
+
+class TranspositionTableTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        Bitboards::init();
+        Zobrist::init();
+    }
+};
+
+TEST_F(TranspositionTableTest, SizeAndAlignment)
+{
+    const TranspositionTable TABLE(8);
+    EXPECT_EQ(TABLE.sizeInBytes(), 8U << 20U);
+
+    // Non power-of-two budgets round down
+    const TranspositionTable ROUNDED(12);
+    EXPECT_EQ(ROUNDED.sizeInBytes(), 8U << 20U);
+}
+
+TEST_F(TranspositionTableTest, StoreAndProbe)
+{
+    TranspositionTable table(1);
+    const Position POS;
+    const Move MOVE(Square::E2, Square::E4, MoveFlag::DOUBLE_PAWN_PUSH);
+    TTData data{};
+
+    EXPECT_FALSE(table.probe(POS.hash(), data));
+
+    table.store(POS.hash(), MOVE, -123, 45, 7, Bound::LOWER);
+    ASSERT_TRUE(table.probe(POS.hash(), data));
+    EXPECT_EQ(data.move, MOVE);
+    EXPECT_EQ(data.score, -123);
+    EXPECT_EQ(data.eval, 45);
+    EXPECT_EQ(data.depth, 7);
+    EXPECT_EQ(data.bound, Bound::LOWER);
+
+    EXPECT_FALSE(table.probe(POS.hash() ^ 1, data));
+
+    // Negative (quiescence) depths survive the round trip
+    table.store(POS.hash(), Move(), 0, 0, -1, Bound::EXACT);
+    ASSERT_TRUE(table.probe(POS.hash(), data));
+    EXPECT_EQ(data.depth, -1);
+    EXPECT_EQ(data.move, MOVE) << "a move-less store keeps the previous move";
+
+    table.clear();
+    EXPECT_FALSE(table.probe(POS.hash(), data));
+}
+
+TEST_F(TranspositionTableTest, ReplacementPrefersDeepAndCurrent)
+{
+    TranspositionTable table(1);
+    TTData data{};
+
+    // Keys sharing a bucket differ only above the index bits
+    const HashKey BASE = 0x1234;
+    const auto KEY = [&](uint64_t i) { return BASE + (i << 40U); };
+
+    for (uint64_t i = 0; i < 4; ++i) {
+        table.store(KEY(i), Move(), 0, 0, static_cast<int>(10 + i), Bound::EXACT);
+    }
+    // Bucket full: the shallowest entry makes room
+    table.store(KEY(4), Move(), 0, 0, 20, Bound::EXACT);
+    EXPECT_FALSE(table.probe(KEY(0), data));
+    EXPECT_TRUE(table.probe(KEY(1), data));
+    EXPECT_TRUE(table.probe(KEY(4), data));
+
+    // A shallower non-exact result does not overwrite the same position from this search
+    table.store(KEY(4), Move(), 0, 0, 3, Bound::UPPER);
+    ASSERT_TRUE(table.probe(KEY(4), data));
+    EXPECT_EQ(data.depth, 20);
+
+    // Entries from older searches are evicted before deeper current ones
+    table.newSearch();
+    table.newSearch();
+    table.store(KEY(5), Move(), 0, 0, 1, Bound::EXACT);
+    table.store(KEY(6), Move(), 0, 0, 1, Bound::EXACT);
+    EXPECT_TRUE(table.probe(KEY(5), data));
+    EXPECT_TRUE(table.probe(KEY(6), data));
+}
+
+TEST_F(TranspositionTableTest, Hashfull)
+{
+    TranspositionTable table(1);
+    EXPECT_EQ(table.hashfull(), 0);
+
+    std::mt19937_64 rng(42);
+    for (int i = 0; i < 1 << 16; ++i) { table.store(rng(), Move(), 0, 0, 1, Bound::EXACT); }
+    const int FULL = table.hashfull();
+    EXPECT_GT(FULL, 500);
+    EXPECT_LE(FULL, 1000);
+
+    // Only the current search counts
+    table.newSearch();
+    EXPECT_EQ(table.hashfull(), 0);
+}
@@ -0,0 +1,245 @@
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "bitboard.h"
+#include "nnue.h"
+#include "uci.h"
+#include "zobrist.h"
+
+using namespace Chess;
+
+namespace {
+
+// Notes when the first best move is flushed, which the engine does from its search thread
+class TimedBuffer : public std::stringbuf {
+public:
+    auto bestMoveTime() -> std::optional<std::chrono::steady_clock::time_point>
+    {
+        const std::lock_guard<std::mutex> LOCK(m_mutex);
+        return m_best_move;
+    }
+
+protected:
+    auto sync() -> int override
+    {
+        const std::lock_guard<std::mutex> LOCK(m_mutex);
+        if (!m_best_move && str().find("bestmove ") != std::string::npos) {
+            m_best_move = std::chrono::steady_clock::now();
+        }
+        return 0;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::optional<std::chrono::steady_clock::time_point> m_best_move;
+};
+
+} // namespace
+
+class UciTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        Bitboards::init();
+        Zobrist::init();
+    }
+
+    // Everything the engine printed so far, then forgets it
+    auto takeOutput() -> std::string
+    {
+        std::string text = m_buffer.str();
+        m_buffer.str("");
+        return text;
+    }
+
+    TimedBuffer m_buffer;
+    std::ostream m_out{&m_buffer};
+};
+
+TEST_F(UciTest, Handshake)
+{
+    Uci::Engine engine(m_out);
+    EXPECT_TRUE(engine.execute("uci"));
+    EXPECT_TRUE(engine.execute("isready"));
+    const std::string OUTPUT = takeOutput();
+    EXPECT_NE(OUTPUT.find("id name DuChess"), std::string::npos);
+    EXPECT_NE(OUTPUT.find("option name Hash type spin"), std::string::npos);
+    EXPECT_NE(OUTPUT.find("uciok\nreadyok\n"), std::string::npos);
+
+    EXPECT_TRUE(engine.execute("setoption name Hash value 2"));
+    EXPECT_TRUE(engine.execute("setoption name Threads value 2"));
+    EXPECT_TRUE(engine.execute("setoption name OwnBook value true"));
+    EXPECT_TRUE(engine.execute("ucinewgame"));
+    EXPECT_EQ(takeOutput(), "");
+    EXPECT_TRUE(engine.execute("setoption name BookFile value /nonexistent/book.bin"));
+    EXPECT_EQ(takeOutput(), "info string cannot open book /nonexistent/book.bin\n");
+    EXPECT_FALSE(engine.execute("quit"));
+}
+
+TEST_F(UciTest, EvalFileLoadsNetwork)
+{
+    const auto PATH = std::filesystem::temp_directory_path() / "duchess_uci_test.nnue";
+    {
+        auto network = std::make_unique<NNUE::Network>();
+        NNUE::randomize(*network, 1);
+        ASSERT_TRUE(NNUE::save(PATH.string(), *network));
+    }
+
+    Uci::Engine engine(m_out);
+    engine.execute("setoption name EvalFile value " + PATH.string());
+    EXPECT_EQ(takeOutput(), "info string loaded network " + PATH.string() + "\n");
+    engine.execute("position fen 6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+    engine.execute("go depth 3");
+    engine.waitForSearch();
+    EXPECT_NE(takeOutput().find("bestmove a1a8"), std::string::npos);
+
+    // A bad file keeps the network already loaded
+    std::filesystem::remove(PATH);
+    engine.execute("setoption name EvalFile value " + PATH.string());
+    EXPECT_EQ(takeOutput(), "info string cannot load network " + PATH.string() + "\n");
+    engine.execute("setoption name EvalFile value <empty>");
+    EXPECT_EQ(takeOutput(), "");
+}
+
+TEST_F(UciTest, PositionPlaysOnlyNewMoves)
+{
+    Uci::Engine engine(m_out);
+    engine.execute("position startpos moves e2e4 e7e5");
+    engine.execute("position startpos moves e2e4 e7e5 g1f3");
+    engine.execute("d");
+    EXPECT_EQ(takeOutput(),
+              "Fen: rnbqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 2\n");
+
+    // A different game, or a move list that is not an extension, starts over
+    engine.execute("position startpos moves d2d4");
+    engine.execute("d");
+    EXPECT_EQ(takeOutput(), "Fen: rnbqkbnr/pppppppp/8/8/3P4/8/PPP1PPPP/RNBQKBNR b KQkq - 0 1\n");
+    engine.execute("position fen 4k3/8/8/8/8/8/4P3/4K3 w - - 0 1 moves e2e4");
+    engine.execute("d");
+    EXPECT_EQ(takeOutput(), "Fen: 4k3/8/8/8/4P3/8/8/4K3 b - - 0 1\n");
+
+    engine.execute("position startpos moves e2e5");
+    EXPECT_EQ(takeOutput(), "info string illegal move e2e5\n");
+
+    // Anything but startpos or fen is refused and keeps the position
+    engine.execute("position startpos moves e2e4");
+    engine.execute("position garbage moves d2d4");
+    engine.execute("position startpos extra moves d2d4");
+    engine.execute("position moves d2d4");
+    engine.execute("d");
+    EXPECT_EQ(takeOutput(), "info string position needs startpos or fen\n"
+                            "info string position needs startpos or fen\n"
+                            "info string position needs startpos or fen\n"
+                            "Fen: rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1\n");
+}
+
+TEST_F(UciTest, GoReportsBestMove)
+{
+    Uci::Engine engine(m_out);
+    engine.execute("position fen 6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+    engine.execute("go depth 3");
+    engine.waitForSearch();
+    const std::string OUTPUT = takeOutput();
+    // One line per iteration, then the best move
+    EXPECT_NE(OUTPUT.find("info depth 1 "), std::string::npos);
+    EXPECT_NE(OUTPUT.find("info depth 2 "), std::string::npos);
+    EXPECT_NE(OUTPUT.find("info depth 3"), std::string::npos);
+    EXPECT_NE(OUTPUT.find("score mate 1"), std::string::npos);
+    EXPECT_NE(OUTPUT.find("bestmove a1a8"), std::string::npos);
+
+    // Clock times in the go command are enough to bound the search
+    engine.execute("position startpos");
+    engine.execute("go wtime 200 btime 200");
+    engine.waitForSearch();
+    EXPECT_NE(takeOutput().find("bestmove "), std::string::npos);
+}
+
+TEST_F(UciTest, StopEndsInfiniteSearch)
+{
+    Uci::Engine engine(m_out);
+    engine.execute("position startpos");
+    engine.execute("go infinite");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    // Still searching, and still answering
+    engine.execute("isready");
+    const std::string OUTPUT = takeOutput();
+    EXPECT_NE(OUTPUT.find("readyok\n"), std::string::npos);
+    EXPECT_EQ(OUTPUT.find("bestmove"), std::string::npos);
+
+    // From reading the stop line to flushing the best move, search teardown included. The
+    // search notices a stop within a few thousand nodes; the bound leaves room for a loaded
+    // machine descheduling the search thread.
+    const auto STOP = std::chrono::steady_clock::now();
+    engine.execute("stop");
+    engine.waitForSearch();
+    const auto BEST_MOVE = m_buffer.bestMoveTime();
+    ASSERT_TRUE(BEST_MOVE.has_value());
+    EXPECT_LT(*BEST_MOVE - STOP, std::chrono::milliseconds(50));
+    EXPECT_NE(takeOutput().find("bestmove "), std::string::npos);
+}
+
+TEST_F(UciTest, GoWhileSearchingIsRefused)
+{
+    Uci::Engine engine(m_out);
+    engine.execute("position startpos");
+    engine.execute("go infinite");
+
+    // Refused at once, so stop is still read and ends the first search
+    engine.execute("go depth 1");
+    EXPECT_NE(takeOutput().find("info string search already running\n"), std::string::npos);
+    engine.execute("stop");
+    engine.waitForSearch();
+    EXPECT_NE(takeOutput().find("bestmove "), std::string::npos);
+}
+
+TEST_F(UciTest, OptionsWaitForTheSearchToEnd)
+{
+    Uci::Engine engine(m_out);
+    engine.execute("position startpos");
+    engine.execute("go infinite");
+
+    // Taken without blocking, so the stop after them is still read
+    engine.execute("setoption name Hash value 32");
+    engine.execute("setoption name Threads value 2");
+    engine.execute("ucinewgame");
+    engine.execute("stop");
+    engine.waitForSearch();
+    EXPECT_NE(takeOutput().find("bestmove "), std::string::npos);
+
+    engine.execute("go depth 2");
+    engine.waitForSearch();
+    EXPECT_NE(takeOutput().find("bestmove "), std::string::npos);
+}
+
+TEST_F(UciTest, GoSkipsUnsupportedParameters)
+{
+    Uci::Engine engine(m_out);
+    engine.execute("position fen 6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+    engine.execute("go searchmoves a1a2 g1f1 mate 3 depth 3");
+    engine.waitForSearch();
+    const std::string OUTPUT = takeOutput();
+    EXPECT_EQ(OUTPUT.find("info string"), std::string::npos) << OUTPUT;
+    EXPECT_NE(OUTPUT.find("info depth 3"), std::string::npos);
+}
+
+TEST_F(UciTest, PonderhitSwitchesToTimedSearch)
+{
+    Uci::Engine engine(m_out);
+    engine.execute("position startpos moves e2e4");
+    engine.execute("go ponder movetime 50");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // Pondering never ends on its own, whatever the limits
+    EXPECT_EQ(takeOutput().find("bestmove"), std::string::npos);
+
+    engine.execute("ponderhit");
+    engine.waitForSearch();
+    EXPECT_NE(takeOutput().find("bestmove "), std::string::npos);
+}
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bitbase.h"
+#include "bitboard.h"
+#include "zobrist.h"
+
+using namespace Chess;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::array<const char*, 4> DEFAULT_TABLES = {"KPK", "KRK", "KQK", "KRKP"};
+
+struct Options {
+    std::vector<Bitbases::Signature> tables;
+    std::string directory = ".";
+    unsigned int threads = std::max(1U, std::thread::hardware_concurrency());
+};
+
+auto printUsage() -> void
+{
+    std::cerr << "usage: duchess-bitbase [--threads N] [--out DIR] [TABLE...]\n"
+              << "  Builds each TABLE (e.g. KRKP) and every smaller table it needs, skipping\n"
+              << "  ones already in DIR. Without tables it builds KPK KRK KQK KRKP.\n";
+}
+
+auto parseOptions(int argc, char* argv[], Options& options) -> bool
+{
+    std::vector<std::string> names;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string ARG = argv[i];
+            if ((ARG == "--threads" || ARG == "--out") && i + 1 < argc) {
+                const std::string VALUE = argv[++i];
+                if (ARG == "--threads") { options.threads = std::max(1, std::stoi(VALUE)); }
+                else { options.directory = VALUE; }
+            }
+            else if (ARG.rfind("--", 0) == 0) {
+                return false;
+            }
+            else {
+                names.push_back(ARG);
+            }
+        }
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+
+    if (names.empty()) { names.assign(DEFAULT_TABLES.begin(), DEFAULT_TABLES.end()); }
+    for (const std::string& name : names) {
+        Bitbases::Signature signature;
+        if (!Bitbases::parseSignature(name, signature)) {
+            std::cerr << "not a table of at most " << Constants::Bitbase::MAX_PIECES
+                      << " pieces: " << name << '\n';
+            return false;
+        }
+        options.tables.push_back(Bitbases::canonical(signature));
+    }
+    return true;
+}
+
+auto report(const Bitbases::Table& table, std::chrono::milliseconds elapsed) -> void
+{
+    std::array<std::size_t, 4> counts{};
+    for (std::size_t index = 0; index < table.size(); ++index) {
+        ++counts[static_cast<std::size_t>(table.value(index))];
+    }
+    std::cout << Bitbases::signatureName(table.signature()) << ": " << table.size()
+              << " entries, " << counts[static_cast<std::size_t>(Bitbases::Wdl::WIN)]
+              << " won, " << counts[static_cast<std::size_t>(Bitbases::Wdl::DRAW)] << " drawn, "
+              << counts[static_cast<std::size_t>(Bitbases::Wdl::LOSS)] << " lost, "
+              << elapsed.count() << " ms\n";
+}
+
+// Builds the tables `signature` depends on, then `signature` itself, unless already known
+auto build(const Bitbases::Signature& signature, const Options& options, Bitbases::Set& set)
+    -> bool
+{
+    if (set.find(signature) != nullptr) { return true; }
+    for (const Bitbases::Signature& dependency : Bitbases::dependencies(signature)) {
+        if (!build(dependency, options, set)) { return false; }
+    }
+
+    const std::string NAME = Bitbases::signatureName(signature);
+    const auto START = Clock::now();
+    auto table = std::make_unique<Bitbases::Table>();
+    if (!Bitbases::generate(signature, set, options.threads, *table)) {
+        std::cerr << "missing a table " << NAME << " depends on\n";
+        return false;
+    }
+    report(*table,
+           std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - START));
+
+    const std::filesystem::path PATH = std::filesystem::path(options.directory) / (NAME + ".bb");
+    if (!table->save(PATH.string())) {
+        std::cerr << "cannot write " << PATH.string() << '\n';
+        return false;
+    }
+    set.add(std::move(table));
+    return true;
+}
+
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    Bitboards::init();
+    Zobrist::init();
+
+    std::error_code error;
+    std::filesystem::create_directories(options.directory, error);
+    Bitbases::Set set;
+    const std::size_t EXISTING = set.load(options.directory);
+    if (EXISTING > 0) { std::cout << "Loaded " << EXISTING << " tables\n"; }
+
+    for (const Bitbases::Signature& signature : options.tables) {
+        if (!build(signature, options, set)) { return 1; }
+    }
+    return 0;
+}
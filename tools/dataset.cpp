@@ -0,0 +1,170 @@
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bitboard.h"
+#include "constants.h"
+#include "dataset.h"
+#include "epd.h"
+#include "packed.h"
+#include "position.h"
+#include "zobrist.h"
+
+using namespace Chess;
+
+namespace {
+
+struct ResultName {
+    GameResult result;
+    std::string_view name;
+};
+
+constexpr std::array<ResultName, 3> RESULT_NAMES = {{
+    {GameResult::WHITE_WIN, "1-0"},
+    {GameResult::DRAW, "1/2-1/2"},
+    {GameResult::BLACK_WIN, "0-1"},
+}};
+
+auto printUsage() -> void
+{
+    std::cerr << "usage: duchess-dataset pack <in.epd> <out.bin>\n"
+              << "       duchess-dataset unpack <in.bin> <out.epd>\n"
+              << "  EPD lines are a FEN, optionally with its move counters, then operations.\n"
+              << "  The ce (centipawns for the side to move), c9 (game result), hmvc and fmvn\n"
+              << "  operations are kept; others are dropped.\n";
+}
+
+auto parseInt(std::string_view text, int& value) -> bool
+{
+    const char* const END = text.data() + text.size();
+    const auto [LAST, STATUS] = std::from_chars(text.data(), END, value);
+    return STATUS == std::errc() && LAST == END;
+}
+
+// Reads one EPD line into `pos` and `record`; the other arguments are scratch space reused
+// across lines
+auto parseLine(std::string_view line, std::string& fen, std::vector<Epd::Operation>& operations,
+               Position& pos, PackedPosition& record) -> std::string_view
+{
+    if (!Epd::parse(line, fen, operations)) { return "too few FEN fields"; }
+
+    int score = Constants::Packed::SCORE_NONE;
+    const std::string_view SCORE = Epd::find(operations, "ce");
+    if (!SCORE.empty() &&
+        (!parseInt(SCORE, score) || score <= Constants::Packed::SCORE_NONE ||
+         score > std::numeric_limits<int16_t>::max())) {
+        return "invalid ce operand";
+    }
+
+    GameResult result = GameResult::NONE;
+    const std::string_view RESULT = Epd::find(operations, "c9");
+    for (const ResultName& entry : RESULT_NAMES) {
+        if (RESULT == entry.name) { result = entry.result; }
+    }
+
+    const FenError ERROR = pos.fromFen(fen);
+    if (ERROR != FenError::NONE) { return fenErrorToString(ERROR); }
+    if (!pos.pack(record)) { return "move counters too large to pack"; }
+    record.score = static_cast<int16_t>(score);
+    record.result = result;
+    return {};
+}
+
+auto pack(const std::string& input, const std::string& output) -> bool
+{
+    std::ifstream in(input);
+    DatasetWriter writer;
+    if (!in || !writer.open(output)) {
+        std::cerr << "cannot open " << (in ? output : input) << '\n';
+        return false;
+    }
+
+    Position pos;
+    PackedPosition record{};
+    std::string line;
+    std::string fen;
+    std::vector<Epd::Operation> operations;
+    std::size_t line_number = 0;
+    std::size_t rejected = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        const std::string_view TEXT = Epd::trim(line);
+        if (TEXT.empty() || TEXT.front() == '#') { continue; }
+
+        const std::string_view ERROR = parseLine(TEXT, fen, operations, pos, record);
+        if (!ERROR.empty()) {
+            std::cerr << input << ':' << line_number << ": " << ERROR << '\n';
+            ++rejected;
+        }
+        else if (!writer.write(record)) {
+            break;
+        }
+    }
+
+    const std::size_t WRITTEN = writer.size();
+    if (!writer.close()) {
+        std::cerr << "write to " << output << " failed\n";
+        return false;
+    }
+    std::cout << "packed " << WRITTEN << " positions, rejected " << rejected << '\n';
+    return true;
+}
+
+auto unpack(const std::string& input, const std::string& output) -> bool
+{
+    Dataset dataset;
+    std::ofstream out(output, std::ios::trunc);
+    if (!dataset.open(input) || !out) {
+        std::cerr << "cannot open " << (out ? input : output) << '\n';
+        return false;
+    }
+
+    Position pos;
+    DatasetReader reader(dataset);
+    std::string fen;
+    while (reader.next(pos)) {
+        const PackedPosition& record = reader.record();
+        pos.toFen(fen);
+        out << fen;
+        if (record.score != Constants::Packed::SCORE_NONE) { out << " ce " << record.score << ';'; }
+        for (const ResultName& entry : RESULT_NAMES) {
+            if (record.result == entry.result) { out << " c9 \"" << entry.name << "\";"; }
+        }
+        out << '\n';
+    }
+
+    if (!out.flush()) {
+        std::cerr << "write to " << output << " failed\n";
+        return false;
+    }
+    std::cout << "unpacked " << (dataset.size() - reader.skipped()) << " positions, skipped "
+              << reader.skipped() << " invalid records\n";
+    return true;
+}
+
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+    if (argc != 4) {
+        printUsage();
+        return 1;
+    }
+
+    Bitboards::init();
+    Zobrist::init();
+
+    const std::string_view COMMAND = argv[1];
+    if (COMMAND == "pack") { return pack(argv[2], argv[3]) ? 0 : 1; }
+    if (COMMAND == "unpack") { return unpack(argv[2], argv[3]) ? 0 : 1; }
+
+    printUsage();
+    return 1;
+}
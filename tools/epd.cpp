@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bitboard.h"
+#include "constants.h"
+#include "epd.h"
+#include "move.h"
+#include "position.h"
+#include "san.h"
+#include "search.h"
+#include "tt.h"
+#include "zobrist.h"
+
+using namespace Chess;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t DEFAULT_HASH_MB = 16;
+constexpr int DEFAULT_MOVETIME_MS = 1000;
+constexpr double NANOSECONDS_PER_SECOND = 1e9;
+
+struct Options {
+    std::string path;
+    Search::Limits limits;
+    unsigned int threads = std::max(1U, std::thread::hardware_concurrency());
+    std::size_t hash_mb = DEFAULT_HASH_MB;
+};
+
+// A test position with the moves it expects (bm) and the moves it forbids (am). Positions are
+// kept as FEN so a large suite does not hold a full `Position` per test.
+struct Test {
+    std::string id;
+    std::string fen;
+    MoveList best_moves;
+    MoveList avoid_moves;
+};
+
+struct Outcome {
+    Search::Result result;
+    bool solved = false;
+};
+
+auto printUsage() -> void
+{
+    std::cerr << "usage: duchess-epd <file.epd> [--movetime MS] [--nodes N] [--depth D]\n"
+              << "                   [--threads N] [--hash MB]\n"
+              << "  Each position is searched by one thread; --hash is per thread.\n"
+              << "  Without a limit every position gets " << DEFAULT_MOVETIME_MS << " ms.\n";
+}
+
+auto parseOptions(int argc, char* argv[], Options& options) -> bool
+{
+    if (argc < 2 || argc % 2 != 0) { return false; }
+    options.path = argv[1];
+
+    try {
+        for (int i = 2; i + 1 < argc; i += 2) {
+            const std::string FLAG = argv[i];
+            const std::string VALUE = argv[i + 1];
+            if (FLAG == "--movetime") {
+                options.limits.movetime = std::chrono::milliseconds(std::stoll(VALUE));
+            }
+            else if (FLAG == "--nodes") {
+                options.limits.nodes = std::stoull(VALUE);
+            }
+            else if (FLAG == "--depth") {
+                options.limits.depth = std::stoi(VALUE);
+            }
+            else if (FLAG == "--threads") {
+                options.threads = std::max(1, std::stoi(VALUE));
+            }
+            else if (FLAG == "--hash") {
+                const long long MEGABYTES = std::stoll(VALUE);
+                if (MEGABYTES <= 0) { return false; }
+                options.hash_mb = static_cast<std::size_t>(
+                    std::min<long long>(MEGABYTES, Constants::TT::MAX_SIZE_MB));
+            }
+            else {
+                return false;
+            }
+        }
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+
+    const bool LIMITED = options.limits.movetime.count() > 0 || options.limits.nodes > 0 ||
+                         options.limits.depth < Search::Limits().depth;
+    if (!LIMITED) { options.limits.movetime = std::chrono::milliseconds(DEFAULT_MOVETIME_MS); }
+    return true;
+}
+
+// Adds each SAN move of `operands` to `moves`; false if one is not legal here
+auto parseMoves(const Position& pos, std::string_view operands, MoveList& moves) -> bool
+{
+    for (std::string_view token = Epd::nextToken(operands); !token.empty();
+         token = Epd::nextToken(operands)) {
+        // The blank in "exd6 e.p." splits off the suffix
+        if (token == "e.p.") { continue; }
+        const Move MOVE = San::parse(pos, token);
+        if (MOVE.isNone()) { return false; }
+        moves.push(MOVE);
+    }
+    return true;
+}
+
+auto loadTests(const std::string& path, std::vector<Test>& tests) -> bool
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "cannot open " << path << '\n';
+        return false;
+    }
+
+    Position pos;
+    std::string line;
+    std::vector<Epd::Operation> operations;
+    std::size_t line_number = 0;
+    while (std::getline(file, line)) {
+        ++line_number;
+        const std::string_view TEXT = Epd::trim(line);
+        if (TEXT.empty() || TEXT.front() == '#') { continue; }
+
+        const auto REJECT = [&](std::string_view reason) {
+            std::cerr << path << ':' << line_number << ": " << reason << '\n';
+        };
+
+        Test test;
+        if (!Epd::parse(TEXT, test.fen, operations)) {
+            REJECT("too few FEN fields");
+            continue;
+        }
+        if (const FenError ERROR = pos.fromFen(test.fen); ERROR != FenError::NONE) {
+            REJECT(fenErrorToString(ERROR));
+            continue;
+        }
+        if (!parseMoves(pos, Epd::find(operations, "bm"), test.best_moves) ||
+            !parseMoves(pos, Epd::find(operations, "am"), test.avoid_moves)) {
+            REJECT("illegal or unreadable bm/am move");
+            continue;
+        }
+        if (test.best_moves.empty() && test.avoid_moves.empty()) {
+            REJECT("no bm or am operation");
+            continue;
+        }
+
+        const std::string_view ID = Epd::find(operations, "id");
+        test.id = ID.empty() ? "line " + std::to_string(line_number) : std::string(ID);
+        tests.push_back(std::move(test));
+    }
+    return true;
+}
+
+auto isSolved(const Test& test, Move move) -> bool
+{
+    return (test.best_moves.empty() || test.best_moves.contains(move)) &&
+           !test.avoid_moves.contains(move);
+}
+
+auto perSecond(std::uint64_t count, std::chrono::nanoseconds elapsed) -> std::uint64_t
+{
+    if (elapsed.count() == 0) { return 0; }
+    return static_cast<std::uint64_t>(static_cast<double>(count) * NANOSECONDS_PER_SECOND /
+                                      static_cast<double>(elapsed.count()));
+}
+
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    Bitboards::init();
+    Zobrist::init();
+
+    std::vector<Test> tests;
+    if (!loadTests(options.path, tests)) { return 1; }
+    options.threads =
+        static_cast<unsigned int>(std::clamp<std::size_t>(tests.size(), 1, options.threads));
+
+    // Tests are handed out one at a time, so a worker that drew a quick position moves on to the
+    // next instead of idling. Each worker clears its table and move-ordering statistics first,
+    // so a result does not depend on which positions the worker searched before.
+    std::vector<Outcome> outcomes(tests.size());
+    std::atomic<std::size_t> next_test{0};
+    std::mutex output;
+
+    const auto WORKER = [&]() {
+        TranspositionTable table(options.hash_mb);
+        const auto SEARCHER = std::make_unique<Search::Searcher>(table);
+        Position pos;
+        for (std::size_t i = next_test++; i < tests.size(); i = next_test++) {
+            const Test& test = tests[i];
+            // Every FEN was checked while loading
+            static_cast<void>(pos.fromFen(test.fen));
+            table.clear();
+            table.newSearch();
+            SEARCHER->clear();
+            Outcome& outcome = outcomes[i];
+            outcome.result = SEARCHER->search(pos, options.limits);
+            outcome.solved = isSolved(test, outcome.result.best_move);
+
+            const std::string MOVE = outcome.result.best_move.isNone()
+                                         ? "(none)"
+                                         : San::format(pos, outcome.result.best_move);
+            const std::lock_guard<std::mutex> LOCK(output);
+            std::cout << (outcome.solved ? "solved " : "FAILED ") << test.id << ": " << MOVE
+                      << " score " << outcome.result.score << " depth " << outcome.result.depth
+                      << " nodes " << outcome.result.nodes << '\n';
+        }
+    };
+
+    const auto START = Clock::now();
+    std::vector<std::thread> pool;
+    pool.reserve(options.threads);
+    for (unsigned int id = 0; id < options.threads; ++id) { pool.emplace_back(WORKER); }
+    for (std::thread& thread : pool) { thread.join(); }
+    const auto ELAPSED = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - START);
+
+    std::size_t solved = 0;
+    std::uint64_t nodes = 0;
+    std::vector<std::string_view> failed;
+    for (std::size_t i = 0; i < tests.size(); ++i) {
+        nodes += outcomes[i].result.nodes;
+        if (outcomes[i].solved) { ++solved; }
+        else { failed.push_back(tests[i].id); }
+    }
+
+    std::cout << "\nSolved: " << solved << " / " << tests.size() << "\nTime: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(ELAPSED).count() << " ms"
+              << "\nNodes: " << nodes << "\nNPS: " << perSecond(nodes, ELAPSED)
+              << "\nThreads: " << options.threads << '\n';
+    if (!failed.empty()) {
+        std::cout << "Failed:";
+        for (const std::string_view ID : failed) { std::cout << ' ' << ID; }
+        std::cout << '\n';
+    }
+
+    return 0;
+}
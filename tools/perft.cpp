@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bitboard.h"
+#include "constants.h"
+#include "move.h"
+#include "movegen.h"
+#include "perft.h"
+#include "position.h"
+#include "zobrist.h"
+
+using namespace Chess;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t DEFAULT_HASH_MB = 64;
+constexpr double NANOSECONDS_PER_SECOND = 1e9;
+
+struct Options {
+    std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    int depth = 0;
+    unsigned int threads = std::max(1U, std::thread::hardware_concurrency());
+    std::size_t hash_mb = DEFAULT_HASH_MB;
+};
+
+struct WorkerStats {
+    std::size_t root_moves = 0;
+    std::uint64_t nodes = 0;
+    std::chrono::nanoseconds busy{0};
+};
+
+auto printUsage() -> void
+{
+    std::cerr << "usage: duchess-perft <fen|startpos> <depth> [--threads N] [--hash MB]\n"
+              << "  --hash 0 disables the subtree cache; at most " << Constants::TT::MAX_SIZE_MB
+              << " MB\n";
+}
+
+auto parseOptions(int argc, char* argv[], Options& options) -> bool
+{
+    if (argc < 3) { return false; }
+
+    const std::string FEN = argv[1];
+    if (FEN != "startpos") { options.fen = FEN; }
+
+    try {
+        options.depth = std::stoi(argv[2]);
+        for (int i = 3; i + 1 < argc; i += 2) {
+            const std::string FLAG = argv[i];
+            if (FLAG == "--threads") {
+                options.threads = std::max(1, std::stoi(argv[i + 1]));
+            }
+            else if (FLAG == "--hash") {
+                const long long MEGABYTES = std::stoll(argv[i + 1]);
+                if (MEGABYTES < 0) { return false; }
+                options.hash_mb = static_cast<std::size_t>(
+                    std::min<long long>(MEGABYTES, Constants::TT::MAX_SIZE_MB));
+            }
+            else {
+                return false;
+            }
+        }
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+
+    return options.depth >= 1 && (argc - 3) % 2 == 0;
+}
+
+auto perSecond(std::uint64_t count, std::chrono::nanoseconds elapsed) -> std::uint64_t
+{
+    if (elapsed.count() == 0) { return 0; }
+    return static_cast<std::uint64_t>(static_cast<double>(count) * NANOSECONDS_PER_SECOND /
+                                      static_cast<double>(elapsed.count()));
+}
+
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    Bitboards::init();
+    Zobrist::init();
+
+    Position root;
+    if (const FenError ERROR = root.fromFen(options.fen); ERROR != FenError::NONE) {
+        std::cerr << "invalid FEN: " << fenErrorToString(ERROR) << '\n';
+        return 1;
+    }
+    const MoveList ROOT_MOVES = MoveGen::generateLegal(root);
+
+    std::optional<Perft::Table> storage;
+    if (options.hash_mb > 0) { storage.emplace(options.hash_mb); }
+    Perft::Table* table = storage ? &*storage : nullptr;
+
+    // Root moves are handed out one at a time so a thread that drew a small subtree picks up the
+    // next one instead of idling behind a large one
+    std::vector<std::uint64_t> divide(ROOT_MOVES.size(), 0);
+    std::vector<WorkerStats> stats(options.threads);
+    std::atomic<std::size_t> next_move{0};
+
+    const auto WORKER = [&](std::size_t id) {
+        Position pos = root;
+        WorkerStats& own = stats[id];
+        for (std::size_t i = next_move++; i < ROOT_MOVES.size(); i = next_move++) {
+            const auto START = Clock::now();
+            pos.makeMove(ROOT_MOVES[i]);
+            divide[i] = Perft::count(pos, options.depth - 1, table);
+            pos.unmakeMove();
+            own.busy += Clock::now() - START;
+            own.nodes += divide[i];
+            ++own.root_moves;
+        }
+    };
+
+    const auto START = Clock::now();
+    std::vector<std::thread> pool;
+    pool.reserve(options.threads);
+    for (std::size_t id = 0; id < options.threads; ++id) { pool.emplace_back(WORKER, id); }
+    for (std::thread& thread : pool) { thread.join(); }
+    const auto ELAPSED = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - START);
+
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < ROOT_MOVES.size(); ++i) {
+        std::cout << ROOT_MOVES[i].toUci() << ": " << divide[i] << '\n';
+        total += divide[i];
+    }
+
+    const auto MILLISECONDS = std::chrono::duration_cast<std::chrono::milliseconds>(ELAPSED);
+    std::cout << "\nNodes: " << total << "\nTime: " << MILLISECONDS.count() << " ms"
+              << "\nNPS: " << perSecond(total, ELAPSED) << "\nThreads: " << options.threads
+              << "\nHash: " << options.hash_mb << " MB\n\n";
+
+    for (std::size_t id = 0; id < stats.size(); ++id) {
+        const WorkerStats& worker = stats[id];
+        std::cout << "thread " << id << ": " << worker.root_moves << " root moves, "
+                  << worker.nodes << " nodes, "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(worker.busy).count()
+                  << " ms busy\n";
+    }
+
+    return 0;
+}